@@ -0,0 +1,51 @@
+// Builds indexes over keys of mixed types, which the index build sorts in KeyString form, and
+// checks that the index returns them in order and with their original types.
+(function() {
+    'use strict';
+
+    const coll = db.index_build_keystring_sort;
+    coll.drop();
+
+    const values = [
+        MinKey,
+        null,
+        NumberInt(2),
+        NumberLong(3),
+        2.5,
+        NumberDecimal('1.5'),
+        -1,
+        'abc',
+        'ab',
+        {x: 1},
+        {x: 'y'},
+        BinData(0, 'AAAA'),
+        ObjectId('5959e2d1e4b0a9e0d8f4c2aa'),
+        false,
+        true,
+        ISODate('2017-07-01T00:00:00Z'),
+        MaxKey,
+    ];
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < values.length; i++) {
+        for (let j = 0; j < 5; j++) {
+            bulk.insert({a: values[i], b: j});
+        }
+    }
+    assert.writeOK(bulk.execute());
+
+    for (let keyPattern of [{a: 1, b: 1}, {a: -1, b: 1}]) {
+        assert.commandWorked(coll.createIndex(keyPattern));
+
+        // The covered projection reads the values back from the index keys.
+        const fromIndex = coll.find({}, {_id: 0, a: 1, b: 1}).hint(keyPattern).toArray();
+        const fromSort =
+            coll.find({}, {_id: 0, a: 1, b: 1}).sort(keyPattern).hint({$natural: 1}).toArray();
+        assert.eq(values.length * 5, fromIndex.length);
+        assert.eq(fromSort.length, fromIndex.length);
+        for (let i = 0; i < fromIndex.length; i++) {
+            assert.eq(tojson(fromSort[i]), tojson(fromIndex[i]), tojson(keyPattern));
+        }
+
+        assert.commandWorked(coll.dropIndex(keyPattern));
+    }
+})();
@@ -73,3 +73,11 @@ for (var i = 0; i < plans.length; i++) {
     }
     assert(plans[i].reason.stats.hasOwnProperty('stage'), 'no stats inserted for plan ' + i);
 }
+
+// The winning plan reports the usage stats of the cache entry. Every execution after the first was
+// answered from the cache.
+var feedback = plans[0].feedback;
+assert.gt(feedback.hits, 0, tojson(feedback));
+assert.gte(feedback.works, 0, tojson(feedback));
+assert.gte(feedback.replans, 0, tojson(feedback));
+assert.gt(feedback.estimatedSizeBytes, 0, tojson(feedback));
@@ -0,0 +1,64 @@
+// Compares $group throughput when documents are passed to the accumulators one at a time and in
+// batches, controlled by 'internalDocumentSourceGroupBatchSize'. Both modes must produce identical
+// results.
+
+(function() {
+    'use strict';
+
+    const kDocs = 200 * 1000;
+    const kIterations = 3;
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.group_batch_execution_benchmark;
+    coll.drop();
+
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < kDocs; i++) {
+        bulk.insert({_id: i, k: i % 16, a: i, b: i * 0.5, c: NumberLong(i)});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipelines = {
+        total: [{
+            $group: {
+                _id: null,
+                sumA: {$sum: '$a'},
+                avgB: {$avg: '$b'},
+                minC: {$min: '$c'},
+                maxC: {$max: '$c'}
+            }
+        }],
+        byKey: [
+            {$match: {a: {$gte: 100}}},
+            {$group: {_id: '$k', sumA: {$sum: '$a'}, avgB: {$avg: '$b'}, maxC: {$max: '$c'}}},
+            {$sort: {_id: 1}}
+        ],
+    };
+
+    function run(batchSize) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, internalDocumentSourceGroupBatchSize: batchSize}));
+
+        const results = {};
+        Object.keys(pipelines).forEach(function(name) {
+            let millis = 0;
+            for (let i = 0; i < kIterations; i++) {
+                const start = Date.now();
+                results[name] = coll.aggregate(pipelines[name]).toArray();
+                millis += Date.now() - start;
+            }
+            jsTestLog('$group batch size ' + batchSize + ', pipeline ' + name + ': ' +
+                      (millis / kIterations) + ' ms');
+        });
+        return results;
+    }
+
+    const rowAtATime = run(1);
+    const batched = run(1024);
+    assert.eq(rowAtATime, batched);
+
+    MongoRunner.stopMongod(conn);
+})();
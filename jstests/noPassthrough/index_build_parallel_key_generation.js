@@ -0,0 +1,50 @@
+// Builds indexes in the foreground with keys generated on several threads, and checks that the
+// resulting indexes match the collection, including multikey and unique indexes.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {indexBuildKeyGenerationThreads: 4}});
+    assert.neq(null, conn, 'mongod failed to start');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.index_build_parallel_key_generation;
+    coll.drop();
+
+    const numDocs = 20000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i, a: (i * 7919) % numDocs, b: i % 7, c: [i, -i]});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(coll.createIndex({b: 1, a: -1}));
+    assert.commandWorked(coll.createIndex({c: 1}));
+    assert.commandWorked(coll.createIndex({a: 1}, {unique: true}));
+    assert.commandWorked(coll.validate(true));
+
+    // The compound index returns documents in key order.
+    let previous = null;
+    let count = 0;
+    coll.find({b: {$gte: 0}}, {_id: 0, a: 1, b: 1}).hint({b: 1, a: -1}).forEach(function(doc) {
+        if (previous !== null) {
+            assert(previous.b < doc.b || (previous.b === doc.b && previous.a > doc.a),
+                   tojson(previous) + ' before ' + tojson(doc));
+        }
+        previous = doc;
+        count++;
+    });
+    assert.eq(numDocs, count);
+
+    // Keys from every thread's sorted run make the array index multikey.
+    const explain = coll.find({c: 5}).hint({c: 1}).explain();
+    assert.eq(1, coll.find({c: 5}).hint({c: 1}).itcount());
+    assert.eq(1, coll.find({c: -5}).hint({c: 1}).itcount());
+    assert(tojson(explain).indexOf('"isMultiKey" : true') >= 0, tojson(explain));
+
+    // A duplicate key found while merging the runs fails a unique build.
+    assert.writeOK(coll.insert({_id: numDocs, b: 1}));
+    assert.writeOK(coll.insert({_id: numDocs + 1, b: 1}));
+    assert.commandFailedWithCode(coll.createIndex({b: 1}, {unique: true}), ErrorCodes.DuplicateKey);
+
+    MongoRunner.stopMongod(conn);
+})();
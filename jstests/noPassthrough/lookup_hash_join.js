@@ -0,0 +1,109 @@
+// Tests that $lookup returns the same results whether it hash joins the foreign collection or
+// queries it once per input document. The hash join is disabled by setting
+// 'internalLookupStageHashJoinMaxMemoryBytes' to 0.
+
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const local = testDB.lookup_hash_join_local;
+    const foreign = testDB.lookup_hash_join_foreign;
+    local.drop();
+    foreign.drop();
+
+    assert.writeOK(local.insert([
+        {_id: 0, a: 1},
+        {_id: 1, a: [1, 2]},
+        {_id: 2, a: null},
+        {_id: 3},
+        {_id: 4, a: 'abc'},
+        {_id: 5, a: {x: 1}},
+        {_id: 6, a: []},
+        {_id: 7, a: /^ab/},
+        {_id: 8, a: NumberLong(3)},
+    ]));
+    assert.writeOK(foreign.insert([
+        {_id: 0, b: 1},
+        {_id: 1, b: 2.0},
+        {_id: 2, b: [1, 3]},
+        {_id: 3, b: null},
+        {_id: 4},
+        {_id: 5, b: 'ABC'},
+        {_id: 6, b: 'abc'},
+        {_id: 7, b: {x: 1}},
+        {_id: 8, b: [{x: 1}, {c: 2}]},
+        {_id: 9, b: /^ab/},
+        {_id: 10, b: []},
+    ]));
+
+    function runLookups() {
+        const results = {};
+        results.plain =
+            local
+                .aggregate([
+                    {$lookup: {from: foreign.getName(), localField: 'a', foreignField: 'b', as: 'j'}},
+                    {$sort: {_id: 1}}
+                ])
+                .toArray();
+        results.dotted = local
+                             .aggregate([
+                                 {
+                                   $lookup: {
+                                       from: foreign.getName(),
+                                       localField: 'a.x',
+                                       foreignField: 'b.x',
+                                       as: 'j'
+                                   }
+                                 },
+                                 {$sort: {_id: 1}}
+                             ])
+                             .toArray();
+        results.unwound =
+            local
+                .aggregate([
+                    {$lookup: {from: foreign.getName(), localField: 'a', foreignField: 'b', as: 'j'}},
+                    {$unwind: {path: '$j', includeArrayIndex: 'i'}},
+                    {$match: {'j._id': {$gte: 1}}},
+                    {$sort: {_id: 1, i: 1}}
+                ])
+                .toArray();
+        results.collated =
+            local
+                .aggregate(
+                    [
+                      {
+                        $lookup:
+                            {from: foreign.getName(), localField: 'a', foreignField: 'b', as: 'j'}
+                      },
+                      {$sort: {_id: 1}}
+                    ],
+                    {collation: {locale: 'en_US', strength: 2}})
+                .toArray();
+        return results;
+    }
+
+    const hashJoined = runLookups();
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalLookupStageHashJoinMaxMemoryBytes: 0}));
+    const nestedLoop = runLookups();
+
+    Object.keys(nestedLoop).forEach(function(name) {
+        assert.eq(nestedLoop[name].length, hashJoined[name].length, name);
+        for (let i = 0; i < nestedLoop[name].length; i++) {
+            // The order of the joined documents is unspecified, so compare them as sets.
+            const expected = nestedLoop[name][i];
+            const actual = hashJoined[name][i];
+            if (Array.isArray(expected.j)) {
+                const byId = (l, r) => l._id - r._id;
+                expected.j.sort(byId);
+                actual.j.sort(byId);
+            }
+            assert.eq(expected, actual, name);
+        }
+    });
+
+    MongoRunner.stopMongod(conn);
+})();
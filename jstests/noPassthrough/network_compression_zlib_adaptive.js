@@ -0,0 +1,46 @@
+// Replicates a batch of compressible documents between members which negotiate the zlib network
+// compressor in adaptive mode, and checks that replication traffic was compressed.
+(function() {
+    'use strict';
+
+    const rst = new ReplSetTest({
+        nodes: 2,
+        nodeOptions: {
+            networkMessageCompressors: 'zlib',
+            setParameter: {networkMessageCompressorAdaptive: true},
+        },
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB('test').network_compression_zlib_adaptive;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    const padding = 'x'.repeat(1024);
+    for (let i = 0; i < 2000; i++) {
+        bulk.insert({_id: i, padding: padding});
+    }
+    assert.writeOK(bulk.execute());
+    rst.awaitReplication();
+
+    const secondary = rst.getSecondary();
+    assert.eq(2000, secondary.getDB('test').network_compression_zlib_adaptive.find().itcount());
+
+    // The secondary fetched the oplog from the primary, so the primary compressed its replies and
+    // the secondary decompressed them.
+    const primaryStats = assert.commandWorked(primary.adminCommand({serverStatus: 1}));
+    const secondaryStats = assert.commandWorked(secondary.adminCommand({serverStatus: 1}));
+    const primaryZlib = primaryStats.network.compression.zlib;
+    const secondaryZlib = secondaryStats.network.compression.zlib;
+    jsTestLog('primary zlib stats: ' + tojson(primaryZlib) + ', secondary zlib stats: ' +
+              tojson(secondaryZlib));
+
+    assert.gt(primaryZlib.compressed.bytesIn, 2000 * 1024, tojson(primaryZlib));
+    assert.lt(primaryZlib.compressed.bytesOut,
+              primaryZlib.compressed.bytesIn / 10,
+              tojson(primaryZlib));
+    assert.gt(secondaryZlib.decompressed.bytesOut, 2000 * 1024, tojson(secondaryZlib));
+
+    rst.stopSet();
+})();
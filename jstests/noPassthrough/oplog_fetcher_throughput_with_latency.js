@@ -0,0 +1,52 @@
+// Measures how fast a secondary catches up through the oplog fetcher when every request it sends
+// to its sync source is delayed, standing in for a high-latency link between data centers. The
+// oplog fetcher sizes each getMore by the space left in the oplog buffer, so a backlog larger than
+// one batch must still replicate completely.
+(function() {
+    'use strict';
+
+    const kDelayMillis = 50;
+    const kNumDocs = 20000;
+
+    const rst = new ReplSetTest({nodes: [{}, {rsConfig: {priority: 0}}], useBridge: true});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    const coll = primary.getDB('test').oplog_fetcher_throughput_with_latency;
+
+    // Build a backlog on the primary while the secondary is not fetching.
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: 'stopReplProducer', mode: 'alwaysOn'}));
+    const padding = 'x'.repeat(512);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < kNumDocs; i++) {
+        bulk.insert({_id: i, padding: padding});
+    }
+    assert.writeOK(bulk.execute());
+
+    primary.delayMessagesFrom(secondary, kDelayMillis);
+
+    const getMoresBefore = assert.commandWorked(secondary.adminCommand({serverStatus: 1}))
+                               .metrics.repl.network.getmores.num;
+    const start = Date.now();
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: 'stopReplProducer', mode: 'off'}));
+    rst.awaitReplication();
+    const elapsedMillis = Math.max(1, Date.now() - start);
+
+    const networkStats =
+        assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics.repl.network;
+    jsTestLog('Replicated ' + kNumDocs + ' documents with ' + kDelayMillis +
+              'ms of added latency in ' + elapsedMillis + 'ms (' +
+              Math.round(kNumDocs * 1000 / elapsedMillis) + ' docs/s, ' +
+              (networkStats.getmores.num - getMoresBefore) + ' batches): ' + tojson(networkStats));
+
+    secondary.setSlaveOk();
+    assert.eq(kNumDocs, secondary.getDB('test').oplog_fetcher_throughput_with_latency.count());
+    assert(networkStats.hasOwnProperty('flowControlledGetmores'), tojson(networkStats));
+
+    primary.delayMessagesFrom(secondary, 0);
+    rst.stopSet();
+})();
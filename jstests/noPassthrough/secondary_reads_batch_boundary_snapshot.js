@@ -0,0 +1,49 @@
+// Tests that with secondaryReadsFromBatchBoundarySnapshot enabled, reads on a secondary are served
+// from the snapshot taken at the end of the previous oplog batch instead of waiting for the batch
+// being applied.
+load("jstests/libs/check_log.js");
+
+(function() {
+    "use strict";
+
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        jsTestLog("Skipping test because storageEngine is not wiredTiger");
+        return;
+    }
+
+    const rst = new ReplSetTest({
+        nodes: [{}, {rsConfig: {priority: 0}}],
+        nodeOptions: {setParameter: {secondaryReadsFromBatchBoundarySnapshot: true}},
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    const dbName = "test";
+    const collName = "secondary_reads_batch_boundary_snapshot";
+    const primaryColl = primary.getDB(dbName)[collName];
+    const secondaryColl = secondary.getDB(dbName)[collName];
+    secondary.setSlaveOk();
+
+    assert.writeOK(primaryColl.insert({_id: 0}, {writeConcern: {w: 2}}));
+    assert.eq(1, secondaryColl.find().itcount());
+
+    // Hang oplog application on the secondary in the middle of the next batch.
+    assert.commandWorked(secondary.adminCommand(
+        {configureFailPoint: "hangBeforeCompletingOplogBatch", mode: "alwaysOn"}));
+    assert.writeOK(primaryColl.insert({_id: 1}));
+    checkLog.contains(secondary, "hangBeforeCompletingOplogBatch fail point enabled");
+
+    // The read does not wait for the batch, and sees the data as of the previous batch.
+    const res = assert.commandWorked(
+        secondary.getDB(dbName).runCommand({find: collName, maxTimeMS: 10 * 1000}));
+    assert.eq([{_id: 0}], res.cursor.firstBatch);
+
+    assert.commandWorked(secondary.adminCommand(
+        {configureFailPoint: "hangBeforeCompletingOplogBatch", mode: "off"}));
+    rst.awaitReplication();
+    assert.eq(2, secondaryColl.find().itcount());
+
+    rst.stopSet();
+})();
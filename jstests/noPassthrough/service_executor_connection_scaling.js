@@ -0,0 +1,65 @@
+// Connection-scaling benchmark for the service executors. Opens a large number of idle
+// connections against a mongod running each executor, then measures the throughput of a small
+// set of active clients. With the fixedThreadPool executor the idle connections must not cost a
+// thread each, and requests from every connection must still be serviced.
+
+(function() {
+    'use strict';
+
+    const kIdleConnections = 500;
+    const kSeconds = 5;
+
+    function runBenchmark(setParameter) {
+        const conn = MongoRunner.runMongod({setParameter: setParameter});
+        assert.neq(null, conn, 'mongod failed to start with ' + tojson(setParameter));
+
+        const testDB = conn.getDB('test');
+        const coll = testDB.service_executor_connection_scaling;
+        coll.drop();
+        assert.writeOK(coll.insert({_id: 0, x: 0}));
+
+        const idle = [];
+        for (let i = 0; i < kIdleConnections; i++) {
+            const idleConn = new Mongo(conn.host);
+            assert.commandWorked(idleConn.adminCommand({isMaster: 1}));
+            idle.push(idleConn);
+        }
+
+        const connections = assert.commandWorked(testDB.serverStatus()).connections;
+        assert.gte(connections.current, kIdleConnections, tojson(connections));
+
+        const res = benchRun({
+            ops: [
+                {op: 'findOne', ns: coll.getFullName(), query: {_id: 0}},
+                {op: 'update', ns: coll.getFullName(), query: {_id: 0}, update: {$inc: {x: 1}}},
+            ],
+            parallel: 8,
+            seconds: kSeconds,
+            host: conn.host,
+        });
+        assert.eq(0, res.errCount, tojson(res));
+
+        // Every idle connection must still be serviceable after the load.
+        idle.forEach(function(idleConn) {
+            assert.commandWorked(idleConn.adminCommand({ping: 1}));
+        });
+
+        jsTestLog('service executor ' + tojson(setParameter) + ' with ' + kIdleConnections +
+                  ' idle connections: ' + res.findOne + ' findOne/s, ' + res.update +
+                  ' update/s');
+
+        MongoRunner.stopMongod(conn);
+        return res;
+    }
+
+    runBenchmark({serviceExecutor: 'synchronous'});
+    runBenchmark({serviceExecutor: 'fixedThreadPool', serviceExecutorThreadCount: 4});
+    runBenchmark({
+        serviceExecutor: 'fixedThreadPool',
+        serviceExecutorThreadCount: 4,
+        messagePortImpl: 'ASIO'
+    });
+
+    // Invalid executors are rejected at startup.
+    assert.eq(null, MongoRunner.runMongod({setParameter: {serviceExecutor: 'bogus'}}));
+})();
@@ -0,0 +1,46 @@
+// Checks that the excess documents of a size-capped collection are deleted by the background
+// capped deleter, and that the collection stays close to its cap while it is being written to.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod failed to start');
+    const testDB = conn.getDB('test');
+
+    if (testDB.serverStatus().storageEngine.name !== 'wiredTiger') {
+        jsTestLog('Skipping test because the storage engine is not wiredTiger');
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    const kCappedSize = 1024 * 1024;
+    assert.commandWorked(testDB.createCollection('capped', {capped: true, size: kCappedSize}));
+    const coll = testDB.capped;
+
+    const padding = 'x'.repeat(1000);
+    for (let batch = 0; batch < 50; batch++) {
+        const bulk = coll.initializeOrderedBulkOp();
+        for (let i = 0; i < 100; i++) {
+            bulk.insert({batch: batch, i: i, padding: padding});
+        }
+        assert.writeOK(bulk.execute());
+
+        // Inserts only delete documents themselves once the collection is a tenth over its cap.
+        const stats = assert.commandWorked(coll.stats());
+        assert.lte(stats.size, kCappedSize * 1.1 + 100 * 1100, tojson(stats));
+    }
+
+    assert.soon(function() {
+        return coll.stats().size <= kCappedSize;
+    }, 'capped collection was not trimmed to its cap: ' + tojson(coll.stats()));
+
+    const stats = assert.commandWorked(coll.stats());
+    assert.gt(stats.backgroundDeletedRecords, 0, tojson(stats));
+
+    // The newest documents are the ones left, in insertion order.
+    const docs = coll.find().toArray();
+    assert.eq(49, docs[docs.length - 1].batch);
+    assert.eq(99, docs[docs.length - 1].i);
+
+    MongoRunner.stopMongod(conn);
+})();
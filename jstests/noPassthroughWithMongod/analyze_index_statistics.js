@@ -0,0 +1,105 @@
+// Tests that the index statistics gathered by the analyze command let the planner discard
+// candidate plans that are clearly more expensive, and that the statistics are dropped along with
+// their index.
+(function() {
+    'use strict';
+
+    const coll = db.analyze_index_statistics;
+    coll.drop();
+
+    // 'a' is heavily skewed towards 0, while 'b' is unique.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({a: i < 9900 ? 0 : i - 9899, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    function rankingSkipped() {
+        return db.serverStatus().metrics.query.planner.rankingSkippedByEstimate;
+    }
+
+    function winningIndex(explain) {
+        let stage = explain.queryPlanner.winningPlan;
+        while (stage.stage !== 'IXSCAN') {
+            assert(stage.hasOwnProperty('inputStage'), tojson(explain));
+            stage = stage.inputStage;
+        }
+        return stage.indexName;
+    }
+
+    const query = {a: 5, b: {$gte: 0}};
+
+    // Without statistics both indexed plans are ranked.
+    let explain = coll.find(query).explain();
+    assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+
+    const res = assert.commandWorked(db.runCommand({analyze: coll.getName(), histogram: true}));
+    assert.eq(10000, res.indexes.a_1.numKeys, tojson(res));
+    assert.eq(101, res.indexes.a_1.numDistinct, tojson(res));
+    assert.eq(10000, res.indexes.b_1.numDistinct, tojson(res));
+    assert.eq(10000, res.indexes._id_.numKeys, tojson(res));
+    assert.eq(0, res.indexes.a_1.histogram[0].upperBound, tojson(res));
+    assert.eq(9900, res.indexes.a_1.histogram[0].numUpperBoundKeys, tojson(res));
+
+    // The scan of 'a' examines a single key while the scan of 'b' examines all of them, so the
+    // plan over 'a' is chosen without ranking.
+    const skippedBefore = rankingSkipped();
+    explain = coll.find(query).explain();
+    assert.eq(0, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+    assert.eq('a_1', winningIndex(explain), tojson(explain));
+    assert.eq(1, coll.find(query).itcount());
+    assert.gt(rankingSkipped(), skippedBefore);
+
+    // The frequent value of 'a' is costlier than a narrow range of 'b'.
+    explain = coll.find({a: 0, b: {$lt: 10}}).explain();
+    assert.eq(0, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+    assert.eq('b_1', winningIndex(explain), tojson(explain));
+
+    // Queries with a limit may stop early, so they are still ranked.
+    explain = coll.find(query).limit(1).explain();
+    assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+
+    // Sorted queries are ranked too, as the estimates don't charge for a blocking sort. The scan of
+    // 'b' that provides the order stays a candidate, and so the backup plan, although the scan of
+    // 'a' examines far fewer keys.
+    explain = coll.find(query).sort({b: 1}).explain();
+    assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+    assert.eq(1, coll.find(query).sort({b: 1}).itcount());
+
+    // Statistics go away with their index.
+    assert.commandWorked(coll.dropIndex({b: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+    explain = coll.find(query).explain();
+    assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+
+    // And can be cleared explicitly.
+    assert.commandWorked(db.runCommand({analyze: coll.getName(), index: 'b_1'}));
+    explain = coll.find(query).explain();
+    assert.eq(0, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+
+    // Statistics gathered before the collection grew substantially are ignored until it is
+    // analyzed again.
+    const growBulk = coll.initializeUnorderedBulkOp();
+    for (let i = 10000; i < 12000; i++) {
+        growBulk.insert({a: 0, b: i});
+    }
+    assert.writeOK(growBulk.execute());
+    explain = coll.find(query).explain();
+    assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+    assert.commandWorked(db.runCommand({analyze: coll.getName()}));
+    explain = coll.find(query).explain();
+    assert.eq(0, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+
+    assert.commandWorked(db.runCommand({analyze: coll.getName(), clear: true}));
+    explain = coll.find(query).explain();
+    assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), index: 'c_1'}),
+                                 ErrorCodes.IndexNotFound);
+    assert.commandFailedWithCode(db.runCommand({analyze: 'analyze_index_statistics_missing'}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    coll.drop();
+})();
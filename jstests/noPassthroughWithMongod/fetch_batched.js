@@ -0,0 +1,65 @@
+// Tests that a FETCH below a blocking sort fetches its documents in batches and returns the same
+// results as fetching them one at a time, and that a FETCH whose output order matters, including
+// one whose child provides the sort, is never batched.
+(function() {
+    'use strict';
+
+    const coll = db.fetch_batched;
+    coll.drop();
+
+    // Insert in descending order of 'a' so that index order and RecordId order differ.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: 1000 - i, b: i % 7});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    function setBatchSize(batchSize) {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryExecFetchBatchSize: batchSize}));
+    }
+
+    function fetchStage(explain) {
+        let stage = explain.executionStats.executionStages;
+        while (stage.stage !== 'FETCH') {
+            assert(stage.hasOwnProperty('inputStage'), tojson(explain));
+            stage = stage.inputStage;
+        }
+        return stage;
+    }
+
+    const query = {a: {$gte: 100}, b: {$ne: 3}};
+    const blockingSort = {b: 1, _id: 1};
+
+    const defaultBatchSize =
+        assert.commandWorked(db.adminCommand({getParameter: 1, internalQueryExecFetchBatchSize: 1}))
+            .internalQueryExecFetchBatchSize;
+
+    try {
+        setBatchSize(1);
+        const expected = coll.find(query).toArray();
+        const expectedBlockingSort = coll.find(query).sort(blockingSort).toArray();
+        const expectedIndexSort = coll.find(query).sort({a: 1}).toArray();
+        assert(!fetchStage(coll.find(query).sort(blockingSort).explain('executionStats'))
+                    .hasOwnProperty('batches'));
+
+        setBatchSize(64);
+
+        // Below a blocking sort every batch is fetched in RecordId order.
+        assert.eq(expectedBlockingSort, coll.find(query).sort(blockingSort).toArray());
+        const explain = coll.find(query).sort(blockingSort).explain('executionStats');
+        assert.eq(Math.ceil(901 / 64), fetchStage(explain).batches, tojson(explain));
+
+        // Without a sort the results are returned in index order, one fetch at a time.
+        assert.eq(expected, coll.find(query).toArray());
+        assert(!fetchStage(coll.find(query).explain('executionStats')).hasOwnProperty('batches'));
+
+        // A sort provided by the index is preserved.
+        assert.eq(expectedIndexSort, coll.find(query).sort({a: 1}).toArray());
+        assert(!fetchStage(coll.find(query).sort({a: 1}).explain('executionStats'))
+                    .hasOwnProperty('batches'));
+    } finally {
+        setBatchSize(defaultBatchSize);
+    }
+})();
@@ -0,0 +1,72 @@
+// Tests that a $group or $count without a preceding $match is answered from an index alone when it
+// only needs the group key, and that a $group on a single indexed field streams.
+(function() {
+    'use strict';
+
+    load('jstests/libs/analyze_plan.js');
+
+    const coll = db.group_covered_index;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({a: i % 50, b: i % 7, c: 'x'.repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    const groupPipeline = [{$group: {_id: '$a', count: {$sum: 1}}}];
+    const expected = coll.aggregate(groupPipeline)
+                         .toArray()
+                         .sort((x, y) => x._id - y._id);
+    assert.eq(50, expected.length);
+    let results;
+
+    // Without an index every document is read.
+    let explain = coll.explain().aggregate(groupPipeline);
+    assert(getAggPlanStage(explain, 'COLLSCAN'), tojson(explain));
+
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    // The index on the group key is scanned without fetching any document.
+    explain = coll.explain().aggregate(groupPipeline);
+    const ixscan = getAggPlanStage(explain, 'IXSCAN');
+    assert(ixscan, tojson(explain));
+    assert.eq({a: 1, b: 1}, ixscan.keyPattern, tojson(explain));
+    assert(!getAggPlanStage(explain, 'FETCH'), tojson(explain));
+
+    // The index provides the input in order of the group key, so groups are output in that order.
+    assert.eq(expected, coll.aggregate(groupPipeline).toArray());
+
+    // A covered projection would report a missing 'b' as null, so accumulating 'b' reads the
+    // documents.
+    assert.writeOK(coll.insert({a: 1000}));
+    const pushPipeline = [{$group: {_id: '$a', bs: {$push: '$b'}}}];
+    explain = coll.explain().aggregate(pushPipeline);
+    assert(getAggPlanStage(explain, 'COLLSCAN'), tojson(explain));
+    results = coll.aggregate(pushPipeline).toArray().filter((group) => group._id === 1000);
+    assert.eq([{_id: 1000, bs: []}], results);
+    assert.writeOK(coll.remove({a: 1000}));
+
+    // $count only needs to count the keys of the smallest index.
+    assert.commandWorked(coll.createIndex({b: 1}));
+    explain = coll.explain().aggregate([{$count: 'n'}]);
+    const countScan = getAggPlanStage(explain, 'COUNT_SCAN');
+    assert(countScan, tojson(explain));
+    assert.eq({b: 1}, countScan.keyPattern, tojson(explain));
+    assert.eq([{n: 1000}], coll.aggregate([{$count: 'n'}]).toArray());
+
+    // Documents missing the group key are still grouped under null.
+    assert.writeOK(coll.insert({b: 1}));
+    assert.writeOK(coll.insert({a: null, b: 2}));
+    results = coll.aggregate(groupPipeline).toArray();
+    assert.eq(51, results.length);
+    assert.eq({_id: null, count: 2}, results[0]);
+
+    // A multikey index can't cover the group key.
+    assert.writeOK(coll.insert({a: [1, 2], b: 3}));
+    explain = coll.explain().aggregate(groupPipeline);
+    assert(getAggPlanStage(explain, 'COLLSCAN'), tojson(explain));
+    assert.eq(52, coll.aggregate(groupPipeline).itcount());
+
+    coll.drop();
+})();
@@ -0,0 +1,72 @@
+// Tests that a compound index whose leading field has few distinct values is skip-scanned for
+// queries over its other fields once the analyze command has gathered statistics for it.
+(function() {
+    'use strict';
+
+    const coll = db.skip_scan;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({a: i % 5, b: i, c: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    function winningStage(explain) {
+        let stage = explain.executionStats.executionStages;
+        while (stage.hasOwnProperty('inputStage')) {
+            stage = stage.inputStage;
+        }
+        return stage;
+    }
+
+    const query = {b: {$gte: 1234, $lt: 1236}};
+    const expected = coll.find(query).hint({$natural: 1}).sort({b: 1}).toArray();
+    assert.eq(2, expected.length);
+
+    // Without statistics the index can't be used.
+    let explain = coll.find(query).explain('executionStats');
+    assert.eq('COLLSCAN', winningStage(explain).stage, tojson(explain));
+
+    assert.commandWorked(db.runCommand({analyze: coll.getName()}));
+
+    // The skip scan seeks once per distinct value of 'a' instead of scanning every key.
+    explain = coll.find(query).explain('executionStats');
+    const ixscan = winningStage(explain);
+    assert.eq('IXSCAN', ixscan.stage, tojson(explain));
+    assert.eq({a: ['[MinKey, MaxKey]'], b: ['[1234.0, 1236.0)']}, ixscan.indexBounds);
+    assert.lt(ixscan.keysExamined, 20, tojson(explain));
+    assert.eq(expected, coll.find(query).sort({b: 1}).toArray());
+
+    // The whole query is evaluated against the fetched documents.
+    assert.eq([expected[0]], coll.find({b: query.b, c: 0}).toArray());
+
+    // The ranking of the skip scan against the collection scan is cached, so later executions of
+    // the query don't repeat it.
+    coll.getPlanCache().clear();
+    assert.eq(2, coll.find(query).itcount());
+    const cachedPlans = coll.getPlanCache().getPlansByQuery(query);
+    assert.eq(2, cachedPlans.length, tojson(cachedPlans));
+
+    // Skip scans are not considered for indices with too many distinct prefixes, even if one was
+    // cached.
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryPlannerMaxSkipScanPrefixes: 4}));
+    try {
+        explain = coll.find(query).explain('executionStats');
+        assert.eq('COLLSCAN', winningStage(explain).stage, tojson(explain));
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryPlannerMaxSkipScanPrefixes: 100}));
+    }
+
+    // Multikey indices can't be skip-scanned.
+    assert.writeOK(coll.insert({a: [1, 2], b: 1235}));
+    assert.commandWorked(db.runCommand({analyze: coll.getName()}));
+    explain = coll.find(query).explain('executionStats');
+    assert.eq('COLLSCAN', winningStage(explain).stage, tojson(explain));
+    assert.eq(3, coll.find(query).itcount());
+
+    coll.drop();
+})();
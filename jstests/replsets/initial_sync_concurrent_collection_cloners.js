@@ -0,0 +1,46 @@
+/**
+ * Tests that initial sync clones every collection of a database, along with its indexes, when
+ * several collection cloners are allowed to run at once.
+ */
+
+(function() {
+    "use strict";
+
+    const name = "initial_sync_concurrent_collection_cloners";
+    const numCollections = 10;
+    const numDocs = 500;
+
+    const replSet = new ReplSetTest({name: name, nodes: 1});
+    replSet.startSet();
+    replSet.initiate();
+
+    const primaryDB = replSet.getPrimary().getDB(name);
+    for (let i = 0; i < numCollections; ++i) {
+        const coll = primaryDB.getCollection("coll" + i);
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let j = 0; j < numDocs; ++j) {
+            bulk.insert({_id: j, x: j * i});
+        }
+        assert.writeOK(bulk.execute());
+        assert.commandWorked(coll.createIndex({x: 1}));
+    }
+
+    const secondary =
+        replSet.add({setParameter: {maxNumInitialSyncCollectionClonersPerDatabase: 4}});
+    replSet.reInitiate();
+    replSet.awaitSecondaryNodes();
+    replSet.awaitReplication();
+
+    const secondaryDB = secondary.getDB(name);
+    for (let i = 0; i < numCollections; ++i) {
+        const coll = secondaryDB.getCollection("coll" + i);
+        assert.eq(numDocs, coll.find().itcount(), coll.getFullName());
+        assert.eq(2, coll.getIndexes().length, tojson(coll.getIndexes()));
+    }
+
+    // The parameter can also be changed at runtime.
+    assert.commandWorked(secondary.adminCommand(
+        {setParameter: 1, maxNumInitialSyncCollectionClonersPerDatabase: 1}));
+
+    replSet.stopSet();
+})();
@@ -0,0 +1,82 @@
+/**
+ * Tests that a $sort feeding a $group whose accumulators ignore input order does not stop the
+ * $group from being split, so that the shards send partial aggregates to the merger rather than
+ * every sorted document.
+ */
+(function() {
+    "use strict";
+
+    const st = new ShardingTest({shards: 2, other: {enableBalancer: false}});
+
+    const mongos = st.s;
+    const db = mongos.getDB(jsTestName());
+    const coll = db.coll;
+
+    assert.commandWorked(db.adminCommand({enableSharding: db.getName()}));
+    st.ensurePrimaryShard(db.getName(), "shard0000");
+    assert.commandWorked(db.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(db.adminCommand({split: coll.getFullName(), middle: {_id: 500}}));
+    assert.commandWorked(
+        db.adminCommand({moveChunk: coll.getFullName(), find: {_id: 750}, to: "shard0001"}));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, g: i % 10, x: i, tag: "t" + (i % 3)});
+    }
+    assert.writeOK(bulk.execute());
+
+    const group = {
+        $group: {
+            _id: "$g",
+            count: {$sum: 1},
+            total: {$sum: "$x"},
+            avg: {$avg: "$x"},
+            stdDev: {$stdDevPop: "$x"},
+            min: {$min: "$x"},
+            max: {$max: "$x"},
+            tags: {$addToSet: "$tag"}
+        }
+    };
+
+    function sortedResults(pipeline) {
+        return coll.aggregate(pipeline)
+            .toArray()
+            .map(function(doc) {
+                // The order in which shards' partial states are combined may change the last bits
+                // of the standard deviation.
+                doc.stdDev = Math.round(doc.stdDev * 1e6);
+                doc.tags.sort();
+                return doc;
+            })
+            .sort(function(a, b) {
+                return a._id - b._id;
+            });
+    }
+
+    // The $sort is dropped and the $group is split between the shards and the merger.
+    let explain = coll.explain().aggregate([{$sort: {x: 1}}, group]);
+    assert(explain.hasOwnProperty("splitPipeline"), tojson(explain));
+    let shardsPart = explain.splitPipeline.shardsPart;
+    assert.eq(1, shardsPart.length, tojson(explain));
+    assert(shardsPart[0].hasOwnProperty("$group"), tojson(explain));
+    assert(explain.splitPipeline.mergerPart[0].$group.$doingMerge, tojson(explain));
+
+    const expected = sortedResults([group]);
+    assert.eq(10, expected.length, tojson(expected));
+    assert.eq(expected, sortedResults([{$sort: {x: 1}}, group]));
+
+    // Order-sensitive accumulators still see sorted input, so the split stays on the $sort.
+    explain = coll.explain().aggregate([{$sort: {x: 1}}, {$group: {_id: null, xs: {$push: "$x"}}}]);
+    shardsPart = explain.splitPipeline.shardsPart;
+    assert(shardsPart[0].hasOwnProperty("$sort"), tojson(explain));
+
+    const pushed = coll.aggregate([{$sort: {x: -1}}, {$group: {_id: null, xs: {$push: "$x"}}}])
+                       .toArray();
+    assert.eq(1, pushed.length, tojson(pushed));
+    assert.eq(1000, pushed[0].xs.length);
+    for (let i = 1; i < pushed[0].xs.length; ++i) {
+        assert.gt(pushed[0].xs[i - 1], pushed[0].xs[i]);
+    }
+
+    st.stop();
+})();
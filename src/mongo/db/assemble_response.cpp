@@ -43,6 +43,7 @@
 #include "mongo/db/introspect.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/ops/write_ops_parsers.h"
 #include "mongo/db/query/find.h"
@@ -638,6 +639,7 @@ DbResponse assembleResponse(OperationContext* opCtx, const Message& m, const Hos
     currentOp.ensureStarted();
     currentOp.done();
     debug.executionTimeMicros = currentOp.totalTimeMicros();
+    debug.arenaBytes = OperationArena::get(opCtx).bytesAllocated();
 
     logThresholdMs += currentOp.getExpectedLatencyMs();
     Top::get(opCtx->getServiceContext())
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -53,6 +54,8 @@ public:
 
         virtual QuerySettings* getQuerySettings() const = 0;
 
+        virtual CollectionStatistics* getCollectionStatistics() const = 0;
+
         virtual const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const = 0;
 
         virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
@@ -103,6 +106,13 @@ public:
         return this->_impl().getQuerySettings();
     }
 
+    /**
+     * Get the index statistics gathered by the analyze command for this collection.
+     */
+    inline CollectionStatistics* getCollectionStatistics() const {
+        return this->_impl().getCollectionStatistics();
+    }
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -64,6 +64,7 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _keysComputed(false),
       _planCache(stdx::make_unique<PlanCache>(ns.ns())),
       _querySettings(stdx::make_unique<QuerySettings>()),
+      _collectionStatistics(stdx::make_unique<CollectionStatistics>()),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
@@ -177,6 +178,10 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
+CollectionStatistics* CollectionInfoCacheImpl::getCollectionStatistics() const {
+    return _collectionStatistics.get();
+}
+
 void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
     std::vector<IndexEntry> indexEntries;
 
@@ -234,6 +239,7 @@ void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData i
 
     rebuildIndexData(opCtx);
     _indexUsageTracker.unregisterIndex(indexName);
+    _collectionStatistics->remove(indexName);
 }
 
 void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
@@ -31,6 +31,7 @@
 #include "mongo/db/catalog/collection_info_cache.h"
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -61,6 +62,11 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get the index statistics gathered by the analyze command for this collection.
+     */
+    CollectionStatistics* getCollectionStatistics() const;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -131,6 +137,9 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Index statistics used to estimate the cost of candidate plans.
+    std::unique_ptr<CollectionStatistics> _collectionStatistics;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
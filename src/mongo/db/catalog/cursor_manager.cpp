@@ -92,7 +92,7 @@ public:
 
     void appendStats(BSONObjBuilder& builder);
 
-    std::size_t timeoutCursors(OperationContext* opCtx, int millisSinceLastCall);
+    std::size_t timeoutCursors(OperationContext* opCtx, Milliseconds now);
 
     int64_t nextSeed();
 
@@ -225,11 +225,11 @@ bool GlobalCursorIdCache::eraseCursor(OperationContext* opCtx, CursorId id, bool
     return eraseStatus.isOK();
 }
 
-std::size_t GlobalCursorIdCache::timeoutCursors(OperationContext* opCtx, int millisSinceLastCall) {
+std::size_t GlobalCursorIdCache::timeoutCursors(OperationContext* opCtx, Milliseconds now) {
     size_t totalTimedOut = 0;
 
     // Time out the cursors from the global cursor manager.
-    totalTimedOut += globalCursorManager->timeoutCursors(opCtx, millisSinceLastCall);
+    totalTimedOut += globalCursorManager->timeoutCursors(opCtx, now);
 
     // Compute the set of collection names that we have to time out cursors for.
     vector<NamespaceString> todo;
@@ -253,7 +253,7 @@ std::size_t GlobalCursorIdCache::timeoutCursors(OperationContext* opCtx, int mil
             continue;
         }
 
-        totalTimedOut += collection->getCursorManager()->timeoutCursors(opCtx, millisSinceLastCall);
+        totalTimedOut += collection->getCursorManager()->timeoutCursors(opCtx, now);
     }
 
     return totalTimedOut;
@@ -265,8 +265,8 @@ CursorManager* CursorManager::getGlobalCursorManager() {
     return globalCursorManager.get();
 }
 
-std::size_t CursorManager::timeoutCursorsGlobal(OperationContext* opCtx, int millisSinceLastCall) {
-    return globalCursorIdCache->timeoutCursors(opCtx, millisSinceLastCall);
+std::size_t CursorManager::timeoutCursorsGlobal(OperationContext* opCtx, Milliseconds now) {
+    return globalCursorIdCache->timeoutCursors(opCtx, now);
 }
 
 int CursorManager::eraseCursorGlobalIfAuthorized(OperationContext* opCtx, int n, const char* _ids) {
@@ -303,7 +303,10 @@ CursorManager::~CursorManager() {
     if (!isGlobalManager()) {
         globalCursorIdCache->deregisterCursorManager(_collectionCacheRuntimeId, _nss);
     }
-    invariant(_cursors.empty());
+    for (auto&& partition : _partitions) {
+        invariant(partition.cursors.empty());
+        invariant(partition.idleCursors.empty());
+    }
     invariant(_nonCachedExecutors.empty());
 }
 
@@ -313,37 +316,47 @@ void CursorManager::invalidateAll(OperationContext* opCtx,
     invariant(!isGlobalManager());  // The global cursor manager should never need to kill cursors.
     dassert(opCtx->lockState()->isCollectionLockedForMode(_nss.ns(), MODE_X));
 
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    fassert(28819, !BackgroundOperation::inProgForNs(_nss));
+    {
+        stdx::lock_guard<SimpleMutex> lk(_executorsMutex);
+        fassert(28819, !BackgroundOperation::inProgForNs(_nss));
 
-    for (auto&& exec : _nonCachedExecutors) {
-        // We kill the executor, but it deletes itself.
-        exec->markAsKilled(reason);
+        for (auto&& exec : _nonCachedExecutors) {
+            // We kill the executor, but it deletes itself.
+            exec->markAsKilled(reason);
+        }
+        _nonCachedExecutors.clear();
     }
-    _nonCachedExecutors.clear();
-
-    CursorMap newMap;
-    for (auto&& entry : _cursors) {
-        auto* cursor = entry.second;
-        cursor->markAsKilled(reason);
 
-        if (cursor->_isPinned) {
-            // There is an active user of this cursor, who is now responsible for cleaning it up.
-            // This CursorManager will no longer track this cursor.
-            continue;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+
+        CursorMap newMap;
+        for (auto&& entry : partition.cursors) {
+            auto* cursor = entry.second;
+            cursor->markAsKilled(reason);
+
+            if (cursor->_isPinned) {
+                // There is an active user of this cursor, who is now responsible for cleaning it
+                // up. This CursorManager will no longer track this cursor.
+                continue;
+            }
+
+            if (!collectionGoingAway) {
+                // We keep around unpinned cursors so that future attempts to use the cursor will
+                // result in a useful error message.
+                newMap.insert(entry);
+            } else {
+                // The collection is going away, so there's no point in keeping any state.
+                cursor->dispose(opCtx);
+                cursor->_inIdleList = false;
+                delete cursor;
+            }
         }
-
-        if (!collectionGoingAway) {
-            // We keep around unpinned cursors so that future attempts to use the cursor will result
-            // in a useful error message.
-            newMap.insert(entry);
-        } else {
-            // The collection is going away, so there's no point in keeping any state.
-            cursor->dispose(opCtx);
-            delete cursor;
+        partition.cursors = newMap;
+        if (collectionGoingAway) {
+            partition.idleCursors.clear();
         }
     }
-    _cursors = newMap;
 }
 
 void CursorManager::invalidateDocument(OperationContext* opCtx,
@@ -356,56 +369,70 @@ void CursorManager::invalidateDocument(OperationContext* opCtx,
         return;
     }
 
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-
-    for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-         ++it) {
-        (*it)->invalidate(opCtx, dl, type);
+    {
+        stdx::lock_guard<SimpleMutex> lk(_executorsMutex);
+        for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
+             ++it) {
+            (*it)->invalidate(opCtx, dl, type);
+        }
     }
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        i->second->getExecutor()->invalidate(opCtx, dl, type);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            i->second->getExecutor()->invalidate(opCtx, dl, type);
+        }
     }
 }
 
-std::size_t CursorManager::timeoutCursors(OperationContext* opCtx, int millisSinceLastCall) {
-    vector<ClientCursor*> toDelete;
-
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        // shouldTimeout() ensures that we skip pinned cursors.
-        if (cc->shouldTimeout(millisSinceLastCall))
-            toDelete.push_back(cc);
-    }
+std::size_t CursorManager::timeoutCursors(OperationContext* opCtx, Milliseconds now) {
+    std::size_t numTimedOut = 0;
+
+    for (auto&& partition : _partitions) {
+        vector<ClientCursor*> toDelete;
+        {
+            stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+
+            // The idle cursors are ordered by when they were last used, so the expired cursors are
+            // all at the front of the list.
+            while (!partition.idleCursors.empty() &&
+                   partition.idleCursors.front()->shouldTimeout(now)) {
+                ClientCursor* cc = partition.idleCursors.front();
+                _deregisterCursor_inlock(&partition, cc);
+                toDelete.push_back(cc);
+            }
+        }
 
-    // Properly dispose of each cursor that was timed out.
-    for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end(); ++i) {
-        ClientCursor* cc = *i;
-        _deregisterCursor_inlock(cc);
-        cc->dispose(opCtx);
-        delete cc;
+        // The timed out cursors are no longer reachable through this manager, so they can be
+        // disposed of without holding the partition lock.
+        for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end(); ++i) {
+            ClientCursor* cc = *i;
+            cc->dispose(opCtx);
+            delete cc;
+        }
+        numTimedOut += toDelete.size();
     }
 
-    return toDelete.size();
+    return numTimedOut;
 }
 
 void CursorManager::registerExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    stdx::lock_guard<SimpleMutex> lk(_executorsMutex);
     const std::pair<ExecSet::iterator, bool> result = _nonCachedExecutors.insert(exec);
     invariant(result.second);  // make sure this was inserted
 }
 
 void CursorManager::deregisterExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    stdx::lock_guard<SimpleMutex> lk(_executorsMutex);
     _nonCachedExecutors.erase(exec);
 }
 
 StatusWith<ClientCursorPin> CursorManager::pinCursor(OperationContext* opCtx, CursorId id) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorMap::const_iterator it = _cursors.find(id);
-    if (it == _cursors.end()) {
+    Partition& partition = _getPartition(id);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    CursorMap::const_iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end()) {
         return {ErrorCodes::CursorNotFound, str::stream() << "cursor id " << id << " not found"};
     }
 
@@ -416,90 +443,120 @@ StatusWith<ClientCursorPin> CursorManager::pinCursor(OperationContext* opCtx, Cu
         Status error{ErrorCodes::QueryPlanKilled,
                      str::stream() << "cursor killed because: "
                                    << cursor->getExecutor()->getKillReason()};
-        _deregisterCursor_inlock(cursor);
+        _deregisterCursor_inlock(&partition, cursor);
         cursor->dispose(opCtx);
         delete cursor;
         return error;
     }
     cursor->_isPinned = true;
+    if (cursor->_inIdleList) {
+        partition.idleCursors.erase(cursor->_idleListPosition);
+        cursor->_inIdleList = false;
+    }
     return ClientCursorPin(opCtx, cursor);
 }
 
 void CursorManager::unpin(ClientCursor* cursor) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    Partition& partition = _getPartition(cursor->cursorid());
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
     invariant(cursor->_isPinned);
+    invariant(!cursor->_inIdleList);
     cursor->_isPinned = false;
+
+    // Taking the time under the partition lock keeps the idle list ordered by last use.
+    cursor->_lastUseTime = ClientCursor::idleClockNow();
+    if (!cursor->isNoTimeout()) {
+        cursor->_idleListPosition =
+            partition.idleCursors.insert(partition.idleCursors.end(), cursor);
+        cursor->_inIdleList = true;
+    }
 }
 
 void CursorManager::getCursorIds(std::set<CursorId>* openCursors) const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        openCursors->insert(cc->cursorid());
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            ClientCursor* cc = i->second;
+            openCursors->insert(cc->cursorid());
+        }
     }
 }
 
 size_t CursorManager::numCursors() const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    return _cursors.size();
+    size_t numCursors = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        numCursors += partition.cursors.size();
+    }
+    return numCursors;
 }
 
-CursorId CursorManager::_allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        // The leading two bits of a CursorId are used to determine if the cursor is registered on
-        // the global cursor manager.
-        CursorId id;
-        if (isGlobalManager()) {
-            // This is the global cursor manager, so generate a random number and make sure the
-            // first two bits are 01.
-            uint64_t mask = 0x3FFFFFFFFFFFFFFF;
-            uint64_t bitToSet = 1ULL << 62;
-            id = ((_random->nextInt64() & mask) | bitToSet);
-        } else {
-            // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32
-            // bits are random.
-            uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
-            id = cursorIdFromParts(_collectionCacheRuntimeId, myPart);
-        }
-        if (_cursors.count(id) == 0)
-            return id;
+CursorId CursorManager::_generateCursorId() {
+    stdx::lock_guard<SimpleMutex> lk(_randomMutex);
+
+    // The leading two bits of a CursorId are used to determine if the cursor is registered on
+    // the global cursor manager.
+    if (isGlobalManager()) {
+        // This is the global cursor manager, so generate a random number and make sure the
+        // first two bits are 01.
+        uint64_t mask = 0x3FFFFFFFFFFFFFFF;
+        uint64_t bitToSet = 1ULL << 62;
+        return ((_random->nextInt64() & mask) | bitToSet);
     }
-    fassertFailed(17360);
+
+    // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32
+    // bits are random.
+    uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
+    return cursorIdFromParts(_collectionCacheRuntimeId, myPart);
 }
 
 ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
                                               ClientCursorParams&& cursorParams) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
     // Make sure the PlanExecutor isn't registered, since we will register the ClientCursor wrapping
     // it.
     invariant(cursorParams.exec);
-    _nonCachedExecutors.erase(cursorParams.exec.get());
+    {
+        stdx::lock_guard<SimpleMutex> lk(_executorsMutex);
+        _nonCachedExecutors.erase(cursorParams.exec.get());
+    }
     cursorParams.exec.get_deleter().dismissDisposal();
     cursorParams.exec->unsetRegistered();
 
-    CursorId cursorId = _allocateCursorId_inlock();
-    invariant(cursorId);
-    std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(
-        new ClientCursor(std::move(cursorParams), this, cursorId));
+    for (int i = 0; i < 10000; i++) {
+        CursorId cursorId = _generateCursorId();
+        invariant(cursorId);
+
+        Partition& partition = _getPartition(cursorId);
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        if (partition.cursors.count(cursorId) != 0)
+            continue;
+
+        std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(
+            new ClientCursor(std::move(cursorParams), this, cursorId));
 
-    // Transfer ownership of the cursor to '_cursors'.
-    ClientCursor* unownedCursor = clientCursor.release();
-    _cursors[cursorId] = unownedCursor;
-    return ClientCursorPin(opCtx, unownedCursor);
+        // Transfer ownership of the cursor to the partition's cursor map.
+        ClientCursor* unownedCursor = clientCursor.release();
+        partition.cursors[cursorId] = unownedCursor;
+        return ClientCursorPin(opCtx, unownedCursor);
+    }
+    fassertFailed(17360);
 }
 
 void CursorManager::deregisterCursor(ClientCursor* cc) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _deregisterCursor_inlock(cc);
+    Partition& partition = _getPartition(cc->cursorid());
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    _deregisterCursor_inlock(&partition, cc);
 }
 
 Status CursorManager::eraseCursor(OperationContext* opCtx, CursorId id, bool shouldAudit) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    Partition& partition = _getPartition(id);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    CursorMap::iterator it = _cursors.find(id);
-    if (it == _cursors.end()) {
+    CursorMap::iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end()) {
         if (shouldAudit) {
             audit::logKillCursorsAuthzCheck(
                 opCtx->getClient(), _nss, id, ErrorCodes::CursorNotFound);
@@ -521,15 +578,19 @@ Status CursorManager::eraseCursor(OperationContext* opCtx, CursorId id, bool sho
         audit::logKillCursorsAuthzCheck(opCtx->getClient(), _nss, id, ErrorCodes::OK);
     }
 
-    _deregisterCursor_inlock(cursor);
+    _deregisterCursor_inlock(&partition, cursor);
     cursor->dispose(opCtx);
     delete cursor;
     return Status::OK();
 }
 
-void CursorManager::_deregisterCursor_inlock(ClientCursor* cc) {
+void CursorManager::_deregisterCursor_inlock(Partition* partition, ClientCursor* cc) {
     invariant(cc);
     CursorId id = cc->cursorid();
-    _cursors.erase(id);
+    partition->cursors.erase(id);
+    if (cc->_inIdleList) {
+        partition->idleCursors.erase(cc->_idleListPosition);
+        cc->_inIdleList = false;
+    }
 }
 }  // namespace mongo
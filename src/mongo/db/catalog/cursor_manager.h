@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <array>
+#include <list>
 
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/invalidation_type.h"
@@ -37,6 +39,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -67,7 +70,10 @@ class PlanExecutor;
  * cursor manager.
  *
  * The CursorManager is internally synchronized; operations on a given collection may call methods
- * concurrently on that collection's CursorManager.
+ * concurrently on that collection's CursorManager. ClientCursors are spread over several
+ * partitions by cursor id, each with its own lock, so that pinning, unpinning and killing different
+ * cursors rarely contend. Each partition keeps its idle cursors in the order they were last used,
+ * so timing out cursors only visits the cursors which have expired.
  *
  * See clientcursor.h for more information.
  */
@@ -103,11 +109,12 @@ public:
     void invalidateDocument(OperationContext* opCtx, const RecordId& dl, InvalidationType type);
 
     /**
-     * Destroys cursors that have been inactive for too long.
+     * Destroys cursors that have been inactive for longer than cursorTimeoutMillis as of 'now', as
+     * read from ClientCursor::idleClockNow().
      *
      * Returns the number of cursors that were timed out.
      */
-    std::size_t timeoutCursors(OperationContext* opCtx, int millisSinceLastCall);
+    std::size_t timeoutCursors(OperationContext* opCtx, Milliseconds now);
 
     /**
      * Register an executor so that it can be notified of deletion/invalidation during yields.
@@ -181,13 +188,30 @@ public:
      * Deletes inactive cursors from the global cursor manager and from all per-collection cursor
      * managers. Returns the number of cursors that were timed out.
      */
-    static std::size_t timeoutCursorsGlobal(OperationContext* opCtx, int millisSinceLastCall);
+    static std::size_t timeoutCursorsGlobal(OperationContext* opCtx, Milliseconds now);
 
 private:
     friend class ClientCursorPin;
 
-    CursorId _allocateCursorId_inlock();
-    void _deregisterCursor_inlock(ClientCursor* cc);
+    static const size_t kNumPartitions = 16;
+
+    typedef std::map<CursorId, ClientCursor*> CursorMap;
+
+    // Unpinned cursors which may time out, least recently used first.
+    typedef std::list<ClientCursor*> IdleCursorList;
+
+    struct Partition {
+        mutable SimpleMutex mutex;
+        CursorMap cursors;
+        IdleCursorList idleCursors;
+    };
+
+    Partition& _getPartition(CursorId id) {
+        return _partitions[static_cast<uint64_t>(id) % kNumPartitions];
+    }
+
+    CursorId _generateCursorId();
+    void _deregisterCursor_inlock(Partition* partition, ClientCursor* cc);
 
     void deregisterCursor(ClientCursor* cc);
 
@@ -199,14 +223,16 @@ private:
 
     NamespaceString _nss;
     uint32_t _collectionCacheRuntimeId;
-    std::unique_ptr<PseudoRandom> _random;
 
-    mutable SimpleMutex _mutex;
+    // Guards '_random'.
+    SimpleMutex _randomMutex;
+    std::unique_ptr<PseudoRandom> _random;
 
+    // Guards '_nonCachedExecutors'.
+    SimpleMutex _executorsMutex;
     typedef unordered_set<PlanExecutor*> ExecSet;
     ExecSet _nonCachedExecutors;
 
-    typedef std::map<CursorId, ClientCursor*> CursorMap;
-    CursorMap _cursors;
+    std::array<Partition, kNumPartitions> _partitions;
 };
 }  // namespace mongo
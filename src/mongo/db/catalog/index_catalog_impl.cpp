@@ -1134,7 +1134,11 @@ void IndexCatalogImpl::IndexIteratorImpl::_advance() {
 
         if (!_includeUnfinishedIndexes) {
             if (auto minSnapshot = entry->getMinimumVisibleSnapshot()) {
-                if (auto mySnapshot = _opCtx->recoveryUnit()->getMajorityCommittedSnapshot()) {
+                auto mySnapshot = _opCtx->recoveryUnit()->getMajorityCommittedSnapshot();
+                if (!mySnapshot) {
+                    mySnapshot = _opCtx->recoveryUnit()->getBatchBoundarySnapshot();
+                }
+                if (mySnapshot) {
                     if (mySnapshot < minSnapshot) {
                         // This index isn't finished in my snapshot.
                         continue;
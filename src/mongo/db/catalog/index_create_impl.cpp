@@ -47,8 +47,10 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -99,6 +101,51 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+// Number of threads generating and sorting keys during a foreground index build. 0 means one per
+// core, up to kMaxKeyGenerationThreads. 1 generates keys on the operation's own thread.
+MONGO_EXPORT_SERVER_PARAMETER(indexBuildKeyGenerationThreads, int, 0);
+
+namespace {
+
+// The key generation pool never grows past this many threads, regardless of the number of cores.
+const size_t kMaxKeyGenerationThreads = 16;
+
+// A foreground build reads up to this many documents, or this many bytes of documents, before
+// generating their keys in parallel.
+const size_t kKeyGenerationBatchSize = 4096;
+const size_t kKeyGenerationMaxBatchBytes = 16 * 1024 * 1024;
+
+size_t getKeyGenerationThreads() {
+    const int threads = indexBuildKeyGenerationThreads.load();
+    if (threads <= 0) {
+        ProcessInfo p;
+        return std::min(static_cast<size_t>(std::max(1U, p.getNumCores())),
+                        kMaxKeyGenerationThreads);
+    }
+    return std::min(static_cast<size_t>(threads), kMaxKeyGenerationThreads);
+}
+
+/**
+ * Returns the process-wide pool which generates index keys on behalf of index builds. Its tasks
+ * never block, so a build waiting on its own tasks cannot deadlock it, however many builds share
+ * the pool. The pool is intentionally leaked.
+ */
+ThreadPool* getKeyGenerationPool() {
+    static ThreadPool* pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "IndexBuildKeyGenerationPool";
+        options.threadNamePrefix = "indexkeygen";
+        options.minThreads = 0;
+        options.maxThreads = kMaxKeyGenerationThreads;
+        auto newPool = new ThreadPool(options);
+        newPool->startup();
+        return newPool;
+    }();
+    return pool;
+}
+
+}  // namespace
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -227,6 +274,10 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
             indexSpecs.size();
     }
 
+    // Bulk building requires foreground building as it assumes nothing is changing under it.
+    // Documents read ahead of their key generation are safe for the same reason.
+    _keyGenerationThreads = _buildInBackground ? 1 : getKeyGenerationThreads();
+
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
         StatusWith<BSONObj> statusWithInfo =
@@ -251,7 +302,8 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (!_buildInBackground) {
             // Bulk build process requires foreground building as it assumes nothing is changing
             // under it.
-            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
+            index.bulk =
+                index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes, _keyGenerationThreads);
         }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
@@ -319,6 +371,11 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
     RecordId loc;
     PlanExecutor::ExecState state;
     int retries = 0;  // non-zero when retrying our last document.
+
+    // Documents whose keys are generated in parallel, see insertBatch().
+    const bool generateKeysInParallel = _keyGenerationThreads > 1;
+    std::vector<BufferedDocument> batch;
+    size_t batchBytes = 0;
     while (retries ||
            (PlanExecutor::ADVANCED == (state = exec->getNextSnapshotted(&objToIndex, &loc)))) {
         try {
@@ -336,6 +393,25 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
             // Done before insert so we can retry document if it WCEs.
             progress->setTotalWhileRunning(_collection->numRecords(_opCtx));
 
+            if (generateKeysInParallel) {
+                batch.push_back({loc, objToIndex.value().getOwned()});
+                batchBytes += batch.back().obj.objsize();
+                if (batch.size() >= kKeyGenerationBatchSize ||
+                    batchBytes >= kKeyGenerationMaxBatchBytes) {
+                    Status ret = insertBatch(batch);
+                    if (!ret.isOK()) {
+                        return ret;
+                    }
+                    batch.clear();
+                    batchBytes = 0;
+                }
+
+                progress->hit();
+                n++;
+                retries = 0;
+                continue;
+            }
+
             WriteUnitOfWork wunit(_opCtx);
             Status ret = insert(objToIndex.value(), loc);
             if (_buildInBackground)
@@ -375,6 +451,13 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
                 WorkingSetCommon::toStatusString(objToIndex.value()),
             state == PlanExecutor::IS_EOF);
 
+    if (!batch.empty()) {
+        Status ret = insertBatch(batch);
+        if (!ret.isOK()) {
+            return ret;
+        }
+    }
+
     if (MONGO_FAIL_POINT(hangAfterStartingIndexBuild)) {
         // Need the index build to hang before the progress meter is marked as finished so we can
         // reliably check that the index build has actually started in js tests.
@@ -412,6 +495,75 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
     return Status::OK();
 }
 
+Status MultiIndexBlockImpl::insertBatch(const std::vector<BufferedDocument>& batch) {
+    invariant(_keyGenerationThreads > 1);
+
+    // Keys are generated for the documents in [begin, end) and added to the sorted run 'run' of
+    // every index. Runs are owned by a single thread for the duration of the batch.
+    auto insertRange = [this, &batch](size_t run, size_t begin, size_t end) -> Status {
+        for (size_t doc = begin; doc < end; ++doc) {
+            for (auto&& index : _indexes) {
+                invariant(index.bulk);
+                if (index.filterExpression &&
+                    !index.filterExpression->matchesBSON(batch[doc].obj)) {
+                    continue;
+                }
+                Status status = index.bulk->insertIntoRun(
+                    run, batch[doc].obj, batch[doc].loc, index.options, nullptr);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+        }
+        return Status::OK();
+    };
+
+    const size_t rangeSize = (batch.size() + _keyGenerationThreads - 1) / _keyGenerationThreads;
+    const size_t numRanges = (batch.size() + rangeSize - 1) / rangeSize;
+
+    stdx::mutex mutex;
+    stdx::condition_variable rangesDone;
+    size_t rangesRemaining = numRanges;
+    Status status = Status::OK();
+
+    // Records the outcome of one range. Notifying while holding the mutex keeps the condition
+    // variable alive until the last notification has been delivered.
+    auto finishRange = [&](Status rangeStatus) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (!rangeStatus.isOK() && status.isOK()) {
+            status = std::move(rangeStatus);
+        }
+        if (--rangesRemaining == 0) {
+            rangesDone.notify_all();
+        }
+    };
+
+    auto runRange = [&](size_t run) {
+        const size_t begin = run * rangeSize;
+        const size_t end = std::min(batch.size(), begin + rangeSize);
+        try {
+            finishRange(insertRange(run, begin, end));
+        } catch (const DBException& ex) {
+            finishRange(ex.toStatus());
+        } catch (const std::exception& ex) {
+            finishRange({ErrorCodes::InternalError, ex.what()});
+        }
+    };
+
+    // The operation's own thread handles the first range.
+    for (size_t run = 1; run < numRanges; ++run) {
+        auto scheduleStatus = getKeyGenerationPool()->schedule([&runRange, run] { runRange(run); });
+        if (!scheduleStatus.isOK()) {
+            runRange(run);
+        }
+    }
+    runRange(0);
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    rangesDone.wait(lk, [&] { return rangesRemaining == 0; });
+    return status;
+}
+
 Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
@@ -41,6 +41,7 @@
 #include "mongo/db/catalog/index_catalog_impl.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -49,6 +50,9 @@ class BSONObj;
 class Collection;
 class OperationContext;
 
+// Number of threads generating keys in a foreground index build. 0 means one per core.
+extern AtomicInt32 indexBuildKeyGenerationThreads;
+
 /**
  * Builds one or more indexes.
  *
@@ -192,6 +196,21 @@ private:
     class SetNeedToCleanupOnRollback;
     class CleanupIndexesVectorOnRollback;
 
+    /**
+     * A document read by insertAllDocumentsInCollection() whose keys have not been generated yet.
+     */
+    struct BufferedDocument {
+        RecordId loc;
+        BSONObj obj;  // Owned.
+    };
+
+    /**
+     * Generates the keys of 'batch' for every index on '_keyGenerationThreads' threads. Each
+     * thread takes a contiguous range of the batch and adds its keys to its own sorted run of the
+     * indexes' bulk builders. Only used for foreground builds, which build every index in bulk.
+     */
+    Status insertBatch(const std::vector<BufferedDocument>& batch);
+
     struct IndexToBuild {
         std::unique_ptr<IndexCatalogImpl::IndexBuildBlock> block;
 
@@ -215,6 +234,11 @@ private:
     bool _ignoreUnique;
 
     bool _needToCleanup;
+
+    // Number of threads generating keys in insertAllDocumentsInCollection(), and the number of
+    // sorted runs of each bulk builder. Set by init(); 1 means keys are generated on the
+    // operation's own thread as each document is read.
+    size_t _keyGenerationThreads = 1;
 };
 
 }  // namespace mongo
@@ -49,6 +49,7 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
@@ -133,16 +134,20 @@ void ClientCursor::dispose(OperationContext* opCtx) {
 // Timing and timeouts
 //
 
-bool ClientCursor::shouldTimeout(int millis) {
-    _idleAgeMillis += millis;
+Milliseconds ClientCursor::idleClockNow() {
+    auto tickSource = getGlobalServiceContext()->getTickSource();
+    const auto ticks = tickSource->getTicks();
+    const auto ticksPerSecond = tickSource->getTicksPerSecond();
+    // Split the conversion so that it does not overflow for tick sources with a fine resolution.
+    return Milliseconds(ticks / ticksPerSecond * 1000 +
+                        ticks % ticksPerSecond * 1000 / ticksPerSecond);
+}
+
+bool ClientCursor::shouldTimeout(Milliseconds now) const {
     if (isNoTimeout() || _isPinned) {
         return false;
     }
-    return _idleAgeMillis > cursorTimeoutMillis.load();
-}
-
-void ClientCursor::resetIdleTime() {
-    _idleAgeMillis = 0;
+    return now - _lastUseTime > Milliseconds(cursorTimeoutMillis.load());
 }
 
 void ClientCursor::updateSlaveLocation(OperationContext* opCtx) {
@@ -279,13 +284,12 @@ public:
 
     void run() {
         Client::initThread("clientcursormon");
-        Timer t;
         while (!globalInShutdownDeprecated()) {
             {
                 const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
                 OperationContext& opCtx = *opCtxPtr;
                 cursorStatsTimedOut.increment(
-                    CursorManager::timeoutCursorsGlobal(&opCtx, t.millisReset()));
+                    CursorManager::timeoutCursorsGlobal(&opCtx, ClientCursor::idleClockNow()));
             }
             MONGO_IDLE_THREAD_BLOCK;
             sleepsecs(clientCursorMonitorFrequencySecs.load());
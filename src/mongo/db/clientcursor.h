@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <list>
+
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/cursor_id.h"
@@ -36,6 +38,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -154,24 +157,25 @@ public:
     //
 
     /**
-     * Increments the amount of time for which this cursor believes it has been idle by 'millis'.
-     *
-     * After factoring in this additional idle time, returns whether or not this cursor now exceeds
-     * its idleness timeout and should be deleted.
+     * Returns the current time of the clock that idle times are measured with: the service
+     * context's tick source, in milliseconds. Unlike the wall clock, it never steps forwards or
+     * backwards, so a clock correction cannot time out every idle cursor or keep them all alive.
      */
-    bool shouldTimeout(int millis);
+    static Milliseconds idleClockNow();
 
     /**
-     * Resets this cursor's idle time to zero. Only cursors whose idle time is sufficiently high
-     * will be deleted by the cursor manager's reaper thread.
+     * Returns whether this cursor, if it has been idle since it was last unpinned, exceeds its
+     * idleness timeout at time 'now', as read from idleClockNow(), and should be deleted. Pinned
+     * cursors and cursors marked as "no timeout" never time out.
      */
-    void resetIdleTime();
+    bool shouldTimeout(Milliseconds now) const;
 
     /**
-     * Returns the number of milliseconds for which this cursor believes it has been idle.
+     * Returns the idleClockNow() time at which this cursor was last unpinned, which is when it last
+     * became idle.
      */
-    int idleTime() const {
-        return _idleAgeMillis;
+    Milliseconds getLastUseTime() const {
+        return _lastUseTime;
     }
 
     /**
@@ -302,8 +306,14 @@ private:
     // The replication position only used in master-slave.
     Timestamp _slaveReadTill;
 
-    // How long has the cursor been idle?
-    int _idleAgeMillis = 0;
+    // When the cursor was last unpinned, as read from idleClockNow().
+    Milliseconds _lastUseTime;
+
+    // The cursor's position in its CursorManager's list of idle cursors which may time out. Only
+    // valid while '_inIdleList' is true, which requires the cursor to be unpinned and not marked
+    // as "no timeout". Guarded by the CursorManager's partition lock for this cursor.
+    std::list<ClientCursor*>::iterator _idleListPosition;
+    bool _inIdleList = false;
 
     // Unused maxTime budget for this cursor.
     Microseconds _leftoverMaxTimeMicros = Microseconds::max();
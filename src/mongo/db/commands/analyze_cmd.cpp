@@ -0,0 +1,248 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using std::string;
+using std::stringstream;
+
+namespace {
+
+/**
+ * Builds statistics for 'descriptor' from a full scan of the index. The scan yields, so the
+ * collection or index may be dropped before it completes, in which case an error is returned.
+ */
+StatusWith<std::unique_ptr<IndexStatistics>> analyzeIndex(OperationContext* opCtx,
+                                                          Collection* collection,
+                                                          const IndexDescriptor* descriptor) {
+    const long long numRecords = collection->numRecords(opCtx);
+    const size_t maxBuckets = std::max(1, internalQueryIndexStatisticsHistogramBuckets.load());
+    IndexStatistics::Builder builder(maxBuckets, numRecords / maxBuckets);
+
+    // The histogram is built over ascending values of the leading field, so an index whose leading
+    // field is descending is scanned backwards. The bounds span every key in either direction.
+    const bool forward = descriptor->keyPattern().firstElement().number() >= 0;
+    BSONObjBuilder firstKeyBuilder;
+    BSONObjBuilder lastKeyBuilder;
+    for (const BSONElement& field : descriptor->keyPattern()) {
+        if (field.number() >= 0) {
+            firstKeyBuilder.appendMinKey("");
+            lastKeyBuilder.appendMaxKey("");
+        } else {
+            firstKeyBuilder.appendMaxKey("");
+            lastKeyBuilder.appendMinKey("");
+        }
+    }
+    const BSONObj firstKey = firstKeyBuilder.obj();
+    const BSONObj lastKey = lastKeyBuilder.obj();
+
+    auto exec = InternalPlanner::indexScan(opCtx,
+                                           collection,
+                                           descriptor,
+                                           forward ? firstKey : lastKey,
+                                           forward ? lastKey : firstKey,
+                                           BoundInclusion::kIncludeBothStartAndEndKeys,
+                                           PlanExecutor::YIELD_AUTO,
+                                           forward ? InternalPlanner::FORWARD
+                                                   : InternalPlanner::BACKWARD,
+                                           InternalPlanner::IXSCAN_NO_DEDUP);
+
+    BSONObj key;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&key, nullptr))) {
+        builder.addKey(key.firstElement());
+    }
+    if (PlanExecutor::IS_EOF != state) {
+        const Status status = WorkingSetCommon::getMemberObjectStatus(key);
+        return {status.code(),
+                str::stream() << "failed to analyze index " << descriptor->indexName()
+                              << " :: caused by :: " << status.reason()};
+    }
+    return builder.done(numRecords);
+}
+
+}  // namespace
+
+/**
+ * Gathers the index statistics the query planner uses to estimate the cost of candidate plans.
+ *
+ * { analyze: <collection>, [index: <name>,] [histogram: <bool>,] [clear: <bool>] }
+ */
+class AnalyzeCmd : public Command {
+public:
+    AnalyzeCmd() : Command("analyze") {}
+
+    virtual bool slaveOk() const {
+        return true;
+    }
+
+    virtual void help(stringstream& h) const {
+        h << "Scan the indexes of a collection and record the distribution of their keys for use "
+             "by the query planner.\n"
+             "{ analyze: <collection>, [index: <name>,] [histogram: <bool>,] [clear: <bool>] }\n"
+             "Slow: reads every key of the analyzed indexes.";
+    }
+
+    virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {
+        // Statistics change the plans chosen for the collection, like the plan cache commands.
+        ActionSet actions;
+        actions.addAction(ActionType::planCacheWrite);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const string& dbname,
+             BSONObj& cmdObj,
+             string& errmsg,
+             BSONObjBuilder& result) {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        const BSONElement indexElt = cmdObj["index"];
+        if (!indexElt.eoo() && indexElt.type() != String) {
+            return appendCommandStatus(
+                result, {ErrorCodes::TypeMismatch, "'index' must be the name of an index"});
+        }
+        const string indexName = indexElt.eoo() ? "" : indexElt.String();
+        const bool includeHistogram = cmdObj["histogram"].trueValue();
+
+        AutoGetCollectionOrViewForReadCommand ctx(opCtx, nss);
+        if (ctx.getView()) {
+            return appendCommandStatus(
+                result, {ErrorCodes::CommandNotSupportedOnView, "cannot analyze a view"});
+        }
+        Collection* collection = ctx.getCollection();
+        if (!collection) {
+            return appendCommandStatus(result, {ErrorCodes::NamespaceNotFound, "ns not found"});
+        }
+
+        CollectionStatistics* stats = collection->infoCache()->getCollectionStatistics();
+        if (cmdObj["clear"].trueValue()) {
+            if (indexName.empty()) {
+                stats->clear();
+            } else {
+                stats->remove(indexName);
+            }
+            collection->infoCache()->clearQueryCache();
+            return true;
+        }
+
+        // The index scans yield, which may change the index catalog, so the indexes are looked up
+        // by name before each scan.
+        std::vector<string> indexNames;
+        IndexCatalog::IndexIterator ii =
+            collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+        while (ii.more()) {
+            const IndexDescriptor* descriptor = ii.next();
+            if (indexName.empty() || descriptor->indexName() == indexName) {
+                indexNames.push_back(descriptor->indexName());
+            }
+        }
+
+        const bool foundIndex = !indexNames.empty();
+        BSONObjBuilder indexesBuilder;
+        for (const string& name : indexNames) {
+            const IndexDescriptor* descriptor =
+                collection->getIndexCatalog()->findIndexByName(opCtx, name);
+            if (!descriptor) {
+                return appendCommandStatus(
+                    result,
+                    {ErrorCodes::IndexNotFound,
+                     str::stream() << "index " << name << " was dropped while analyzing"});
+            }
+
+            // Only the bounds of btree indexes are estimated by the planner.
+            if (descriptor->getAccessMethodName() != IndexNames::BTREE) {
+                if (!indexName.empty()) {
+                    return appendCommandStatus(
+                        result,
+                        {ErrorCodes::BadValue,
+                         str::stream() << "cannot analyze index " << indexName << " of type "
+                                       << descriptor->getAccessMethodName()});
+                }
+                continue;
+            }
+
+            auto swIndexStats = analyzeIndex(opCtx, collection, descriptor);
+            if (!swIndexStats.isOK()) {
+                return appendCommandStatus(result, swIndexStats.getStatus());
+            }
+            std::shared_ptr<const IndexStatistics> indexStats =
+                std::move(swIndexStats.getValue());
+            BSONObjBuilder indexBuilder(indexesBuilder.subobjStart(descriptor->indexName()));
+            indexStats->appendToBuilder(&indexBuilder, includeHistogram);
+            indexBuilder.doneFast();
+
+            stats->set(descriptor->indexName(), std::move(indexStats));
+        }
+        if (!foundIndex && !indexName.empty()) {
+            return appendCommandStatus(
+                result,
+                {ErrorCodes::IndexNotFound, str::stream() << "index not found: " << indexName});
+        }
+        result.append("indexes", indexesBuilder.obj());
+
+        // Cached plans were chosen without the new statistics.
+        collection->infoCache()->clearQueryCache();
+
+        LOG(1) << "analyzed indexes of " << nss.ns();
+        return true;
+    }
+
+} analyzeCmd;
+
+}  // namespace mongo
@@ -43,6 +43,7 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/fill_locker_info.h"
 #include "mongo/rpc/metadata/client_metadata.h"
@@ -162,6 +163,11 @@ public:
 
                 CurOp::get(opCtx)->reportState(&infoBuilder);
 
+                const auto arenaBytes = OperationArena::get(opCtx).bytesAllocated();
+                if (arenaBytes > 0) {
+                    infoBuilder.appendNumber("arenaBytes", arenaBytes);
+                }
+
                 // LockState
                 Locker::LockerInfo lockerInfo;
                 opCtx->lockState()->getLockerInfo(&lockerInfo);
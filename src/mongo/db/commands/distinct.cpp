@@ -32,6 +32,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -51,6 +52,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/find_common.h"
@@ -72,6 +74,14 @@ using std::stringstream;
 
 namespace dps = ::mongo::dotted_path_support;
 
+namespace {
+
+// Set of the distinct values found so far, allocated from the operation's arena.
+using DistinctValueSet =
+    std::set<BSONElement, BSONElementCmpWithoutField, OperationArenaAllocator<BSONElement>>;
+
+}  // namespace
+
 class DistinctCommand : public Command {
 public:
     DistinctCommand() : Command("distinct") {}
@@ -235,7 +245,12 @@ public:
         char* start = bb.buf();
 
         BSONArrayBuilder arr(bb);
-        BSONElementSet values(executor.getValue()->getCanonicalQuery()->getCollator());
+
+        // The set of distinct values only grows until the command returns, so its nodes come from
+        // the operation's arena and are released together with the operation.
+        DistinctValueSet values(
+            BSONElementCmpWithoutField(executor.getValue()->getCanonicalQuery()->getCollator()),
+            OperationArenaAllocator<BSONElement>(&OperationArena::get(opCtx)));
 
         BSONObj obj;
         PlanExecutor::ExecState state;
@@ -432,6 +432,13 @@ Status PlanCacheListPlans::list(OperationContext* opCtx,
                 scoreBob.append("score", entry->feedback[i]->score);
             }
             scoresBob.doneFast();
+
+            // Usage stats of the cache entry, which are attributed to its winning plan.
+            feedbackBob.appendNumber("hits", static_cast<long long>(entry->hits));
+            feedbackBob.appendNumber("works", static_cast<long long>(entry->works));
+            feedbackBob.appendNumber("replans", static_cast<long long>(entry->replans));
+            feedbackBob.appendNumber("estimatedSizeBytes",
+                                     static_cast<long long>(entry->estimatedEntrySizeBytes));
         }
         feedbackBob.doneFast();
 
@@ -311,13 +311,15 @@ LockResult LockerImpl<IsForMMAPV1>::lockGlobalBegin(LockMode mode) {
     dassert(isLocked() == (_modeForTicket != MODE_NONE));
     if (_modeForTicket == MODE_NONE) {
         const bool reader = isSharedLockMode(mode);
-        auto holder = ticketHolders[mode];
+        auto holder = shouldAcquireTicket() ? ticketHolders[mode] : nullptr;
         if (holder) {
             _clientState.store(reader ? kQueuedReader : kQueuedWriter);
-            holder->waitForTicket();
+            holder->waitForTicket(hasHighTicketPriority() ? TicketHolder::Priority::kHigh
+                                                          : TicketHolder::Priority::kNormal);
         }
         _clientState.store(reader ? kActiveReader : kActiveWriter);
         _modeForTicket = mode;
+        _ticketHolder = holder;
     }
     const LockResult result = lockBegin(resourceIdGlobal, mode);
     if (result == LOCK_OK)
@@ -802,8 +804,9 @@ bool LockerImpl<IsForMMAPV1>::_unlockImpl(LockRequestsMap::Iterator* it) {
     if (globalLockManager.unlock(it->objAddr())) {
         if (it->key() == resourceIdGlobal) {
             invariant(_modeForTicket != MODE_NONE);
-            auto holder = ticketHolders[_modeForTicket];
+            auto holder = _ticketHolder;
             _modeForTicket = MODE_NONE;
+            _ticketHolder = nullptr;
             if (holder) {
                 holder->release();
             }
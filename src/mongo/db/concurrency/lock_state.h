@@ -37,6 +37,8 @@
 
 namespace mongo {
 
+class TicketHolder;
+
 /**
  * Notfication callback, which stores the last notification result and signals a condition
  * variable, which can be waited on.
@@ -222,6 +224,10 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // The TicketHolder the ticket for _modeForTicket was taken from. Null if that mode is not
+    // throttled or this Locker opted out of admission control.
+    TicketHolder* _ticketHolder = nullptr;
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
@@ -38,7 +38,9 @@
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -234,6 +236,29 @@ TEST(LockerImpl, DefaultLocker) {
     ASSERT(locker.unlockGlobal());
 }
 
+TEST(LockerImpl, LockerThatOptsOutOfAdmissionControlDoesNotTakeATicket) {
+    TicketHolder reading(5);
+    TicketHolder writing(5);
+    Locker::setGlobalThrottling(&reading, &writing);
+    ON_BLOCK_EXIT([] { Locker::setGlobalThrottling(nullptr, nullptr); });
+
+    DefaultLockerImpl throttled;
+    ASSERT_EQUALS(LOCK_OK, throttled.lockGlobal(MODE_IX));
+    ASSERT_EQUALS(1, writing.used());
+
+    DefaultLockerImpl internal;
+    internal.setShouldAcquireTicket(false);
+    ASSERT_EQUALS(LOCK_OK, internal.lockGlobal(MODE_IX));
+    ASSERT_EQUALS(1, writing.used());
+
+    ASSERT(internal.unlockGlobal());
+    ASSERT_EQUALS(1, writing.used());
+
+    ASSERT(throttled.unlockGlobal());
+    ASSERT_EQUALS(0, writing.used());
+    ASSERT_EQUALS(0, reading.used());
+}
+
 TEST(LockerImpl, MMAPV1Locker) {
     const ResourceId resId(RESOURCE_DATABASE, "TestDB"_sd);
 
@@ -327,11 +327,39 @@ public:
         return _shouldConflictWithSecondaryBatchApplication;
     }
 
+    /**
+     * If set to false, this opts out of the storage engine's admission control (the TicketHolders
+     * installed by setGlobalThrottling()), so the operation is never queued behind user traffic.
+     * This is meant for internal work whose concurrency is already bounded, such as oplog
+     * application. Takes effect the next time the global lock is acquired.
+     */
+    void setShouldAcquireTicket(bool newValue) {
+        _shouldAcquireTicket = newValue;
+    }
+    bool shouldAcquireTicket() const {
+        return _shouldAcquireTicket;
+    }
+
+    /**
+     * If set to true, this Locker still goes through admission control, but is handed released
+     * tickets ahead of Lockers with normal priority. This is meant for internal work which must
+     * not be starved by user traffic, such as the TTL monitor. Takes effect the next time the
+     * global lock is acquired.
+     */
+    void setHighTicketPriority(bool newValue) {
+        _highTicketPriority = newValue;
+    }
+    bool hasHighTicketPriority() const {
+        return _highTicketPriority;
+    }
+
 protected:
     Locker() {}
 
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
+    bool _shouldAcquireTicket = true;
+    bool _highTicketPriority = false;
 };
 
 }  // namespace mongo
@@ -410,6 +410,7 @@ void CurOp::reportState(BSONObjBuilder* builder) {
             BSONObjBuilder sub(builder->subobjStart("progress"));
             sub.appendNumber("done", (long long)_progressMeter.done());
             sub.appendNumber("total", (long long)_progressMeter.total());
+            sub.appendNumber("perSecond", (long long)_progressMeter.ratePerSecond());
             sub.done();
         } else {
             builder->append("msg", _message);
@@ -541,6 +542,10 @@ string OpDebug::report(Client* client,
         s << " writeConflicts:" << writeConflicts;
     }
 
+    if (arenaBytes > 0) {
+        s << " arenaBytes:" << arenaBytes;
+    }
+
     if (!exceptionInfo.empty()) {
         s << " exception: " << redact(exceptionInfo.msg);
         if (exceptionInfo.code)
@@ -652,6 +657,10 @@ void OpDebug::append(const CurOp& curop,
         b.appendNumber("writeConflicts", writeConflicts);
     }
 
+    if (arenaBytes > 0) {
+        b.appendNumber("arenaBytes", arenaBytes);
+    }
+
     b.appendNumber("numYield", curop.numYields());
 
     {
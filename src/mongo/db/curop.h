@@ -118,6 +118,7 @@ public:
     long long keysInserted{0};  // Number of index keys inserted.
     long long keysDeleted{0};   // Number of index keys removed.
     long long writeConflicts{0};
+    long long arenaBytes{0};  // Bytes allocated from the operation's OperationArena.
 
     BSONObj execStats;  // Owned here.
 
@@ -119,6 +119,7 @@
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor_startup_param.h"
 #include "mongo/transport/transport_layer_legacy.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/background.h"
@@ -474,6 +475,9 @@ ExitCode _initAndListen(int listenPort) {
     transport::TransportLayerLegacy::Options options;
     options.port = listenPort;
     options.ipList = serverGlobalParams.bind_ip;
+    if (transport::isServiceExecutorFixedThreadPool()) {
+        options.asyncWaitThreads = transport::getServiceExecutorThreadCount();
+    }
 
     globalServiceContext->setServiceEntryPoint(
         stdx::make_unique<ServiceEntryPointMongod>(globalServiceContext->getTransportLayer()));
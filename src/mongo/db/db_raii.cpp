@@ -37,10 +37,13 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/top.h"
 
 namespace mongo {
 
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(secondaryReadsFromBatchBoundarySnapshot, bool, false);
+
 AutoGetDb::AutoGetDb(OperationContext* opCtx, StringData ns, LockMode mode)
     : _dbLock(opCtx, ns, mode), _db(dbHolder().get(opCtx, ns)) {}
 
@@ -107,12 +110,72 @@ AutoStatsTracker::~AutoStatsTracker() {
 AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
                                                    const NamespaceString& nss,
                                                    AutoGetCollection::ViewMode viewMode) {
+    const bool startedBatchBoundaryRead = _readFromBatchBoundarySnapshotIfPossible(opCtx, nss);
+
     _autoColl.emplace(opCtx, nss, MODE_IS, MODE_IS, viewMode);
 
+    if (startedBatchBoundaryRead) {
+        _ensureBatchBoundarySnapshotIsValid(opCtx, nss, viewMode);
+    }
+
     // Note: this can yield.
     _ensureMajorityCommittedSnapshotIsValid(nss, opCtx);
 }
 
+bool AutoGetCollectionForRead::_readFromBatchBoundarySnapshotIfPossible(
+    OperationContext* opCtx, const NamespaceString& nss) {
+    if (!secondaryReadsFromBatchBoundarySnapshot) {
+        return false;
+    }
+
+    // Replication's own readers, such as oplog fetchers, must see the latest data.
+    if (nss.isLocal() || !opCtx->getClient()->isFromUserConnection()) {
+        return false;
+    }
+
+    // Whether this operation conflicts with oplog application is decided when it takes the
+    // global lock, so it is too late to change if it already holds one.
+    if (opCtx->lockState()->isLocked()) {
+        return false;
+    }
+
+    if (!repl::ReplicationCoordinator::get(opCtx)->getMemberState().secondary()) {
+        return false;
+    }
+
+    // Fails if there is no snapshot yet, or if the operation already has a snapshot open or reads
+    // with readConcern 'majority'.
+    if (!opCtx->recoveryUnit()->setReadFromBatchBoundarySnapshot().isOK()) {
+        return false;
+    }
+
+    opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+    return true;
+}
+
+void AutoGetCollectionForRead::_ensureBatchBoundarySnapshotIsValid(
+    OperationContext* opCtx, const NamespaceString& nss, AutoGetCollection::ViewMode viewMode) {
+    auto coll = _autoColl->getCollection();
+    if (!coll) {
+        return;
+    }
+    auto minSnapshot = coll->getMinimumVisibleSnapshot();
+    if (!minSnapshot) {
+        return;
+    }
+    auto mySnapshot = opCtx->recoveryUnit()->getBatchBoundarySnapshot();
+    if (!mySnapshot || *mySnapshot >= *minSnapshot) {
+        return;
+    }
+
+    // Release our locks and take them again, this time conflicting with oplog application.
+    _autoColl = boost::none;
+    opCtx->recoveryUnit()->abandonSnapshot();
+    opCtx->recoveryUnit()->clearReadFromBatchBoundarySnapshot();
+    opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(true);
+    _autoColl.emplace(opCtx, nss, MODE_IS, MODE_IS, viewMode);
+}
+
 void AutoGetCollectionForRead::_ensureMajorityCommittedSnapshotIsValid(const NamespaceString& nss,
                                                                        OperationContext* opCtx) {
     while (true) {
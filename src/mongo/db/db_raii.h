@@ -43,6 +43,12 @@ namespace mongo {
 
 class Collection;
 
+/**
+ * If true, reads on a secondary are served from the snapshot taken at the end of the last oplog
+ * batch it applied, rather than waiting for the batch being applied. Set at startup.
+ */
+extern bool secondaryReadsFromBatchBoundarySnapshot;
+
 /**
  * RAII-style class, which acquires a lock on the specified database in the requested mode and
  * obtains a reference to the database. Used as a shortcut for calls to dbHolder().get().
@@ -206,6 +212,10 @@ private:
  * utility will ensure that the read will be performed against an appropriately committed snapshot
  * if the operation is using a readConcern of 'majority'.
  *
+ * On a secondary with 'secondaryReadsFromBatchBoundarySnapshot' enabled, user reads of collections
+ * outside the local database do not conflict with oplog application, and instead read from the
+ * snapshot taken at the end of the last applied batch.
+ *
  * Use this when you want to read the contents of a collection, but you are not at the top-level of
  * some command. This will ensure your reads obey any requested readConcern, but will not update the
  * status of CurrentOp, or add a Top entry.
@@ -239,6 +249,21 @@ public:
     }
 
 private:
+    /**
+     * Sets up 'opCtx' to read from the batch boundary snapshot, without conflicting with oplog
+     * application, if this read is allowed to. Returns whether it did.
+     */
+    bool _readFromBatchBoundarySnapshotIfPossible(OperationContext* opCtx,
+                                                  const NamespaceString& nss);
+
+    /**
+     * Falls back to reading the latest data, after the batch being applied, if the collection or
+     * one of its indexes changed after the batch boundary snapshot was taken.
+     */
+    void _ensureBatchBoundarySnapshotIsValid(OperationContext* opCtx,
+                                             const NamespaceString& nss,
+                                             AutoGetCollection::ViewMode viewMode);
+
     void _ensureMajorityCommittedSnapshotIsValid(const NamespaceString& nss,
                                                  OperationContext* opCtx);
 
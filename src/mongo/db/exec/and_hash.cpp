@@ -28,7 +28,7 @@
 
 #include "mongo/db/exec/and_hash.h"
 
-#include "mongo/db/exec/and_common-inl.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -97,7 +97,7 @@ bool AndHashStage::isEOF() {
     // Or we're streaming in results from the last child.
 
     // If there's nothing to probe against, we're EOF.
-    if (_dataMap.empty()) {
+    if (_intersection.empty()) {
         return true;
     }
 
@@ -137,7 +137,7 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
                 if (PlanStage::IS_EOF == childStatus) {
                     // A child went right to EOF.  Bail out.
                     _hashingChildren = false;
-                    _dataMap.clear();
+                    _intersection.clear();
                     return PlanStage::IS_EOF;
                 } else if (PlanStage::ADVANCED == childStatus) {
                     // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we
@@ -160,7 +160,7 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
                     }
 
                     _hashingChildren = false;
-                    _dataMap.clear();
+                    _intersection.clear();
                     return childStatus;
                 }
                 // We ignore NEED_TIME. TODO: what do we want to do if we get NEED_YIELD here?
@@ -181,7 +181,7 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
         if (_memUsage > _maxMemUsage) {
             mongoutils::str::stream ss;
             ss << "hashed AND stage buffered data usage of " << _memUsage
-               << " bytes exceeds internal limit of " << kDefaultMaxMemUsageBytes << " bytes";
+               << " bytes exceeds internal limit of " << _maxMemUsage << " bytes";
             Status status(ErrorCodes::Overflow, ss);
             *out = WorkingSetCommon::allocateStatusMember(_ws, status);
             return PlanStage::FAILURE;
@@ -193,19 +193,19 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
             return hashOtherChildren(out);
         } else {
             _hashingChildren = false;
-            // We don't hash our last child.  Instead, we probe the table created from the
+            // We don't collect our last child.  Instead, we probe the intersection of the
             // previous children, returning results in the order of the last child.
             // Fall through to below.
         }
     }
 
-    // Returning results.  We read from the last child and return the results that are in our
-    // hash map.
+    // Returning results.  We read from the last child and return the results that are in the
+    // intersection.
 
-    // We should be EOF if we're not hashing results and the dataMap is empty.
-    verify(!_dataMap.empty());
+    // We should be EOF if we're not hashing results and the intersection is empty.
+    verify(!_intersection.empty());
 
-    // We probe _dataMap with the last child.
+    // We probe _intersection with the last child.
     verify(_currentChild == _children.size() - 1);
 
     // Get the next result for the (_children.size() - 1)-th child.
@@ -224,23 +224,16 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
-    DataMap::iterator it = _dataMap.find(member->recordId);
-    if (_dataMap.end() == it) {
+    // Erasing the RecordId also ensures that it is returned at most once.
+    if (!_intersection.erase(member->recordId)) {
         // Child's output wasn't in every previous child.  Throw it out.
         _ws->free(*out);
         return PlanStage::NEED_TIME;
-    } else {
-        // Child's output was in every previous child.  Merge any key data in
-        // the child's output and free the child's just-outputted WSM.
-        WorkingSetID hashID = it->second;
-        _dataMap.erase(it);
-
-        AndCommon::mergeFrom(_ws, hashID, *member);
-        _ws->free(*out);
-
-        *out = hashID;
-        return PlanStage::ADVANCED;
     }
+
+    // Child's output was in every previous child.
+    _memUsage = _intersection.getMemUsage();
+    return PlanStage::ADVANCED;
 }
 
 PlanStage::StageState AndHashStage::workChild(size_t childNo, WorkingSetID* out) {
@@ -269,19 +262,13 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
             return PlanStage::NEED_TIME;
         }
 
-        if (!_dataMap.insert(std::make_pair(member->recordId, id)).second) {
-            // Didn't insert because we already had this RecordId inside the map. This should only
-            // happen if we're seeing a newer copy of the same doc in a more recent snapshot.
-            // Throw out the newer copy of the doc.
-            _ws->free(id);
-            return PlanStage::NEED_TIME;
-        }
-
-        // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
-        member->makeObjOwnedIfNeeded();
+        // A RecordId seen twice is a newer copy of the same doc in a more recent snapshot; it is
+        // only kept once.
+        _intersection.insert(member->recordId);
+        _ws->free(id);
 
         // Update memory stats.
-        _memUsage += member->getMemUsage();
+        _memUsage = _intersection.getMemUsage();
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::IS_EOF == childStatus) {
@@ -289,12 +276,12 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         _currentChild = 1;
 
         // If our first child was empty, don't scan any others, no possible results.
-        if (_dataMap.empty()) {
+        if (_intersection.empty()) {
             _hashingChildren = false;
             return PlanStage::IS_EOF;
         }
 
-        _specificStats.mapAfterChild.push_back(_dataMap.size());
+        _specificStats.mapAfterChild.push_back(_intersection.size());
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
@@ -334,53 +321,32 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
             return PlanStage::NEED_TIME;
         }
 
-        verify(member->hasRecordId());
-        if (_dataMap.end() == _dataMap.find(member->recordId)) {
-            // Ignore.  It's not in any previous child.
-        } else {
-            // We have a hit.  Copy data into the WSM we already have.
-            _seenMap.insert(member->recordId);
-            WorkingSetID olderMemberID = _dataMap[member->recordId];
-            WorkingSetMember* olderMember = _ws->get(olderMemberID);
-            size_t memUsageBefore = olderMember->getMemUsage();
-
-            AndCommon::mergeFrom(_ws, olderMemberID, *member);
+        // Only RecordIds still in the intersection are recorded, so the buffered data is bounded
+        // by the intersection rather than by the child's output.
+        if (_intersection.contains(member->recordId)) {
+            _currentChildIds.insert(member->recordId);
 
             // Update memory stats.
-            _memUsage += olderMember->getMemUsage() - memUsageBefore;
+            _memUsage = _intersection.getMemUsage() + _currentChildIds.getMemUsage();
         }
         _ws->free(id);
+
         return PlanStage::NEED_TIME;
     } else if (PlanStage::IS_EOF == childStatus) {
         // Finished with a child.
         ++_currentChild;
 
-        // Keep elements of _dataMap that are in _seenMap.
-        DataMap::iterator it = _dataMap.begin();
-        while (it != _dataMap.end()) {
-            if (_seenMap.end() == _seenMap.find(it->first)) {
-                DataMap::iterator toErase = it;
-                ++it;
-
-                // Update memory stats.
-                WorkingSetMember* member = _ws->get(toErase->second);
-                _memUsage -= member->getMemUsage();
-
-                _ws->free(toErase->second);
-                _dataMap.erase(toErase);
-            } else {
-                ++it;
-            }
-        }
-
-        _specificStats.mapAfterChild.push_back(_dataMap.size());
+        // Keep the RecordIds that this child also output.
+        _intersection.intersectWith(_currentChildIds);
+        _currentChildIds.clear();
+        _memUsage = _intersection.getMemUsage();
 
-        _seenMap.clear();
+        _specificStats.mapAfterChild.push_back(_intersection.size());
 
-        // _dataMap is now the intersection of the first _currentChild nodes.
+        // _intersection is now the intersection of the first _currentChild nodes.
 
         // If we have nothing to AND with after finishing any child, stop.
-        if (_dataMap.empty()) {
+        if (_intersection.empty()) {
             _hashingChildren = false;
             return PlanStage::IS_EOF;
         }
@@ -439,30 +405,26 @@ void AndHashStage::doInvalidate(OperationContext* opCtx,
     // If it's a mutation the predicates implied by the AND-ing may no longer be true.
     //
     // So, we flag and try to pick it up later.
-    DataMap::iterator it = _dataMap.find(dl);
-    if (_dataMap.end() != it) {
-        WorkingSetID id = it->second;
-        WorkingSetMember* member = _ws->get(id);
-        verify(member->recordId == dl);
-
+    _currentChildIds.erase(dl);
+    if (_intersection.erase(dl)) {
         if (_hashingChildren) {
             ++_specificStats.flaggedInProgress;
         } else {
             ++_specificStats.flaggedButPassed;
         }
 
-        // Update memory stats.
-        _memUsage -= member->getMemUsage();
-
-        // The RecordId is about to be invalidated.  Fetch it and clear the RecordId.
-        WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+        // The RecordId is about to be invalidated.  Fetch the document into a new WSM, which
+        // carries no RecordId.
+        WorkingSetID id = _ws->allocate();
+        WorkingSetMember* member = _ws->get(id);
+        member->obj = _collection->docFor(opCtx, dl);
+        member->obj.setValue(member->obj.value().getOwned());
+        member->transitionToOwnedObj();
 
         // Add the WSID to the to-be-reviewed list in the WS.
         _ws->flagForReview(id);
-
-        // And don't return it from this stage.
-        _dataMap.erase(it);
     }
+    _memUsage = _intersection.getMemUsage() + _currentChildIds.getMemUsage();
 }
 
 unique_ptr<PlanStageStats> AndHashStage::getStats() {
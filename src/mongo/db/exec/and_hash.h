@@ -31,22 +31,24 @@
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bitmap.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
-#include "mongo/platform/unordered_map.h"
-#include "mongo/platform/unordered_set.h"
 
 namespace mongo {
 
 /**
- * Reads from N children, each of which must have a valid RecordId.  Uses a hash table to
- * intersect the outputs of the N children, and outputs the intersection.
+ * Reads from N children, each of which must have a valid RecordId, and outputs the intersection.
+ * The RecordIds of the first N-1 children are collected into compressed bitmaps which are ANDed
+ * together; the WorkingSetMembers of those children are freed as soon as they are read.  The
+ * last child is then streamed, and its results whose RecordId is in the intersection are output
+ * as they are.  Only the last child's data is therefore carried by the output.
  *
  * Preconditions: Valid RecordId.  More than one child.
  *
- * Any RecordId that we keep a reference to that is invalidated before we are able to return it
- * is fetched and added to the WorkingSet as "flagged for further review."  Because this stage
+ * Any RecordId in the intersection that is invalidated before we are able to return it is
+ * fetched and added to the WorkingSet as "flagged for further review."  Because this stage
  * operates with RecordIds, we are unable to evaluate the AND for the invalidated RecordId, and it
  * must be fully matched later.
  */
@@ -103,15 +105,13 @@ private:
     // we place that result here.
     std::vector<WorkingSetID> _lookAheadResults;
 
-    // _dataMap is filled out by the first child and probed by subsequent children.  This is the
-    // hash table that we create by intersecting _children and probe with the last child.
-    typedef unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
-    DataMap _dataMap;
+    // The RecordIds output by every child read so far.  Filled out by the first child,
+    // intersected with each subsequent child but the last, and probed by the last child.
+    RecordIdBitmap _intersection;
 
-    // Keeps track of what elements from _dataMap subsequent children have seen.
+    // The RecordIds output so far by the child currently being read, other than the first.
     // Only used while _hashingChildren.
-    typedef unordered_set<RecordId, RecordId::Hasher> SeenMap;
-    SeenMap _seenMap;
+    RecordIdBitmap _currentChildIds;
 
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
@@ -123,7 +123,7 @@ private:
     AndHashStats _specificStats;
 
     // The usage in bytes of all buffered data that we're holding.
-    // Memory usage is calculated from keys held in _dataMap only.
+    // Memory usage is calculated from the bitmaps only.
     // For simplicity, results in _lookAheadResults do not count towards the limit.
     size_t _memUsage;
 
@@ -30,6 +30,8 @@
 
 #include "mongo/db/exec/fetch.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/filter.h"
@@ -53,13 +55,20 @@ FetchStage::FetchStage(OperationContext* opCtx,
                        WorkingSet* ws,
                        PlanStage* child,
                        const MatchExpression* filter,
-                       const Collection* collection)
+                       const Collection* collection,
+                       size_t batchSize,
+                       bool sortBatches)
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _ws(ws),
       _filter(filter),
-      _idRetrying(WorkingSet::INVALID_ID) {
+      _idRetrying(WorkingSet::INVALID_ID),
+      _batchSize(std::max(batchSize, size_t(1))),
+      _sortBatches(sortBatches) {
     _children.emplace_back(child);
+    if (_filter) {
+        _compiledFilter = stdx::make_unique<CompiledMatchExpression>(_filter);
+    }
 }
 
 FetchStage::~FetchStage() {}
@@ -71,6 +80,11 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    if (_batchPos < _batch.size()) {
+        // There are buffered results left to fetch.
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -80,10 +94,10 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     }
 
     // Either retry the last WSM we worked on or get a new one from our child.
-    WorkingSetID id;
+    WorkingSetID id = WorkingSet::INVALID_ID;
     StageState status;
     if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
+        status = _batchSize > 1 ? fillBatch(&id) : child()->work(&id);
     } else {
         status = ADVANCED;
         id = _idRetrying;
@@ -150,6 +164,52 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::fillBatch(WorkingSetID* out) {
+    if (_batchReady) {
+        if (_batchPos < _batch.size()) {
+            *out = _batch[_batchPos++];
+            return PlanStage::ADVANCED;
+        }
+
+        // The previous batch has been returned, start a new one.
+        _batch.clear();
+        _batchPos = 0;
+        _batchReady = false;
+    }
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->work(&id);
+    if (PlanStage::ADVANCED == status) {
+        // Buffered members may be held across yields.
+        _ws->get(id)->makeObjOwnedIfNeeded();
+        _batch.push_back(id);
+        if (_batch.size() < _batchSize) {
+            return PlanStage::NEED_TIME;
+        }
+    } else if (PlanStage::IS_EOF != status || _batch.empty()) {
+        *out = id;
+        return status;
+    }
+
+    // The batch is complete, either because it is full or because the child is done.
+    if (_sortBatches) {
+        // Members that lost their RecordId to an invalidation already hold an owned object and
+        // can go first.
+        auto recordIdOf = [this](WorkingSetID memberId) {
+            WorkingSetMember* member = _ws->get(memberId);
+            return member->hasRecordId() ? member->recordId : RecordId();
+        };
+        std::stable_sort(_batch.begin(), _batch.end(), [&](WorkingSetID lhs, WorkingSetID rhs) {
+            return recordIdOf(lhs) < recordIdOf(rhs);
+        });
+    }
+
+    ++_specificStats.batches;
+    _batchReady = true;
+    *out = _batch[_batchPos++];
+    return PlanStage::ADVANCED;
+}
+
 void FetchStage::doSaveState() {
     if (_cursor)
         _cursor->saveUnpositioned();
@@ -180,6 +240,14 @@ void FetchStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inval
             WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
         }
     }
+
+    // The same applies to buffered members that have not been returned yet.
+    for (size_t i = _batchPos; i < _batch.size(); ++i) {
+        WorkingSetMember* member = _ws->get(_batch[i]);
+        if (member->hasRecordId() && (member->recordId == dl)) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+        }
+    }
 }
 
 PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
@@ -201,7 +269,10 @@ PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
     // predicate.
     ++_specificStats.docsExamined;
 
-    if (Filter::passes(member, _filter)) {
+    const bool passes = _compiledFilter && member->hasObj()
+        ? _compiledFilter->matchesBSON(member->obj.value())
+        : Filter::passes(member, _filter);
+    if (passes) {
         *out = memberID;
         return PlanStage::ADVANCED;
     } else {
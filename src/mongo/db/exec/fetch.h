@@ -29,9 +29,11 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 
@@ -45,6 +47,11 @@ class SeekableRecordCursor;
  * In WorkingSetMember terms, it transitions from RID_AND_IDX to RID_AND_OBJ by reading
  * the record at the provided RecordId.  Returns verbatim any data that already has an object.
  *
+ * If 'batchSize' is greater than one, up to that many results of the child are buffered before
+ * any of them is fetched. When 'sortBatches' is true the caller does not depend on the order of
+ * the child's results, and each batch is fetched in RecordId order so that the record store is
+ * read in a single forward pass instead of one random seek per result.
+ *
  * Preconditions: Valid RecordId.
  */
 class FetchStage : public PlanStage {
@@ -53,7 +60,9 @@ public:
                WorkingSet* ws,
                PlanStage* child,
                const MatchExpression* filter,
-               const Collection* collection);
+               const Collection* collection,
+               size_t batchSize = 1,
+               bool sortBatches = false);
 
     ~FetchStage();
 
@@ -83,6 +92,13 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Works the child once, adding its result to '_batch' if it advanced. Returns NEED_TIME while
+     * the batch is being filled, ADVANCED with the first member of the batch in *out once it is
+     * complete, and the child's state otherwise.
+     */
+    StageState fillBatch(WorkingSetID* out);
+
     // Collection which is used by this stage. Used to resolve record ids retrieved by child
     // stages. The lifetime of the collection must supersede that of the stage.
     const Collection* _collection;
@@ -95,9 +111,23 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // '_filter' compiled for evaluation against fetched documents. Null if there is no filter.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // Maximum number of child results buffered in '_batch', and whether a batch may be reordered
+    // by RecordId before it is fetched.
+    const size_t _batchSize;
+    const bool _sortBatches;
+
+    // Results of the child waiting to be fetched. Members before '_batchPos' have already been
+    // returned or freed. '_batchReady' is false while the batch is still being filled.
+    std::vector<WorkingSetID> _batch;
+    size_t _batchPos = 0;
+    bool _batchReady = false;
+
     // Stats
     FetchStats _specificStats;
 };
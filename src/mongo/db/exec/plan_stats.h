@@ -340,7 +340,7 @@ struct EnsureSortedStats : public SpecificStats {
 };
 
 struct FetchStats : public SpecificStats {
-    FetchStats() : alreadyHasObj(0), forcedFetches(0), docsExamined(0) {}
+    FetchStats() : alreadyHasObj(0), forcedFetches(0), docsExamined(0), batches(0) {}
 
     SpecificStats* clone() const final {
         FetchStats* specific = new FetchStats(*this);
@@ -355,6 +355,10 @@ struct FetchStats : public SpecificStats {
 
     // The total number of full documents touched by the fetch stage.
     size_t docsExamined;
+
+    // The number of batches of child results buffered before fetching. Zero unless the stage
+    // fetches in batches.
+    size_t batches;
 };
 
 struct GroupStats : public SpecificStats {
@@ -0,0 +1,258 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+namespace {
+
+uint64_t highBits(const RecordId& id) {
+    return static_cast<uint64_t>(id.repr()) >> 16;
+}
+
+uint16_t lowBits(const RecordId& id) {
+    return static_cast<uint16_t>(static_cast<uint64_t>(id.repr()) & 0xFFFF);
+}
+
+bool testBit(const std::vector<uint64_t>& words, uint16_t low) {
+    return words[low / 64] & (1ULL << (low % 64));
+}
+
+}  // namespace
+
+//
+// RecordIdBitmap::Chunk
+//
+
+bool RecordIdBitmap::Chunk::insert(uint16_t low) {
+    if (_isBitmap()) {
+        uint64_t& word = _words[low / 64];
+        const uint64_t bit = 1ULL << (low % 64);
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+        ++_size;
+        return true;
+    }
+
+    auto it = std::lower_bound(_array.begin(), _array.end(), low);
+    if (it != _array.end() && *it == low) {
+        return false;
+    }
+    if (_array.size() < kMaxArraySize) {
+        _array.insert(it, low);
+        ++_size;
+        return true;
+    }
+    _convertToBitmap();
+    return insert(low);
+}
+
+bool RecordIdBitmap::Chunk::contains(uint16_t low) const {
+    if (_isBitmap()) {
+        return testBit(_words, low);
+    }
+    return std::binary_search(_array.begin(), _array.end(), low);
+}
+
+bool RecordIdBitmap::Chunk::erase(uint16_t low) {
+    if (_isBitmap()) {
+        uint64_t& word = _words[low / 64];
+        const uint64_t bit = 1ULL << (low % 64);
+        if (!(word & bit)) {
+            return false;
+        }
+        word &= ~bit;
+        --_size;
+        return true;
+    }
+
+    auto it = std::lower_bound(_array.begin(), _array.end(), low);
+    if (it == _array.end() || *it != low) {
+        return false;
+    }
+    _array.erase(it);
+    --_size;
+    return true;
+}
+
+void RecordIdBitmap::Chunk::intersectWith(const Chunk& other) {
+    if (_isBitmap() && other._isBitmap()) {
+        for (size_t i = 0; i < kNumWords; ++i) {
+            _words[i] &= other._words[i];
+        }
+        _recount();
+        _convertToArrayIfSparse();
+        return;
+    }
+
+    if (_isBitmap()) {
+        // The result can be no larger than 'other', so it is kept as an array.
+        _array.clear();
+        std::copy_if(other._array.begin(),
+                     other._array.end(),
+                     std::back_inserter(_array),
+                     [this](uint16_t low) { return testBit(_words, low); });
+        std::vector<uint64_t>().swap(_words);
+        _size = _array.size();
+        return;
+    }
+
+    _array.erase(std::remove_if(_array.begin(),
+                                _array.end(),
+                                [&other](uint16_t low) { return !other.contains(low); }),
+                 _array.end());
+    _size = _array.size();
+}
+
+size_t RecordIdBitmap::Chunk::getMemUsage() const {
+    return sizeof(*this) + _array.capacity() * sizeof(uint16_t) +
+        _words.capacity() * sizeof(uint64_t);
+}
+
+void RecordIdBitmap::Chunk::_convertToBitmap() {
+    _words.assign(kNumWords, 0);
+    for (uint16_t low : _array) {
+        _words[low / 64] |= 1ULL << (low % 64);
+    }
+    std::vector<uint16_t>().swap(_array);
+}
+
+void RecordIdBitmap::Chunk::_convertToArrayIfSparse() {
+    if (_size > kMaxArraySize) {
+        return;
+    }
+    _array.clear();
+    _array.reserve(_size);
+    for (size_t i = 0; i < kNumWords; ++i) {
+        uint64_t word = _words[i];
+        while (word) {
+            const int bit = countTrailingZeros64(word);
+            _array.push_back(static_cast<uint16_t>(i * 64 + bit));
+            word &= word - 1;
+        }
+    }
+    std::vector<uint64_t>().swap(_words);
+}
+
+void RecordIdBitmap::Chunk::_recount() {
+    size_t size = 0;
+    for (size_t i = 0; i < kNumWords; ++i) {
+        size += countBits64(_words[i]);
+    }
+    _size = size;
+}
+
+//
+// RecordIdBitmap
+//
+
+bool RecordIdBitmap::insert(const RecordId& id) {
+    auto it = _chunks.find(highBits(id));
+    if (it == _chunks.end()) {
+        it = _chunks.emplace(highBits(id), Chunk()).first;
+        _chunksMemUsage += kChunkNodeOverhead + it->second.getMemUsage();
+    }
+
+    const size_t chunkMemUsage = it->second.getMemUsage();
+    if (!it->second.insert(lowBits(id))) {
+        return false;
+    }
+    _chunksMemUsage = _chunksMemUsage - chunkMemUsage + it->second.getMemUsage();
+    ++_size;
+    return true;
+}
+
+bool RecordIdBitmap::contains(const RecordId& id) const {
+    auto it = _chunks.find(highBits(id));
+    return it != _chunks.end() && it->second.contains(lowBits(id));
+}
+
+bool RecordIdBitmap::erase(const RecordId& id) {
+    auto it = _chunks.find(highBits(id));
+    if (it == _chunks.end()) {
+        return false;
+    }
+
+    const size_t chunkMemUsage = it->second.getMemUsage();
+    if (!it->second.erase(lowBits(id))) {
+        return false;
+    }
+    if (it->second.size() == 0) {
+        _chunksMemUsage -= kChunkNodeOverhead + chunkMemUsage;
+        _chunks.erase(it);
+    } else {
+        _chunksMemUsage = _chunksMemUsage - chunkMemUsage + it->second.getMemUsage();
+    }
+    --_size;
+    return true;
+}
+
+void RecordIdBitmap::intersectWith(const RecordIdBitmap& other) {
+    auto otherIt = other._chunks.begin();
+    auto it = _chunks.begin();
+    _size = 0;
+    while (it != _chunks.end()) {
+        while (otherIt != other._chunks.end() && otherIt->first < it->first) {
+            ++otherIt;
+        }
+
+        const size_t chunkMemUsage = it->second.getMemUsage();
+        if (otherIt == other._chunks.end() || otherIt->first != it->first) {
+            _chunksMemUsage -= kChunkNodeOverhead + chunkMemUsage;
+            it = _chunks.erase(it);
+            continue;
+        }
+        it->second.intersectWith(otherIt->second);
+        if (it->second.size() == 0) {
+            _chunksMemUsage -= kChunkNodeOverhead + chunkMemUsage;
+            it = _chunks.erase(it);
+            continue;
+        }
+        _chunksMemUsage = _chunksMemUsage - chunkMemUsage + it->second.getMemUsage();
+        _size += it->second.size();
+        ++it;
+    }
+}
+
+void RecordIdBitmap::clear() {
+    _chunks.clear();
+    _size = 0;
+    _chunksMemUsage = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A compressed set of RecordIds, laid out like a roaring bitmap. RecordIds are grouped into chunks
+ * by all but their low 16 bits, and each chunk stores those low bits either as a sorted array
+ * while it holds at most kMaxArraySize ids, or as a 65536-bit bitmap once it holds more. A sparse
+ * chunk costs two bytes per id and a dense one at most eight kilobytes, so the ids produced by an
+ * index scan take a small fraction of the memory of a hash set of RecordIds.
+ *
+ * Intersections of dense chunks are computed a 64-bit word at a time, in a loop simple enough for
+ * the compiler to vectorize. Memory usage is tracked as chunks change, so it is cheap to query
+ * after every insertion.
+ */
+class RecordIdBitmap {
+public:
+    static const size_t kMaxArraySize = 4096;
+
+    /**
+     * Adds 'id' to the set. Returns false if it was already present.
+     */
+    bool insert(const RecordId& id);
+
+    bool contains(const RecordId& id) const;
+
+    /**
+     * Removes 'id' from the set. Returns false if it was not present.
+     */
+    bool erase(const RecordId& id);
+
+    /**
+     * Removes the ids that are not also in 'other'.
+     */
+    void intersectWith(const RecordIdBitmap& other);
+
+    void clear();
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Returns the approximate number of bytes held by the set.
+     */
+    size_t getMemUsage() const {
+        return sizeof(*this) + _chunksMemUsage;
+    }
+
+private:
+    /**
+     * The low 16 bits of the ids sharing the same high bits.
+     */
+    class Chunk {
+    public:
+        bool insert(uint16_t low);
+        bool contains(uint16_t low) const;
+        bool erase(uint16_t low);
+        void intersectWith(const Chunk& other);
+
+        size_t size() const {
+            return _size;
+        }
+
+        size_t getMemUsage() const;
+
+    private:
+        static const size_t kNumWords = (1 << 16) / 64;
+
+        bool _isBitmap() const {
+            return !_words.empty();
+        }
+
+        void _convertToBitmap();
+        void _convertToArrayIfSparse();
+        void _recount();
+
+        // Sorted low bits, used while the chunk is sparse.
+        std::vector<uint16_t> _array;
+
+        // One bit per possible low value, used once the chunk is dense.
+        std::vector<uint64_t> _words;
+
+        size_t _size = 0;
+    };
+
+    // Each map node also holds its key and a few pointers.
+    static const size_t kChunkNodeOverhead = sizeof(uint64_t) + 4 * sizeof(void*);
+
+    std::map<uint64_t, Chunk> _chunks;
+    size_t _size = 0;
+
+    // The bytes held by '_chunks', including the overhead of each map node.
+    size_t _chunksMemUsage = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for mongo/db/exec/record_id_bitmap.cpp
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <set>
+
+#include "mongo/unittest/unittest.h"
+
+using namespace mongo;
+
+namespace {
+
+TEST(RecordIdBitmapTest, InsertContainsErase) {
+    RecordIdBitmap bitmap;
+    ASSERT(bitmap.empty());
+
+    ASSERT(bitmap.insert(RecordId(1)));
+    ASSERT(bitmap.insert(RecordId(70000)));
+    ASSERT(!bitmap.insert(RecordId(1)));
+    ASSERT_EQ(2U, bitmap.size());
+
+    ASSERT(bitmap.contains(RecordId(1)));
+    ASSERT(bitmap.contains(RecordId(70000)));
+    ASSERT(!bitmap.contains(RecordId(2)));
+    ASSERT(!bitmap.contains(RecordId(70000 + (1 << 16))));
+
+    ASSERT(bitmap.erase(RecordId(1)));
+    ASSERT(!bitmap.erase(RecordId(1)));
+    ASSERT(!bitmap.contains(RecordId(1)));
+    ASSERT_EQ(1U, bitmap.size());
+
+    bitmap.clear();
+    ASSERT(bitmap.empty());
+    ASSERT(!bitmap.contains(RecordId(70000)));
+}
+
+TEST(RecordIdBitmapTest, LargeAndNegativeRecordIds) {
+    RecordIdBitmap bitmap;
+    ASSERT(bitmap.insert(RecordId::max()));
+    ASSERT(bitmap.insert(RecordId(-5)));
+    ASSERT(bitmap.contains(RecordId::max()));
+    ASSERT(bitmap.contains(RecordId(-5)));
+    ASSERT(!bitmap.contains(RecordId(5)));
+}
+
+TEST(RecordIdBitmapTest, DenseChunkBehavesLikeSparseChunk) {
+    RecordIdBitmap bitmap;
+    for (int i = 0; i < 3 * int(RecordIdBitmap::kMaxArraySize); ++i) {
+        ASSERT(bitmap.insert(RecordId(2 * i)));
+    }
+    ASSERT_EQ(3 * RecordIdBitmap::kMaxArraySize, bitmap.size());
+    for (int i = 0; i < 3 * int(RecordIdBitmap::kMaxArraySize); ++i) {
+        ASSERT(bitmap.contains(RecordId(2 * i)));
+        ASSERT(!bitmap.contains(RecordId(2 * i + 1)));
+    }
+    ASSERT(bitmap.erase(RecordId(4)));
+    ASSERT(!bitmap.contains(RecordId(4)));
+    ASSERT_EQ(3 * RecordIdBitmap::kMaxArraySize - 1, bitmap.size());
+}
+
+TEST(RecordIdBitmapTest, DenseIdsUseLessMemoryThanSparseArrays) {
+    RecordIdBitmap bitmap;
+    for (int i = 0; i < (1 << 16); ++i) {
+        bitmap.insert(RecordId(i));
+    }
+    // A full chunk is a single 8KB bitmap.
+    ASSERT_LT(bitmap.getMemUsage(), 9U * 1024);
+}
+
+TEST(RecordIdBitmapTest, MemUsageIsReleasedWithChunks) {
+    RecordIdBitmap bitmap;
+    const size_t emptyMemUsage = bitmap.getMemUsage();
+
+    // Sparse chunks spread over many high bits, as with MMAPv1 RecordIds.
+    for (long long i = 0; i < 100; ++i) {
+        ASSERT(bitmap.insert(RecordId(i << 20)));
+    }
+    const size_t sparseMemUsage = bitmap.getMemUsage();
+    ASSERT_GT(sparseMemUsage, emptyMemUsage);
+
+    // A dense chunk holds an 8KB bitmap.
+    for (int i = 1; i <= int(RecordIdBitmap::kMaxArraySize) + 1; ++i) {
+        ASSERT(bitmap.insert(RecordId(i)));
+    }
+    ASSERT_GT(bitmap.getMemUsage(), sparseMemUsage + 4 * 1024);
+
+    // Intersecting drops the chunks missing from the other set.
+    RecordIdBitmap other;
+    ASSERT(other.insert(RecordId(1)));
+    bitmap.intersectWith(other);
+    ASSERT_EQ(1U, bitmap.size());
+    ASSERT_LT(bitmap.getMemUsage(), sparseMemUsage);
+
+    ASSERT(bitmap.erase(RecordId(1)));
+    ASSERT_EQ(emptyMemUsage, bitmap.getMemUsage());
+
+    ASSERT(bitmap.insert(RecordId(1)));
+    bitmap.clear();
+    ASSERT_EQ(emptyMemUsage, bitmap.getMemUsage());
+}
+
+// Checks intersections of every combination of sparse and dense chunks against std::set.
+TEST(RecordIdBitmapTest, IntersectMatchesSetIntersection) {
+    const long long kSparse = 3;
+    const long long kDense = 10000;
+    const std::vector<std::pair<long long, long long>> shapes{
+        {kSparse, 97}, {kDense, 3}, {kDense, 5}, {kSparse, 89}};
+
+    for (const auto& lhsShape : shapes) {
+        for (const auto& rhsShape : shapes) {
+            RecordIdBitmap lhs, rhs;
+            std::set<long long> lhsSet, rhsSet;
+            for (long long i = 0; i < lhsShape.first; ++i) {
+                lhs.insert(RecordId(i * lhsShape.second));
+                lhsSet.insert(i * lhsShape.second);
+            }
+            for (long long i = 0; i < rhsShape.first; ++i) {
+                rhs.insert(RecordId(i * rhsShape.second));
+                rhsSet.insert(i * rhsShape.second);
+            }
+
+            RecordIdBitmap intersection = lhs;
+            intersection.intersectWith(rhs);
+
+            size_t expectedIntersection = 0;
+            for (long long id : lhsSet) {
+                expectedIntersection += rhsSet.count(id);
+            }
+            ASSERT_EQ(expectedIntersection, intersection.size());
+
+            for (long long id = 0; id < 100000; ++id) {
+                const bool inLhs = lhsSet.count(id);
+                const bool inRhs = rhsSet.count(id);
+                ASSERT_EQ(inLhs && inRhs, intersection.contains(RecordId(id)));
+            }
+        }
+    }
+}
+
+}  // namespace
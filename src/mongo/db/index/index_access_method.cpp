@@ -47,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
 
@@ -107,6 +108,50 @@ private:
     const IndexVersion _version;
 };
 
+class KeyStringExternalSortComparison {
+public:
+    typedef std::pair<KeyStringSortKey, RecordId> Data;
+
+    int operator()(const Data& l, const Data& r) const {
+        int x = l.first.compare(r.first);
+        if (x) {
+            return x;
+        }
+        return l.second.compare(r.second);
+    }
+};
+
+namespace {
+
+// KeyString V1 orders keys as BSONObj::woCompare() does, whatever the index's KeyString version.
+const auto kSortKeyStringVersion = KeyString::Version::V1;
+
+/**
+ * Presents the keys of a KeyString sorter as BSON, so that they can be merged with the keys of a
+ * BSON sorter and added to the index.
+ */
+class KeyStringToBSONIterator final : public SortIteratorInterface<BSONObj, RecordId> {
+public:
+    KeyStringToBSONIterator(std::unique_ptr<SortIteratorInterface<KeyStringSortKey, RecordId>> it,
+                            Ordering ordering)
+        : _it(std::move(it)), _ordering(ordering) {}
+
+    bool more() override {
+        return _it->more();
+    }
+
+    Data next() override {
+        auto data = _it->next();
+        return Data(data.first.toBson(kSortKeyStringVersion, _ordering), data.second);
+    }
+
+private:
+    const std::unique_ptr<SortIteratorInterface<KeyStringSortKey, RecordId>> _it;
+    const Ordering _ordering;
+};
+
+}  // namespace
+
 IndexAccessMethod::IndexAccessMethod(IndexCatalogEntry* btreeState, SortedDataInterface* btree)
     : _btreeState(btreeState), _descriptor(btreeState->descriptor()), _newInterface(btree) {
     verify(IndexDescriptor::isIndexVersionSupported(_descriptor->version()));
@@ -405,48 +450,142 @@ Status IndexAccessMethod::compact(OperationContext* opCtx) {
 }
 
 std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
-    size_t maxMemoryUsageBytes) {
-    return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, _descriptor, maxMemoryUsageBytes));
+    size_t maxMemoryUsageBytes, size_t numRuns) {
+    return std::unique_ptr<BulkBuilder>(
+        new BulkBuilder(this, _descriptor, maxMemoryUsageBytes, numRuns));
+}
+
+namespace {
+
+/**
+ * Adds the multikey path components in 'paths' to those accumulated in 'accumulatedPaths'.
+ */
+void mergeMultikeyPaths(const MultikeyPaths& paths, MultikeyPaths* accumulatedPaths) {
+    if (paths.empty()) {
+        return;
+    }
+    if (accumulatedPaths->empty()) {
+        *accumulatedPaths = paths;
+        return;
+    }
+    invariant(accumulatedPaths->size() == paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        (*accumulatedPaths)[i].insert(paths[i].begin(), paths[i].end());
+    }
+}
+
+/**
+ * Merges the sorted streams in 'iterators' into one, without a merge step if there is only one.
+ */
+template <typename Iterator, typename Comparator>
+std::unique_ptr<Iterator> mergeIterators(std::vector<std::unique_ptr<Iterator>> iterators,
+                                         const SortOptions& opts,
+                                         const Comparator& comp) {
+    if (iterators.size() == 1) {
+        return std::move(iterators[0]);
+    }
+
+    std::vector<std::shared_ptr<Iterator>> sharedIterators;
+    for (auto&& it : iterators) {
+        sharedIterators.emplace_back(std::move(it));
+    }
+    return std::unique_ptr<Iterator>(Iterator::merge(sharedIterators, opts, comp));
 }
 
+// When keys are sorted as KeyStrings, the BSON sorter of a run only holds the rare keys that can't
+// be encoded, and gets this fraction of the run's memory budget.
+const size_t kSorterMemoryShareDivisor = 16;
+
+}  // namespace
+
 IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
                                             const IndexDescriptor* descriptor,
-                                            size_t maxMemoryUsageBytes)
-    : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
-          BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+                                            size_t maxMemoryUsageBytes,
+                                            size_t numRuns)
+    : _runs(std::max(numRuns, size_t(1))),
+      _real(index),
+      _descriptor(descriptor),
+      _ordering(Ordering::make(descriptor->keyPattern())),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes) {
+    const size_t runMemoryUsageBytes = maxMemoryUsageBytes / _runs.size();
+    if (descriptor->version() == IndexVersion::kV0) {
+        _sorterMemoryUsageBytes = runMemoryUsageBytes;
+    } else {
+        _sorterMemoryUsageBytes = runMemoryUsageBytes / kSorterMemoryShareDivisor;
+        _keyStringSorterMemoryUsageBytes = runMemoryUsageBytes - _sorterMemoryUsageBytes;
+    }
+
+    for (auto&& run : _runs) {
+        if (descriptor->version() == IndexVersion::kV0) {
+            getOrCreateSorter(&run);
+        } else {
+            run.keyStringSorter.reset(KeyStringSorter::make(
+                makeSortOptions(_keyStringSorterMemoryUsageBytes).PrefixCompressSpills(),
+                KeyStringExternalSortComparison()));
+        }
+    }
+}
+
+IndexAccessMethod::BulkBuilder::Sorter* IndexAccessMethod::BulkBuilder::getOrCreateSorter(
+    SortedRun* run) {
+    if (!run->sorter) {
+        run->sorter.reset(Sorter::make(
+            makeSortOptions(_sorterMemoryUsageBytes),
+            BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version())));
+    }
+    return run->sorter.get();
+}
+
+SortOptions IndexAccessMethod::BulkBuilder::makeSortOptions(size_t maxMemoryUsageBytes) const {
+    return SortOptions()
+        .TempDir(storageGlobalParams.dbpath + "/_tmp")
+        .ExtSortAllowed()
+        .MaxMemoryUsageBytes(maxMemoryUsageBytes);
+}
 
 Status IndexAccessMethod::BulkBuilder::insert(OperationContext* opCtx,
                                               const BSONObj& obj,
                                               const RecordId& loc,
                                               const InsertDeleteOptions& options,
                                               int64_t* numInserted) {
+    return insertIntoRun(0, obj, loc, options, numInserted);
+}
+
+Status IndexAccessMethod::BulkBuilder::insertIntoRun(size_t runNumber,
+                                                     const BSONObj& obj,
+                                                     const RecordId& loc,
+                                                     const InsertDeleteOptions& options,
+                                                     int64_t* numInserted) {
+    invariant(runNumber < _runs.size());
+    SortedRun& run = _runs[runNumber];
+
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
 
     _real->getKeys(obj, options.getKeysMode, &keys, &multikeyPaths);
 
-    _everGeneratedMultipleKeys = _everGeneratedMultipleKeys || (keys.size() > 1);
-
-    if (!multikeyPaths.empty()) {
-        if (_indexMultikeyPaths.empty()) {
-            _indexMultikeyPaths = multikeyPaths;
-        } else {
-            invariant(_indexMultikeyPaths.size() == multikeyPaths.size());
-            for (size_t i = 0; i < multikeyPaths.size(); ++i) {
-                _indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
-            }
+    run.everGeneratedMultipleKeys = run.everGeneratedMultipleKeys || (keys.size() > 1);
+    mergeMultikeyPaths(multikeyPaths, &run.indexMultikeyPaths);
+
+    size_t numEncoded = 0;
+    if (run.keyStringSorter) {
+        std::vector<KeyStringSortKey> encodedKeys;
+        encodedKeys.reserve(keys.size());
+        numEncoded = KeyStringSortKey::encodeBatch(
+            kSortKeyStringVersion, keys.begin(), keys.end(), _ordering, &encodedKeys);
+        for (auto&& key : encodedKeys) {
+            run.keyStringSorter->add(key, loc);
         }
     }
 
-    for (BSONObjSet::iterator it = keys.begin(); it != keys.end(); ++it) {
-        _sorter->add(*it, loc);
-        _keysInserted++;
+    if (numEncoded < keys.size()) {
+        for (BSONObjSet::iterator it = keys.begin(); it != keys.end(); ++it) {
+            if (!run.keyStringSorter || !KeyStringSortKey::canEncode(*it)) {
+                getOrCreateSorter(&run)->add(*it, loc);
+            }
+        }
     }
+    run.keysInserted += keys.size();
 
     if (NULL != numInserted) {
         *numInserted += keys.size();
@@ -456,6 +595,39 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* opCtx,
 }
 
 
+std::unique_ptr<IndexAccessMethod::BulkBuilder::Sorter::Iterator>
+IndexAccessMethod::BulkBuilder::done() {
+    const SortOptions mergeOptions = makeSortOptions(_maxMemoryUsageBytes);
+
+    std::vector<std::unique_ptr<KeyStringSorter::Iterator>> keyStringIterators;
+    std::vector<std::unique_ptr<Sorter::Iterator>> iterators;
+    for (auto&& run : _runs) {
+        if (run.keyStringSorter) {
+            keyStringIterators.emplace_back(run.keyStringSorter->done());
+        }
+
+        // When keys are sorted as KeyStrings, the BSON sorter only exists if some key was too large
+        // to encode.
+        if (run.sorter) {
+            iterators.emplace_back(run.sorter->done());
+        }
+    }
+
+    // The KeyString keys are merged with memcmp() comparisons, and only converted back to BSON
+    // for the bulk loader and for merging with the keys of the BSON sorters.
+    if (!keyStringIterators.empty()) {
+        iterators.push_back(stdx::make_unique<KeyStringToBSONIterator>(
+            mergeIterators(
+                std::move(keyStringIterators), mergeOptions, KeyStringExternalSortComparison()),
+            _ordering));
+    }
+
+    return mergeIterators(
+        std::move(iterators),
+        mergeOptions,
+        BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version()));
+}
+
 Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
                                      std::unique_ptr<BulkBuilder> bulk,
                                      bool mayInterrupt,
@@ -463,12 +635,21 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
                                      set<RecordId>* dupsToDrop) {
     Timer timer;
 
-    std::unique_ptr<BulkBuilder::Sorter::Iterator> i(bulk->_sorter->done());
+    int64_t keysInserted = 0;
+    bool everGeneratedMultipleKeys = false;
+    MultikeyPaths indexMultikeyPaths;
+    for (auto&& run : bulk->_runs) {
+        keysInserted += run.keysInserted;
+        everGeneratedMultipleKeys = everGeneratedMultipleKeys || run.everGeneratedMultipleKeys;
+        mergeMultikeyPaths(run.indexMultikeyPaths, &indexMultikeyPaths);
+    }
+
+    std::unique_ptr<BulkBuilder::Sorter::Iterator> i = bulk->done();
 
     stdx::unique_lock<Client> lk(*opCtx->getClient());
     ProgressMeterHolder pm(*opCtx->setMessage_inlock("Index Bulk Build: (2/3) btree bottom up",
                                                      "Index: (2/3) BTree Bottom Up Progress",
-                                                     bulk->_keysInserted,
+                                                     keysInserted,
                                                      10));
     lk.unlock();
 
@@ -477,8 +658,8 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
     MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
         WriteUnitOfWork wunit(opCtx);
 
-        if (bulk->_everGeneratedMultipleKeys || isMultikeyFromPaths(bulk->_indexMultikeyPaths)) {
-            _btreeState->setMultikey(opCtx, bulk->_indexMultikeyPaths);
+        if (everGeneratedMultipleKeys || isMultikeyFromPaths(indexMultikeyPaths)) {
+            _btreeState->setMultikey(opCtx, indexMultikeyPaths);
         }
 
         builder.reset(_newInterface->getBulkBuilder(opCtx, dupsAllowed));
@@ -594,3 +775,6 @@ void IndexAccessMethod::getKeys(const BSONObj& obj,
 
 #include "mongo/db/sorter/sorter.cpp"
 MONGO_CREATE_SORTER(mongo::BSONObj, mongo::RecordId, mongo::BtreeExternalSortComparison);
+MONGO_CREATE_SORTER(mongo::KeyStringSortKey,
+                    mongo::RecordId,
+                    mongo::KeyStringExternalSortComparison);
@@ -38,6 +38,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/key_string_sort_key.h"
 #include "mongo/db/storage/sorted_data_interface.h"
 
 namespace mongo {
@@ -207,26 +208,77 @@ public:
                       const InsertDeleteOptions& options,
                       int64_t* numInserted);
 
+        /**
+         * Like insert(), but adds the keys of 'obj' to the sorted run numbered 'run', which must be
+         * less than numRuns(). Calls for different runs may be made concurrently from different
+         * threads, which lets a build generate and sort keys in parallel. Calls for the same run
+         * must be serialized.
+         */
+        Status insertIntoRun(size_t run,
+                             const BSONObj& obj,
+                             const RecordId& loc,
+                             const InsertDeleteOptions& options,
+                             int64_t* numInserted);
+
+        size_t numRuns() const {
+            return _runs.size();
+        }
+
     private:
         friend class IndexAccessMethod;
 
         using Sorter = mongo::Sorter<BSONObj, RecordId>;
+        using KeyStringSorter = mongo::Sorter<KeyStringSortKey, RecordId>;
+
+        /**
+         * Keys added through one run are sorted independently of the other runs. commitBulk()
+         * merges the runs into a single sorted stream.
+         *
+         * Except for v0 indexes, whose order KeyString doesn't reproduce, keys are sorted in
+         * KeyString form so that comparisons are memcmp()s. Keys too large for KeyString to
+         * encode their TypeBits go to the BSON sorter instead, which is then created on first
+         * use. The two sorters of a run share the run's memory budget.
+         */
+        struct SortedRun {
+            std::unique_ptr<KeyStringSorter> keyStringSorter;  // Null for v0 indexes.
+            std::unique_ptr<Sorter> sorter;                    // Null until a key needs it.
+            int64_t keysInserted = 0;
+
+            // Set to true if at least one document causes IndexAccessMethod::getKeys() to return
+            // a BSONObjSet with size strictly greater than one.
+            bool everGeneratedMultipleKeys = false;
+
+            // Holds the path components that cause this index to be multikey. The vector remains
+            // empty if this index doesn't support path-level multikey tracking.
+            MultikeyPaths indexMultikeyPaths;
+        };
 
         BulkBuilder(const IndexAccessMethod* index,
                     const IndexDescriptor* descriptor,
-                    size_t maxMemoryUsageBytes);
+                    size_t maxMemoryUsageBytes,
+                    size_t numRuns);
 
-        std::unique_ptr<Sorter> _sorter;
-        const IndexAccessMethod* _real;
-        int64_t _keysInserted = 0;
+        SortOptions makeSortOptions(size_t maxMemoryUsageBytes) const;
+
+        /**
+         * Returns the BSON sorter of 'run', creating it if needed.
+         */
+        Sorter* getOrCreateSorter(SortedRun* run);
 
-        // Set to true if at least one document causes IndexAccessMethod::getKeys() to return a
-        // BSONObjSet with size strictly greater than one.
-        bool _everGeneratedMultipleKeys = false;
+        /**
+         * Returns the keys of every run, merged into index order.
+         */
+        std::unique_ptr<Sorter::Iterator> done();
+
+        std::vector<SortedRun> _runs;
+        const IndexAccessMethod* _real;
+        const IndexDescriptor* _descriptor;
+        const Ordering _ordering;
+        const size_t _maxMemoryUsageBytes;
 
-        // Holds the path components that cause this index to be multikey. The '_indexMultikeyPaths'
-        // vector remains empty if this index doesn't support path-level multikey tracking.
-        MultikeyPaths _indexMultikeyPaths;
+        // The memory budgets of the KeyString and BSON sorters of each run.
+        size_t _keyStringSorterMemoryUsageBytes = 0;
+        size_t _sorterMemoryUsageBytes = 0;
     };
 
     /**
@@ -238,8 +290,10 @@ public:
      *
      * maxMemoryUsageBytes: amount of memory consumed before the external sorter starts spilling to
      *                      disk
+     * numRuns: number of sorted runs the keys may be split between, see
+     *          BulkBuilder::insertIntoRun(). The memory budget is shared between the runs.
      */
-    std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes);
+    std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes, size_t numRuns = 1);
 
     /**
      * Call this when you are ready to finish your bulk work.
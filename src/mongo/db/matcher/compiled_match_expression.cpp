@@ -0,0 +1,277 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+bool isResolvableLeaf(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::EXISTS:
+        case MatchExpression::MATCH_IN:
+        case MatchExpression::BITS_ALL_SET:
+        case MatchExpression::BITS_ALL_CLEAR:
+        case MatchExpression::BITS_ANY_SET:
+        case MatchExpression::BITS_ANY_CLEAR:
+            break;
+        default:
+            return false;
+    }
+
+    // Only a top-level field which is neither missing nor an array is matched by a single call to
+    // matchesSingleElement(), so dotted paths are left to the path traversal in path.cpp.
+    const StringData path = expr->path();
+    return !path.empty() && path.find('.') == std::string::npos;
+}
+
+template <typename T>
+int compareValues(T left, T right) {
+    return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+bool comparisonResult(MatchExpression::MatchType matchType, int cmp) {
+    switch (matchType) {
+        case MatchExpression::LT:
+            return cmp < 0;
+        case MatchExpression::LTE:
+            return cmp <= 0;
+        case MatchExpression::EQ:
+            return cmp == 0;
+        case MatchExpression::GT:
+            return cmp > 0;
+        case MatchExpression::GTE:
+            return cmp >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+// Children of a $and or $or are evaluated in increasing order of this rank.
+int evaluationRank(const MatchExpression* expr) {
+    if (expr->matchType() == MatchExpression::AND || expr->matchType() == MatchExpression::OR) {
+        return 2;
+    }
+    if (!isResolvableLeaf(expr)) {
+        return 3;
+    }
+    return ComparisonMatchExpression::isComparisonMatchExpression(expr) ? 0 : 1;
+}
+
+}  // namespace
+
+const size_t CompiledMatchExpression::kMaxResolvedFields;
+
+CompiledMatchExpression::CompiledMatchExpression(const MatchExpression* expr) {
+    emit(expr);
+}
+
+CompiledMatchExpression::OpCode CompiledMatchExpression::classify(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+            return OpCode::kAnd;
+        case MatchExpression::OR:
+            return OpCode::kOr;
+        default:
+            break;
+    }
+
+    if (!isResolvableLeaf(expr)) {
+        return OpCode::kExpression;
+    }
+
+    if (!ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+        return OpCode::kLeaf;
+    }
+
+    auto comparison = static_cast<const ComparisonMatchExpression*>(expr);
+    const BSONElement& rhs = comparison->getData();
+    switch (rhs.type()) {
+        case NumberInt:
+        case NumberLong:
+            return OpCode::kCompareLong;
+        case NumberDouble:
+            return std::isnan(rhs.numberDouble()) ? OpCode::kLeaf : OpCode::kCompareDouble;
+        case String:
+            return comparison->getCollator() ? OpCode::kLeaf : OpCode::kCompareString;
+        default:
+            return OpCode::kLeaf;
+    }
+}
+
+void CompiledMatchExpression::emit(const MatchExpression* expr) {
+    const size_t pc = _program.size();
+
+    Instruction instruction;
+    instruction.op = classify(expr);
+    instruction.expr = expr;
+
+    if (instruction.op == OpCode::kAnd || instruction.op == OpCode::kOr) {
+        _program.push_back(instruction);
+
+        std::vector<const MatchExpression*> children;
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            children.push_back(expr->getChild(i));
+        }
+        std::stable_sort(children.begin(),
+                         children.end(),
+                         [](const MatchExpression* left, const MatchExpression* right) {
+                             return evaluationRank(left) < evaluationRank(right);
+                         });
+        for (auto&& child : children) {
+            emit(child);
+        }
+
+        _program[pc].end = _program.size();
+        return;
+    }
+
+    if (instruction.op != OpCode::kExpression) {
+        const StringData path = expr->path();
+        auto it = std::find(_fieldNames.begin(), _fieldNames.end(), path);
+        if (it != _fieldNames.end()) {
+            instruction.field = it - _fieldNames.begin();
+        } else if (_fieldNames.size() < kMaxResolvedFields) {
+            instruction.field = _fieldNames.size();
+            _fieldNames.push_back(path.toString());
+        } else {
+            instruction.op = OpCode::kExpression;
+        }
+    }
+
+    if (instruction.op == OpCode::kCompareLong || instruction.op == OpCode::kCompareDouble ||
+        instruction.op == OpCode::kCompareString) {
+        const BSONElement& rhs = static_cast<const ComparisonMatchExpression*>(expr)->getData();
+        instruction.longValue = rhs.numberLong();
+        instruction.doubleValue = rhs.numberDouble();
+        if (rhs.type() == String) {
+            instruction.stringValue = rhs.valueStringData();
+        }
+    }
+
+    instruction.end = pc + 1;
+    _program.push_back(instruction);
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+    BSONElement fields[kMaxResolvedFields];
+
+    size_t remaining = _fieldNames.size();
+    BSONObjIterator it(doc);
+    while (remaining > 0 && it.more()) {
+        const BSONElement elem = it.next();
+        const StringData name = elem.fieldNameStringData();
+        for (size_t i = 0; i < _fieldNames.size(); ++i) {
+            // Like BSONObj::getField(), only the first occurrence of a field name is used.
+            if (fields[i].eoo() && name == _fieldNames[i]) {
+                fields[i] = elem;
+                --remaining;
+                break;
+            }
+        }
+    }
+
+    return evaluate(0, doc, fields);
+}
+
+bool CompiledMatchExpression::evaluate(size_t pc,
+                                       const BSONObj& doc,
+                                       const BSONElement* fields) const {
+    const Instruction& instruction = _program[pc];
+    switch (instruction.op) {
+        case OpCode::kAnd:
+            for (size_t child = pc + 1; child < instruction.end; child = _program[child].end) {
+                if (!evaluate(child, doc, fields)) {
+                    return false;
+                }
+            }
+            return true;
+        case OpCode::kOr:
+            for (size_t child = pc + 1; child < instruction.end; child = _program[child].end) {
+                if (evaluate(child, doc, fields)) {
+                    return true;
+                }
+            }
+            return false;
+        case OpCode::kExpression:
+            return instruction.expr->matchesBSON(doc);
+        default:
+            break;
+    }
+
+    const BSONElement& elem = fields[instruction.field];
+    if (elem.eoo() || elem.type() == Array) {
+        // Missing fields and arrays have their own matching semantics, which the path traversal
+        // implements.
+        return instruction.expr->matchesBSON(doc);
+    }
+
+    const auto matchType = instruction.expr->matchType();
+    switch (instruction.op) {
+        case OpCode::kCompareLong:
+            if (elem.type() == NumberInt || elem.type() == NumberLong) {
+                return comparisonResult(matchType,
+                                        compareValues(elem.numberLong(), instruction.longValue));
+            }
+            break;
+        case OpCode::kCompareDouble:
+            if (elem.type() == NumberDouble && !std::isnan(elem.numberDouble())) {
+                return comparisonResult(
+                    matchType, compareValues(elem.numberDouble(), instruction.doubleValue));
+            }
+            break;
+        case OpCode::kCompareString:
+            if (elem.type() == String) {
+                return comparisonResult(
+                    matchType, elem.valueStringData().compare(instruction.stringValue));
+            }
+            break;
+        default:
+            break;
+    }
+
+    return static_cast<const LeafMatchExpression*>(instruction.expr)->matchesSingleElement(elem);
+}
+
+}  // namespace mongo
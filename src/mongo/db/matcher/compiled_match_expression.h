@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+/**
+ * A MatchExpression flattened into a program, for evaluating the same filter against many
+ * documents.
+ *
+ * Leaf predicates on top-level (undotted) fields beneath any nesting of $and and $or read their
+ * field from a table filled by a single pass over the document, so sibling predicates share one
+ * traversal rather than each resolving its own path. Comparisons against a number or string
+ * constant are evaluated inline when the document holds a value of the same type. The children of
+ * each $and and $or are reordered so that the cheapest are evaluated first. Any other predicate,
+ * or a leaf whose field is missing or holds an array, is evaluated by the original MatchExpression.
+ *
+ * The program itself is not modified once built, but predicates it hands to the original
+ * MatchExpression may be. Geo predicates, for instance, lazily build indexes over the query's
+ * geometry while matching. Several threads may therefore only evaluate the program at once when
+ * no node of the MatchExpression keeps state of its own while matching.
+ * The MatchExpression must outlive the program, and must not be modified while it is in use.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    explicit CompiledMatchExpression(const MatchExpression* expr);
+
+    /**
+     * Returns the same result as MatchExpression::matchesBSON() for the expression this program was
+     * compiled from.
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+    /**
+     * Returns the number of distinct fields resolved by the shared traversal of each document.
+     */
+    size_t numResolvedFields() const {
+        return _fieldNames.size();
+    }
+
+    // The most distinct fields resolved by the shared traversal. Leaves on further fields are
+    // evaluated by their MatchExpression.
+    static const size_t kMaxResolvedFields = 16;
+
+private:
+    enum class OpCode {
+        kAnd,
+        kOr,
+        kLeaf,           // LeafMatchExpression::matchesSingleElement() on a resolved field.
+        kCompareLong,    // Comparison against a NumberInt or NumberLong constant.
+        kCompareDouble,  // Comparison against a NumberDouble constant other than NaN.
+        kCompareString,  // Comparison against a String constant, without a collator.
+        kExpression,     // MatchExpression::matchesBSON() on the whole document.
+    };
+
+    struct Instruction {
+        OpCode op;
+
+        // Index one past the last instruction of this instruction's subtree. A $and or $or
+        // iterates its children by jumping from one child's 'end' to the next.
+        size_t end = 0;
+
+        const MatchExpression* expr = nullptr;
+
+        // For leaves, the index of the field in the table of resolved fields.
+        size_t field = 0;
+
+        // The constant of a specialized comparison.
+        long long longValue = 0;
+        double doubleValue = 0;
+        StringData stringValue;
+    };
+
+    /**
+     * Returns the opcode 'expr' would be compiled to if its field can be resolved by the shared
+     * traversal.
+     */
+    static OpCode classify(const MatchExpression* expr);
+
+    /**
+     * Appends the instructions for 'expr' and its children to the program.
+     */
+    void emit(const MatchExpression* expr);
+
+    bool evaluate(size_t pc, const BSONObj& doc, const BSONElement* fields) const;
+
+    std::vector<Instruction> _program;
+    std::vector<std::string> _fieldNames;
+};
+
+}  // namespace mongo
@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter, const CollatorInterface* collator) {
+    auto status =
+        MatchExpressionParser::parse(filter, ExtensionsCallbackDisallowExtensions(), collator);
+    ASSERT_OK(status.getStatus());
+    return std::move(status.getValue());
+}
+
+const std::vector<BSONObj> kDocs = {
+    fromjson("{}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: 5}"),
+    fromjson("{a: 5.5}"),
+    fromjson("{a: NumberLong(5)}"),
+    fromjson("{a: NumberDecimal('5')}"),
+    fromjson("{a: NaN}"),
+    fromjson("{a: null}"),
+    fromjson("{a: undefined}"),
+    fromjson("{a: 'abc'}"),
+    fromjson("{a: 'abd', b: 'ABC'}"),
+    fromjson("{a: ''}"),
+    fromjson("{a: [1, 5, 7]}"),
+    fromjson("{a: [[5]]}"),
+    fromjson("{a: []}"),
+    fromjson("{a: {b: 5}}"),
+    fromjson("{a: {b: [4, 5]}}"),
+    fromjson("{a: 5, b: 2}"),
+    fromjson("{a: 5, b: 'x', c: true}"),
+    fromjson("{b: 2, a: 7, c: {$minKey: 1}}"),
+    fromjson("{a: 1, a: 5}"),
+    fromjson("{a: {$maxKey: 1}, b: {$minKey: 1}}"),
+    fromjson("{a: 12, b: 6, c: 'abc'}"),
+};
+
+const std::vector<BSONObj> kFilters = {
+    fromjson("{}"),
+    fromjson("{a: 5}"),
+    fromjson("{a: {$lt: 5}}"),
+    fromjson("{a: {$lte: 5}}"),
+    fromjson("{a: {$gt: 5}}"),
+    fromjson("{a: {$gte: 5.5}}"),
+    fromjson("{a: {$lt: NaN}}"),
+    fromjson("{a: {$gte: NaN}}"),
+    fromjson("{a: null}"),
+    fromjson("{a: {$gte: null}}"),
+    fromjson("{a: 'abc'}"),
+    fromjson("{a: {$gt: 'abc'}}"),
+    fromjson("{a: {$lt: ''}}"),
+    fromjson("{a: {$lt: {$maxKey: 1}}}"),
+    fromjson("{a: {$gt: {$minKey: 1}}}"),
+    fromjson("{a: [5]}"),
+    fromjson("{a: {b: 5}}"),
+    fromjson("{'a.b': 5}"),
+    fromjson("{a: {$exists: true}}"),
+    fromjson("{a: {$exists: false}}"),
+    fromjson("{a: {$in: [1, 'abc', null]}}"),
+    fromjson("{a: {$nin: [1, 5]}}"),
+    fromjson("{a: {$mod: [2, 1]}}"),
+    fromjson("{a: {$regex: '^ab'}}"),
+    fromjson("{a: {$bitsAllSet: 4}}"),
+    fromjson("{a: {$type: 'string'}}"),
+    fromjson("{a: {$size: 3}}"),
+    fromjson("{a: {$elemMatch: {$gt: 6}}}"),
+    fromjson("{a: {$not: {$gt: 5}}}"),
+    fromjson("{a: {$gt: 1, $lt: 7}, b: 2}"),
+    fromjson("{$or: [{a: 1}, {b: 2}, {'a.b': 5}]}"),
+    fromjson("{$and: [{a: {$gte: 5}}, {$or: [{b: 'x'}, {c: {$exists: false}}]}]}"),
+    fromjson("{$nor: [{a: 5}, {b: 2}]}"),
+    fromjson("{a: {$ne: 5}, c: {$lt: 'abd'}}"),
+};
+
+void assertMatchesLikeExpression(const BSONObj& filter, const CollatorInterface* collator) {
+    auto expr = parse(filter, collator);
+    CompiledMatchExpression compiled(expr.get());
+    for (auto&& doc : kDocs) {
+        ASSERT_EQ(expr->matchesBSON(doc), compiled.matchesBSON(doc))
+            << "filter: " << filter << ", document: " << doc;
+    }
+}
+
+TEST(CompiledMatchExpressionTest, MatchesLikeMatchExpression) {
+    for (auto&& filter : kFilters) {
+        assertMatchesLikeExpression(filter, nullptr);
+    }
+}
+
+TEST(CompiledMatchExpressionTest, MatchesLikeMatchExpressionWithCollator) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    for (auto&& filter : kFilters) {
+        assertMatchesLikeExpression(filter, &collator);
+    }
+    assertMatchesLikeExpression(fromjson("{b: 'abc'}"), &collator);
+}
+
+TEST(CompiledMatchExpressionTest, SiblingPredicatesShareResolvedFields) {
+    auto expr = parse(fromjson("{a: {$gt: 1, $lt: 7}, b: 2, $or: [{a: 3}, {c: 4}], 'd.e': 1}"),
+                      nullptr);
+    CompiledMatchExpression compiled(expr.get());
+    ASSERT_EQ(3U, compiled.numResolvedFields());
+
+    ASSERT_TRUE(compiled.matchesBSON(fromjson("{a: 3, b: 2, d: {e: 1}}")));
+    ASSERT_TRUE(compiled.matchesBSON(fromjson("{d: {e: [0, 1]}, c: 4, b: 2, a: 6}")));
+    ASSERT_FALSE(compiled.matchesBSON(fromjson("{a: 3, b: 2, d: {e: 2}}")));
+    ASSERT_FALSE(compiled.matchesBSON(fromjson("{a: 7, b: 2, c: 4, d: {e: 1}}")));
+}
+
+TEST(CompiledMatchExpressionTest, FieldsBeyondLimitAreMatchedByExpression) {
+    BSONObjBuilder filterBuilder;
+    BSONObjBuilder docBuilder;
+    for (size_t i = 0; i < CompiledMatchExpression::kMaxResolvedFields + 4; ++i) {
+        const std::string field = "f" + std::to_string(i);
+        filterBuilder.append(field, static_cast<int>(i));
+        docBuilder.append(field, static_cast<int>(i));
+    }
+    const BSONObj doc = docBuilder.obj();
+
+    auto expr = parse(filterBuilder.obj(), nullptr);
+    CompiledMatchExpression compiled(expr.get());
+    ASSERT_EQ(CompiledMatchExpression::kMaxResolvedFields, compiled.numResolvedFields());
+    ASSERT_TRUE(compiled.matchesBSON(doc));
+    ASSERT_FALSE(compiled.matchesBSON(doc.removeField("f19")));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/util/allocator.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+const auto getOperationArena = OperationContext::declareDecoration<OperationArena>();
+
+// Allocations at least this large get a block of their own rather than starting a new current
+// block, so that a single large request does not waste the rest of the current block.
+const std::size_t kDedicatedBlockThreshold = OperationArena::kMaxBlockSize / 4;
+
+}  // namespace
+
+const std::size_t OperationArena::kMinBlockSize;
+const std::size_t OperationArena::kMaxBlockSize;
+
+OperationArena& OperationArena::get(OperationContext* opCtx) {
+    return getOperationArena(opCtx);
+}
+
+const OperationArena& OperationArena::get(const OperationContext* opCtx) {
+    return getOperationArena(opCtx);
+}
+
+OperationArena::~OperationArena() {
+    while (_blocks) {
+        Block* previous = _blocks->previous;
+        free(_blocks);
+        _blocks = previous;
+    }
+}
+
+void* OperationArena::allocate(std::size_t bytes, std::size_t alignment) {
+    dassert(alignment && (alignment & (alignment - 1)) == 0);
+    dassert(alignment <= alignof(std::max_align_t));
+
+    // Only the operation's thread writes the statistics, so they need no read-modify-write.
+    _bytesAllocated.storeRelaxed(_bytesAllocated.loadRelaxed() + bytes);
+
+    if (bytes >= kDedicatedBlockThreshold) {
+        return _addBlock(bytes, false);
+    }
+
+    if (_next) {
+        const auto next = reinterpret_cast<std::uintptr_t>(_next);
+        const auto aligned = (next + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+        char* result = _next + (aligned - next);
+        if (result <= _end && static_cast<std::size_t>(_end - result) >= bytes) {
+            _next = result + bytes;
+            return result;
+        }
+    }
+
+    char* result = _addBlock(bytes, true);
+    _next = result + bytes;
+    return result;
+}
+
+char* OperationArena::_addBlock(std::size_t bytes, bool makeCurrent) {
+    std::size_t dataSize = bytes;
+    if (makeCurrent) {
+        dataSize = std::max(bytes, _nextBlockSize);
+        _nextBlockSize = std::min(_nextBlockSize * 2, kMaxBlockSize);
+    }
+
+    auto block = static_cast<Block*>(mongoMalloc(sizeof(Block) + dataSize));
+    block->size = dataSize;
+    _bytesReserved.storeRelaxed(_bytesReserved.loadRelaxed() + sizeof(Block) + dataSize);
+
+    char* data = reinterpret_cast<char*>(block + 1);
+    if (makeCurrent || !_blocks) {
+        block->previous = _blocks;
+        _blocks = block;
+    } else {
+        // Keep the current block at the head of the chain so that it stays available.
+        block->previous = _blocks->previous;
+        _blocks->previous = block;
+    }
+
+    if (makeCurrent) {
+        _next = data;
+        _end = data + dataSize;
+    }
+    return data;
+}
+
+}  // namespace mongo
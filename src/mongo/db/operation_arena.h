@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Bump allocator for objects that live no longer than the operation that creates them. Memory is
+ * carved out of a chain of blocks that grow geometrically, and individual allocations are never
+ * freed; every block is released at once when the arena, and with it the OperationContext that it
+ * decorates, is destroyed.
+ *
+ * Use it only for structures that grow and are then discarded together within one operation, such
+ * as the set of values collected by a distinct command. State that outlives the operation, such as
+ * anything held by a ClientCursor across getMores, must not be allocated from the arena.
+ *
+ * Allocation is not thread safe. The statistics may be read from any thread, for example by
+ * currentOp, and are only updated by the thread that allocates.
+ */
+class OperationArena {
+    MONGO_DISALLOW_COPYING(OperationArena);
+
+public:
+    // Size of the first block. Each following block is twice the size of the previous one, up to
+    // kMaxBlockSize.
+    static const std::size_t kMinBlockSize = 4 * 1024;
+    static const std::size_t kMaxBlockSize = 1024 * 1024;
+
+    OperationArena() = default;
+    ~OperationArena();
+
+    static OperationArena& get(OperationContext* opCtx);
+    static const OperationArena& get(const OperationContext* opCtx);
+
+    /**
+     * Returns 'bytes' bytes of uninitialized memory aligned to 'alignment', which must be a power
+     * of two no larger than alignof(std::max_align_t). The memory remains valid until the arena is
+     * destroyed.
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Number of bytes handed out by allocate().
+     */
+    long long bytesAllocated() const {
+        return _bytesAllocated.load();
+    }
+
+    /**
+     * Number of bytes in the blocks that the arena obtained from the system allocator.
+     */
+    long long bytesReserved() const {
+        return _bytesReserved.load();
+    }
+
+private:
+    struct alignas(std::max_align_t) Block {
+        Block* previous;
+        std::size_t size;
+    };
+
+    /**
+     * Allocates a block with room for at least 'bytes' bytes and links it into the chain. If
+     * 'makeCurrent' is true, later allocations are carved out of the new block.
+     */
+    char* _addBlock(std::size_t bytes, bool makeCurrent);
+
+    Block* _blocks = nullptr;
+    char* _next = nullptr;
+    char* _end = nullptr;
+    std::size_t _nextBlockSize = kMinBlockSize;
+
+    AtomicInt64 _bytesAllocated;
+    AtomicInt64 _bytesReserved;
+};
+
+/**
+ * Standard library allocator that allocates from an OperationArena. Deallocation is a no-op, so it
+ * suits containers that only grow before being discarded.
+ */
+template <typename T>
+class OperationArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit OperationArenaAllocator(OperationArena* arena) : _arena(arena) {}
+
+    template <typename U>
+    OperationArenaAllocator(const OperationArenaAllocator<U>& other) : _arena(other.getArena()) {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) {}
+
+    OperationArena* getArena() const {
+        return _arena;
+    }
+
+private:
+    OperationArena* _arena;
+};
+
+template <typename T, typename U>
+bool operator==(const OperationArenaAllocator<T>& lhs, const OperationArenaAllocator<U>& rhs) {
+    return lhs.getArena() == rhs.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const OperationArenaAllocator<T>& lhs, const OperationArenaAllocator<U>& rhs) {
+    return !(lhs == rhs);
+}
+
+}  // namespace mongo
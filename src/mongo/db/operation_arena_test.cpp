@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include "mongo/db/operation_arena.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+bool isAligned(const void* ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(OperationArenaTest, NewArenaHasNoBytes) {
+    OperationArena arena;
+    ASSERT_EQ(0, arena.bytesAllocated());
+    ASSERT_EQ(0, arena.bytesReserved());
+}
+
+TEST(OperationArenaTest, AllocationsAreAlignedAndDoNotOverlap) {
+    OperationArena arena;
+    auto a = static_cast<char*>(arena.allocate(3, 1));
+    auto b = static_cast<char*>(arena.allocate(8, 8));
+    auto c = static_cast<char*>(arena.allocate(16));
+    ASSERT_TRUE(isAligned(b, 8));
+    ASSERT_TRUE(isAligned(c, alignof(std::max_align_t)));
+    ASSERT_GTE(b, a + 3);
+    ASSERT_GTE(c, b + 8);
+
+    std::memset(a, 'a', 3);
+    std::memset(b, 'b', 8);
+    std::memset(c, 'c', 16);
+    ASSERT_EQ('a', a[2]);
+    ASSERT_EQ('b', b[7]);
+
+    ASSERT_EQ(27, arena.bytesAllocated());
+    ASSERT_GTE(arena.bytesReserved(), static_cast<long long>(OperationArena::kMinBlockSize));
+}
+
+TEST(OperationArenaTest, SmallAllocationsShareBlocks) {
+    OperationArena arena;
+    for (int i = 0; i < 100; ++i) {
+        arena.allocate(32);
+    }
+    ASSERT_EQ(3200, arena.bytesAllocated());
+    ASSERT_LT(arena.bytesReserved(), 2 * static_cast<long long>(OperationArena::kMinBlockSize));
+}
+
+TEST(OperationArenaTest, BlocksGrowWhenExhausted) {
+    OperationArena arena;
+    const std::size_t total = 10 * OperationArena::kMinBlockSize;
+    for (std::size_t allocated = 0; allocated < total; allocated += 100) {
+        std::memset(arena.allocate(100), 0, 100);
+    }
+    ASSERT_GTE(arena.bytesReserved(), static_cast<long long>(total));
+    // Geometric growth keeps the number of blocks, and so the reserved overhead, small.
+    ASSERT_LT(arena.bytesReserved(), 4 * static_cast<long long>(total));
+}
+
+TEST(OperationArenaTest, LargeAllocationDoesNotDiscardCurrentBlock) {
+    OperationArena arena;
+    auto first = static_cast<char*>(arena.allocate(16));
+    const auto reservedBeforeLarge = arena.bytesReserved();
+
+    std::memset(arena.allocate(OperationArena::kMaxBlockSize), 0, OperationArena::kMaxBlockSize);
+    ASSERT_GT(arena.bytesReserved(),
+              reservedBeforeLarge + static_cast<long long>(OperationArena::kMaxBlockSize) - 1);
+
+    // The next small allocation still comes from the first block.
+    auto second = static_cast<char*>(arena.allocate(16));
+    ASSERT_EQ(first + 16, second);
+}
+
+TEST(OperationArenaTest, AllocatorWorksWithStandardContainers) {
+    OperationArena arena;
+    std::vector<int, OperationArenaAllocator<int>> values{OperationArenaAllocator<int>(&arena)};
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    ASSERT_EQ(1000U, values.size());
+    ASSERT_EQ(999, values.back());
+
+    std::set<int, std::less<int>, OperationArenaAllocator<int>> set{
+        std::less<int>(), OperationArenaAllocator<int>(&arena)};
+    for (int i = 0; i < 100; ++i) {
+        set.insert(i % 10);
+    }
+    ASSERT_EQ(10U, set.size());
+    ASSERT_GT(arena.bytesAllocated(), static_cast<long long>(1000 * sizeof(int)));
+}
+
+TEST(OperationArenaTest, AllocatorsCompareEqualForSameArena) {
+    OperationArena arena;
+    OperationArena otherArena;
+    OperationArenaAllocator<int> a(&arena);
+    OperationArenaAllocator<double> b(a);
+    OperationArenaAllocator<int> c(&otherArena);
+    ASSERT_TRUE(a == b);
+    ASSERT_TRUE(a != c);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -60,6 +60,13 @@ public:
         processInternal(input, merging);
     }
 
+    /** Process a batch of inputs, with the same result as calling process() on each in order.
+     *  Used by $group to feed a column of values for one group through a single call.
+     */
+    void processBatch(const std::vector<Value>& inputs, bool merging) {
+        processBatchInternal(inputs, merging);
+    }
+
     /** Marks the end of the evaluate() phase and return accumulated result.
      *  toBeMerged should be true when the outputs will be merged by process().
      */
@@ -89,6 +96,13 @@ protected:
     /// Update subclass's internal state based on input
     virtual void processInternal(const Value& input, bool merging) = 0;
 
+    /// Update internal state for each input in turn. Subclasses may override with a tighter loop.
+    virtual void processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+        for (auto&& input : inputs) {
+            processInternal(input, merging);
+        }
+    }
+
     const boost::intrusive_ptr<ExpressionContext>& getExpressionContext() const {
         return _expCtx;
     }
@@ -166,6 +180,7 @@ public:
     explicit AccumulatorSum(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs, bool merging) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
@@ -198,6 +213,7 @@ public:
     AccumulatorMinMax(const boost::intrusive_ptr<ExpressionContext>& expCtx, Sense sense);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs, bool merging) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
@@ -254,6 +270,7 @@ public:
     explicit AccumulatorAvg(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs, bool merging) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
@@ -261,6 +278,10 @@ public:
     static boost::intrusive_ptr<Accumulator> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
+    bool isCommutative() const final {
+        return true;
+    }
+
 private:
     /**
      * The total of all values is partitioned between those that are decimals, and those that are
@@ -284,6 +305,10 @@ public:
     const char* getOpName() const final;
     void reset() final;
 
+    bool isCommutative() const final {
+        return true;
+    }
+
 private:
     const bool _isSamp;
     long long _count;
@@ -92,6 +92,38 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     _count++;
 }
 
+void AccumulatorAvg::processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+    if (merging) {
+        for (auto&& input : inputs) {
+            processInternal(input, merging);
+        }
+        return;
+    }
+
+    long long count = 0;
+    for (auto&& input : inputs) {
+        switch (input.getType()) {
+            case NumberDecimal:
+                _decimalTotal = _decimalTotal.add(input.getDecimal());
+                _isDecimal = true;
+                break;
+            case NumberLong:
+                // Avoid summation using double as that loses precision.
+                _nonDecimalTotal.addLong(input.getLong());
+                break;
+            case NumberInt:
+            case NumberDouble:
+                _nonDecimalTotal.addDouble(input.getDouble());
+                break;
+            default:
+                dassert(!input.numeric());
+                continue;
+        }
+        count++;
+    }
+    _count += count;
+}
+
 intrusive_ptr<Accumulator> AccumulatorAvg::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorAvg(expCtx);
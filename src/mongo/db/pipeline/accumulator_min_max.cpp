@@ -61,6 +61,20 @@ void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorMinMax::processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+    // Find the extreme of the batch first so that '_val' is only replaced once.
+    const auto& comparator = getExpressionContext()->getValueComparator();
+    const Value* best = nullptr;
+    for (auto&& input : inputs) {
+        if (!input.nullish() && (!best || comparator.compare(*best, input) * _sense > 0)) {
+            best = &input;
+        }
+    }
+    if (best) {
+        processInternal(*best, merging);
+    }
+}
+
 Value AccumulatorMinMax::getValue(bool toBeMerged) {
     if (_val.missing()) {
         return Value(BSONNULL);
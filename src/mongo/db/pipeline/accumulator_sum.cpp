@@ -84,6 +84,39 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorSum::processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+    // Same as processInternal() on each input, but the widest type is only folded into
+    // 'totalType' once per batch.
+    BSONType widestType = totalType;
+    for (auto&& input : inputs) {
+        switch (input.getType()) {
+            case NumberInt:
+                nonDecimalTotal.addLong(input.getInt());
+                break;
+            case NumberLong:
+                widestType = Value::getWidestNumeric(widestType, NumberLong);
+                nonDecimalTotal.addLong(input.getLong());
+                break;
+            case NumberDouble:
+                widestType = Value::getWidestNumeric(widestType, NumberDouble);
+                nonDecimalTotal.addDouble(input.getDouble());
+                break;
+            case NumberDecimal:
+                widestType = Value::getWidestNumeric(widestType, NumberDecimal);
+                decimalTotal = decimalTotal.add(input.getDecimal());
+                break;
+            default:
+                if (merging) {
+                    totalType = widestType;
+                    processInternal(input, merging);
+                    widestType = totalType;
+                }
+                break;
+        }
+    }
+    totalType = widestType;
+}
+
 intrusive_ptr<Accumulator> AccumulatorSum::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorSum(expCtx);
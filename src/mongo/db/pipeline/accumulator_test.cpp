@@ -91,6 +91,31 @@ static void assertExpectedResults(
                 ASSERT_VALUE_EQ(op.second, result);
                 ASSERT_EQUALS(op.second.getType(), result.getType());
             }
+
+            // Asserts that result equals expected result when all input is processed as a batch.
+            {
+                boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
+                accum->processBatch(op.first, false);
+                Value result = accum->getValue(false);
+                ASSERT_VALUE_EQ(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+            }
+
+            // Asserts that result equals expected result when the output of a shard per input is
+            // merged as a batch.
+            {
+                boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
+                std::vector<Value> shardOutputs;
+                for (auto&& val : op.first) {
+                    boost::intrusive_ptr<Accumulator> shard(factory(expCtx));
+                    shard->process(val, false);
+                    shardOutputs.push_back(shard->getValue(true));
+                }
+                accum->processBatch(shardOutputs, true);
+                Value result = accum->getValue(false);
+                ASSERT_VALUE_EQ(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+            }
         } catch (...) {
             log() << "failed with arguments: " << Value(op.first);
             throw;
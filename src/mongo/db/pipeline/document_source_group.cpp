@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <numeric>
+
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
@@ -38,6 +40,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -66,14 +69,17 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
         invariant(initializationResult.isEOF());
     }
 
+    if (_streaming) {
+        // The accumulators hold the state of a partial group across pauses of the input.
+        return getNextStreaming();
+    }
+
     for (auto&& accum : _currentAccumulators) {
         accum->reset();  // Prep accumulators for a new group.
     }
 
     if (_spilled) {
         return getNextSpilled();
-    } else if (_streaming) {
-        return getNextStreaming();
     } else {
         return getNextStandard();
     }
@@ -129,45 +135,62 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
     // Streaming optimization is active.
     auto& variables = pExpCtx->variables;
-    if (!_firstDocOfNextGroup) {
-        auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
-            return nextInput;
-        }
-        _firstDocOfNextGroup = nextInput.releaseDocument();
-        variables.setRoot(*_firstDocOfNextGroup);
-    }
+    while (true) {
+        if (_firstDocOfNextGroup) {
+            // Add to the current accumulator(s).
+            variables.setRoot(*_firstDocOfNextGroup);
+            for (size_t i = 0; i < _currentAccumulators.size(); i++) {
+                _currentAccumulators[i]->process(vpExpression[i]->evaluate(), _doingMerge);
+            }
+            _groupInProgress = true;
 
-    Value id;
-    do {
-        // Add to the current accumulator(s).
-        for (size_t i = 0; i < _currentAccumulators.size(); i++) {
-            _currentAccumulators[i]->process(vpExpression[i]->evaluate(), _doingMerge);
+            // Release our references to the previous input document before asking for the next.
+            // This makes operations like $unwind more efficient.
+            variables.clearRoot();
+            _firstDocOfNextGroup = boost::none;
         }
 
-        // Release our references to the previous input document before asking for the next. This
-        // makes operations like $unwind more efficient.
-        variables.clearRoot();
-
-        // Retrieve the next document.
+        // Retrieve the next document. If the input pauses, the partial group stays in the
+        // accumulators until the next call.
         auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
+        if (nextInput.isPaused()) {
             return nextInput;
         }
 
-        _firstDocOfNextGroup = nextInput.releaseDocument();
+        if (nextInput.isEOF()) {
+            if (!_groupInProgress) {
+                return nextInput;
+            }
 
+            // The input ended in the middle of the last group, which is output before EOF.
+            _groupInProgress = false;
+            return finishStreamingGroup();
+        }
+
+        _firstDocOfNextGroup = nextInput.releaseDocument();
         variables.setRoot(*_firstDocOfNextGroup);
+        Value id = computeId();
 
-        // Compute the id. If it does not match _currentId, we will exit the loop, leaving
-        // _firstDocOfNextGroup set for the next time getNext() is called.
-        id = computeId();
-    } while (pExpCtx->getValueComparator().evaluate(_currentId == id));
+        if (!_groupInProgress) {
+            // This is the first document of the input.
+            _currentId = std::move(id);
+        } else if (pExpCtx->getValueComparator().evaluate(_currentId != id)) {
+            // The document starts the next group. We leave '_firstDocOfNextGroup' set so it is
+            // processed the next time getNext() is called.
+            variables.clearRoot();
+            Document out = finishStreamingGroup();
+            _currentId = std::move(id);
+            return std::move(out);
+        }
+    }
+}
 
+Document DocumentSourceGroup::finishStreamingGroup() {
     Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
-    _currentId = std::move(id);
-
-    return std::move(out);
+    for (auto&& accum : _currentAccumulators) {
+        accum->reset();  // Prep accumulators for a new group.
+    }
+    return out;
 }
 
 void DocumentSourceGroup::doDispose() {
@@ -179,6 +202,7 @@ void DocumentSourceGroup::doDispose() {
     groupsIterator = _groups->end();
 
     _firstDocOfNextGroup = boost::none;
+    _groupInProgress = false;
 }
 
 intrusive_ptr<DocumentSource> DocumentSourceGroup::optimize() {
@@ -472,26 +496,27 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
             _currentAccumulators.push_back(vpAccumulatorFactory[i](pExpCtx));
         }
 
-        // We only need to load the first document.
-        auto firstInput = pSource->getNext();
-        if (!firstInput.isAdvanced()) {
-            // Leave '_firstDocOfNextGroup' uninitialized and return.
-            return firstInput;
-        }
-        _firstDocOfNextGroup = firstInput.releaseDocument();
-        pExpCtx->variables.setRoot(*_firstDocOfNextGroup);
-
-        // Compute the _id value.
-        _currentId = computeId();
+        // The input is consumed lazily by getNextStreaming(), one group at a time.
         _initialized = true;
         return DocumentSource::GetNextResult::makeEOF();
     }
 
     dassert(numAccumulators == vpExpression.size());
 
-    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'. Input is consumed
+    // in batches: the group key and accumulator arguments of each document are evaluated into
+    // columns, then each group's accumulators process their part of the columns in one call.
+    const size_t batchSize =
+        static_cast<size_t>(std::max(1, internalDocumentSourceGroupBatchSize.load()));
+    vector<Value> ids;
+    vector<vector<Value>> columns(numAccumulators);
+    ids.reserve(batchSize);
+    for (auto&& column : columns) {
+        column.reserve(batchSize);
+    }
+
     GetNextResult input = pSource->getNext();
-    for (; input.isAdvanced(); input = pSource->getNext()) {
+    while (input.isAdvanced()) {
         if (_memoryUsageBytes > _maxMemoryUsageBytes) {
             uassert(16945,
                     "Exceeded memory limit for $group, but didn't allow external sort."
@@ -501,47 +526,35 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
             _memoryUsageBytes = 0;
         }
 
+        // The batch also ends once its values may take memory usage over the limit, so that the
+        // limit is enforced as promptly as when documents are processed one at a time.
         auto& variables = pExpCtx->variables;
-        variables.setRoot(input.releaseDocument());
-
-        Value id = computeId();
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
+        size_t batchBytes = 0;
+        for (; input.isAdvanced() && ids.size() < batchSize &&
+             _memoryUsageBytes + batchBytes <= _maxMemoryUsageBytes;
+             input = pSource->getNext()) {
+            variables.setRoot(input.releaseDocument());
+
+            ids.push_back(computeId());
+            batchBytes += ids.back().getApproximateSize();
             for (size_t i = 0; i < numAccumulators; i++) {
-                group.push_back(vpAccumulatorFactory[i](pExpCtx));
+                columns[i].push_back(vpExpression[i]->evaluate());
+                batchBytes += columns[i].back().getApproximateSize();
             }
-        } else {
-            for (size_t i = 0; i < numAccumulators; i++) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= group[i]->memUsageForSorter();
-            }
-        }
-
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
 
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(vpExpression[i]->evaluate(), _doingMerge);
-            _memoryUsageBytes += group[i]->memUsageForSorter();
+            // We are done with the ROOT document so release it.
+            variables.clearRoot();
         }
 
-        // We are done with the ROOT document so release it.
-        variables.clearRoot();
+        const bool sawDuplicate = processBatch(ids, &columns);
+        ids.clear();
+        for (auto&& column : columns) {
+            column.clear();
+        }
 
         if (kDebugBuild && !storageGlobalParams.readOnly) {
             // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
+            if (sawDuplicate &&              // is a dup
                 !pExpCtx->inRouter &&        // can't spill to disk in router
                 !_extSortAllowed &&          // don't change behavior when testing external sort
                 _sortedFiles.size() < 20) {  // don't open too many FDs
@@ -594,6 +607,108 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     MONGO_UNREACHABLE;
 }
 
+bool DocumentSourceGroup::processBatch(const vector<Value>& ids, vector<vector<Value>>* columns) {
+    const size_t numAccumulators = vpAccumulatorFactory.size();
+    const size_t numRows = ids.size();
+
+    if (numRows == 1) {
+        // A single row needs no grouping of the columns, so hand each value straight to its
+        // accumulator. This is the path taken by the default batch size of 1.
+        const size_t oldSize = _groups->size();
+        Accumulators& group = (*_groups)[ids[0]];
+        const bool inserted = _groups->size() != oldSize;
+
+        if (inserted) {
+            _memoryUsageBytes += ids[0].getApproximateSize();
+
+            // Add the accumulators
+            group.reserve(numAccumulators);
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group.push_back(vpAccumulatorFactory[i](pExpCtx));
+            }
+        } else {
+            for (size_t i = 0; i < numAccumulators; i++) {
+                // subtract old mem usage. New usage added back after processing.
+                _memoryUsageBytes -= group[i]->memUsageForSorter();
+            }
+        }
+
+        /* tickle all the accumulators for the group we found */
+        dassert(numAccumulators == group.size());
+
+        for (size_t i = 0; i < numAccumulators; i++) {
+            group[i]->process((*columns)[i][0], _doingMerge);
+            _memoryUsageBytes += group[i]->memUsageForSorter();
+        }
+        return !inserted;
+    }
+
+    // Look up the group of each row. If it's not there, add a new entry with a blank accumulator.
+    // This is done in a somewhat odd way in order to avoid hashing each id and looking it up in
+    // '_groups' multiple times.
+    vector<Accumulators*> rowGroups(numRows);
+    vector<bool> rowInserted(numRows);
+    bool sawDuplicate = false;
+    for (size_t row = 0; row < numRows; row++) {
+        const size_t oldSize = _groups->size();
+        Accumulators& group = (*_groups)[ids[row]];
+        const bool inserted = _groups->size() != oldSize;
+
+        if (inserted) {
+            _memoryUsageBytes += ids[row].getApproximateSize();
+
+            // Add the accumulators
+            group.reserve(numAccumulators);
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group.push_back(vpAccumulatorFactory[i](pExpCtx));
+            }
+        }
+        sawDuplicate = sawDuplicate || !inserted;
+        rowGroups[row] = &group;
+        rowInserted[row] = inserted;
+    }
+
+    // Bring the rows of each group together, keeping them in input order within a group since
+    // accumulators such as $first and $push depend on it.
+    vector<size_t> order(numRows);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+        return std::less<Accumulators*>()(rowGroups[l], rowGroups[r]);
+    });
+
+    vector<Value> groupInputs;
+    for (size_t begin = 0; begin < numRows;) {
+        Accumulators& group = *rowGroups[order[begin]];
+        size_t end = begin + 1;
+        while (end < numRows && rowGroups[order[end]] == &group) {
+            end++;
+        }
+
+        /* tickle all the accumulators for the group we found */
+        dassert(numAccumulators == group.size());
+
+        // The first row of a group is the one that inserted it, if any.
+        const bool inserted = rowInserted[order[begin]];
+        for (size_t i = 0; i < numAccumulators; i++) {
+            if (!inserted) {
+                // subtract old mem usage. New usage added back after processing.
+                _memoryUsageBytes -= group[i]->memUsageForSorter();
+            }
+
+            groupInputs.clear();
+            for (size_t k = begin; k < end; k++) {
+                groupInputs.push_back(std::move((*columns)[i][order[k]]));
+            }
+            group[i]->processBatch(groupInputs, _doingMerge);
+            _memoryUsageBytes += group[i]->memUsageForSorter();
+        }
+
+        begin = end;
+    }
+
+    return sawDuplicate;
+}
+
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
     ptrs.reserve(_groups->size());
@@ -634,10 +749,24 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
 }
 
+boost::optional<std::string> DocumentSourceGroup::getIdFieldPath() const {
+    if (!_idFieldNames.empty() || _idExpressions.size() != 1) {
+        return boost::none;
+    }
+
+    // The first component of the path is the variable, which must be CURRENT/ROOT.
+    auto fieldPath = dynamic_cast<ExpressionFieldPath*>(_idExpressions.front().get());
+    if (!fieldPath || fieldPath->getVariableId() != Variables::kRootId ||
+        fieldPath->getFieldPath().getPathLength() < 2) {
+        return boost::none;
+    }
+    return fieldPath->getFieldPath().tail().fullPath();
+}
+
 boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
-    if (true) {
+    if (!_streamingAllowed) {
         // Until streaming $group correctly handles nullish values, the streaming behavior is
-        // disabled. See SERVER-23318.
+        // disabled unless the source of the input allows it. See SERVER-23318.
         return boost::none;
     }
 
@@ -840,6 +969,15 @@ Document DocumentSourceGroup::makeDocument(const Value& id,
     return out.freeze();
 }
 
+bool DocumentSourceGroup::isInputOrderIrrelevant() const {
+    for (auto&& factory : vpAccumulatorFactory) {
+        if (!factory(pExpCtx)->isCommutative()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceGroup::getShardSource() {
     return this;  // No modifications necessary when on shard
 }
@@ -90,6 +90,28 @@ public:
         return _streaming;
     }
 
+    /**
+     * If the _id of this $group is a single path into its input documents, such as "$a.b",
+     * returns that path ("a.b"). Otherwise returns boost::none.
+     */
+    boost::optional<std::string> getIdFieldPath() const;
+
+    /**
+     * Lets this $group stream if its input is sorted by its _id, which is otherwise disabled (see
+     * findRelevantInputSort()). The caller guarantees that input documents whose _id are equal
+     * are adjacent in that order, as they are in a covered scan of an index on the _id path.
+     */
+    void allowStreaming() {
+        _streamingAllowed = true;
+    }
+
+    /**
+     * Returns true if the output of this stage does not depend on the order of its input, which is
+     * the case when every accumulator is commutative. Sorting the input of such a $group is a
+     * no-op.
+     */
+    bool isInputOrderIrrelevant() const;
+
     // Virtuals for SplittableDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     boost::intrusive_ptr<DocumentSource> getMergeSource() final;
@@ -103,13 +125,19 @@ private:
 
     /**
      * getNext() dispatches to one of these three depending on what type of $group it is. All three
-     * of these methods expect '_currentAccumulators' to have been reset before being called, and
-     * also expect initialize() to have been called already.
+     * of these methods expect initialize() to have been called already. getNextSpilled() and
+     * getNextStandard() expect '_currentAccumulators' to have been reset before being called,
+     * while getNextStreaming() keeps a partial group in them across paused inputs.
      */
     GetNextResult getNextStreaming();
     GetNextResult getNextSpilled();
     GetNextResult getNextStandard();
 
+    /**
+     * Returns the output document of the streamed group '_currentId' and resets the accumulators.
+     */
+    Document finishStreamingGroup();
+
     /**
      * Attempt to identify an input sort order that allows us to turn into a streaming $group. If we
      * find one, return it. Otherwise, return boost::none.
@@ -135,6 +163,13 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Adds each row of a batch to its group. 'ids' holds the group key of each row and 'columns'
+     * holds, for each accumulator, the evaluated argument of each row; the values in 'columns' are
+     * moved out. Returns true if any row belonged to a group that already existed.
+     */
+    bool processBatch(const std::vector<Value>& ids, std::vector<std::vector<Value>>* columns);
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -165,6 +200,7 @@ private:
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
 
     BSONObj _inputSort;
+    bool _streamingAllowed = false;
     bool _streaming;
     bool _initialized;
 
@@ -187,8 +223,12 @@ private:
     const bool _extSortAllowed;
 
     std::pair<Value, Value> _firstPartOfNextGroup;
-    // Only used when '_sorted' is true.
+
+    // Only used when '_streaming' is true. '_firstDocOfNextGroup' is an input document of the group
+    // '_currentId' which the accumulators have not yet processed, and '_groupInProgress' is set
+    // once the accumulators have processed at least one document of that group.
     boost::optional<Document> _firstDocOfNextGroup;
+    bool _groupInProgress = false;
 };
 
 }  // namespace mongo
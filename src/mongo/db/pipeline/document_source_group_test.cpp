@@ -47,12 +47,14 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -97,6 +99,39 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoading) {
     ASSERT_DOCUMENT_EQ(result.releaseDocument(), (Document{{"_id", BSONNULL}, {"count", 4}}));
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileStreaming) {
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         AccumulationStatement::getFactory("$sum"),
+                                         ExpressionConstant::create(expCtx, Value(1))};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionFieldPath::parse(expCtx, "$a", vps), {countStatement});
+    auto mock = DocumentSourceMock::create({Document{{"a", 0}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"a", 0}},
+                                            Document{{"a", 1}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"a", 1}}});
+    mock->sorts = {BSON("a" << 1)};
+    group->allowStreaming();
+    group->setSource(mock.get());
+
+    // A pause in the middle of a group must not lose the documents already accumulated.
+    ASSERT_TRUE(group->getNext().isPaused());
+    auto result = group->getNext();
+    ASSERT_TRUE(result.isAdvanced());
+    ASSERT_DOCUMENT_EQ(result.releaseDocument(), (Document{{"_id", 0}, {"count", 2}}));
+
+    // The last group is output when the input is exhausted.
+    ASSERT_TRUE(group->getNext().isPaused());
+    result = group->getNext();
+    ASSERT_TRUE(result.isAdvanced());
+    ASSERT_DOCUMENT_EQ(result.releaseDocument(), (Document{{"_id", 1}, {"count", 2}}));
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_TRUE(group->getNext().isEOF());
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     auto expCtx = getExpCtx();
 
@@ -189,6 +224,58 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
     ASSERT_THROWS_CODE(group->getNext(), UserException, 16945);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldPreserveInputOrderWithinGroupsRegardlessOfBatchSize) {
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+
+    const int originalBatchSize = internalDocumentSourceGroupBatchSize.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupBatchSize.store(originalBatchSize); });
+
+    for (int batchSize : {1, 3, 1024}) {
+        internalDocumentSourceGroupBatchSize.store(batchSize);
+
+        AccumulationStatement pushStatement{"values",
+                                            AccumulationStatement::getFactory("$push"),
+                                            ExpressionFieldPath::parse(expCtx, "$v", vps)};
+        AccumulationStatement sumStatement{"total",
+                                           AccumulationStatement::getFactory("$sum"),
+                                           ExpressionFieldPath::parse(expCtx, "$v", vps)};
+        auto group = DocumentSourceGroup::create(expCtx,
+                                                 ExpressionFieldPath::parse(expCtx, "$k", vps),
+                                                 {pushStatement, sumStatement});
+
+        std::deque<DocumentSource::GetNextResult> inputs;
+        for (int v = 0; v < 10; v++) {
+            inputs.emplace_back(Document{{"k", v % 2}, {"v", v}});
+        }
+        auto mock = DocumentSourceMock::create(inputs);
+        group->setSource(mock.get());
+
+        map<int, Document> results;
+        for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+            auto doc = next.releaseDocument();
+            results[doc["_id"].getInt()] = doc;
+        }
+        ASSERT_EQUALS(2U, results.size());
+        ASSERT_DOCUMENT_EQ(results[0],
+                           (Document{{"_id", 0},
+                                     {"values", vector<Value>{Value(0),
+                                                              Value(2),
+                                                              Value(4),
+                                                              Value(6),
+                                                              Value(8)}},
+                                     {"total", 20}}));
+        ASSERT_DOCUMENT_EQ(results[1],
+                           (Document{{"_id", 1},
+                                     {"values", vector<Value>{Value(1),
+                                                              Value(3),
+                                                              Value(5),
+                                                              Value(7),
+                                                              Value(9)}},
+                                     {"total", 25}}));
+    }
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
@@ -1003,6 +1090,73 @@ public:
     }
 };
 
+/** A sorted single field path _id streams once the planner has allowed it. */
+class StreamingWhenAllowed : public Base {
+public:
+    void run() {
+        auto source = DocumentSourceMock::create({"{a: 0}", "{a: 0}", "{a: 1}", "{a: 1}"});
+        source->sorts = {BSON("a" << 1)};
+
+        createGroup(BSON("_id"
+                         << "$a"
+                         << "count"
+                         << BSON("$sum" << 1)));
+        ASSERT_EQUALS(std::string("a"), *group()->getIdFieldPath());
+        group()->allowStreaming();
+        group()->setSource(source.get());
+
+        auto res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_TRUE(group()->isStreaming());
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id"), Value(0));
+        ASSERT_VALUE_EQ(res.getDocument().getField("count"), Value(2));
+
+        res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id"), Value(1));
+        ASSERT_VALUE_EQ(res.getDocument().getField("count"), Value(2));
+
+        assertEOF(group());
+    }
+};
+
+/** Without the planner's permission a sorted input still does not stream. */
+class NoStreamingUnlessAllowed : public Base {
+public:
+    void run() {
+        auto source = DocumentSourceMock::create({"{a: 0}", "{a: 1}"});
+        source->sorts = {BSON("a" << 1)};
+
+        createGroup(BSON("_id"
+                         << "$a"));
+        group()->setSource(source.get());
+
+        group()->getNext();
+        ASSERT_FALSE(group()->isStreaming());
+    }
+};
+
+/** Only a single field path _id exposes the path it groups on. */
+class IdFieldPathOnlyForSingleFieldPath : public Base {
+public:
+    void run() {
+        createGroup(BSON("_id"
+                         << "$a.b"));
+        ASSERT_EQUALS(std::string("a.b"), *group()->getIdFieldPath());
+
+        createGroup(BSON("_id" << BSON("x"
+                                       << "$a")));
+        ASSERT_FALSE(group()->getIdFieldPath());
+
+        createGroup(BSON("_id"
+                         << "$$ROOT"));
+        ASSERT_FALSE(group()->getIdFieldPath());
+
+        createGroup(BSON("_id" << 1));
+        ASSERT_FALSE(group()->getIdFieldPath());
+    }
+};
+
 class NoOptimizationIfMissingDoubleSort : public Base {
 public:
     void run() {
@@ -1155,6 +1309,9 @@ public:
         add<Dependencies>();
         add<StringConstantIdAndAccumulatorExpressions>();
         add<ArrayConstantAccumulatorExpression>();
+        add<StreamingWhenAllowed>();
+        add<NoStreamingUnlessAllowed>();
+        add<IdFieldPathOnlyForSingleFieldPath>();
 #if 0
         // Disabled tests until SERVER-23318 is implemented.
         add<StreamingOptimization>();
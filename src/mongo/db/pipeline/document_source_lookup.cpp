@@ -26,24 +26,38 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <algorithm>
+
 #include "mongo/base/init.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
 
 namespace mongo {
 
 using boost::intrusive_ptr;
 using std::vector;
 
+MONGO_EXPORT_SERVER_PARAMETER(internalLookupStageHashJoinMaxMemoryBytes, int, 100 * 1024 * 1024);
+
+constexpr long long DocumentSourceLookUp::kHashJoinSmallCollectionDocs;
+
 DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
                                            std::string as,
                                            std::string localField,
@@ -139,26 +153,42 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     }
     auto inputDoc = nextInput.releaseDocument();
 
+    if (_strategy == JoinStrategy::kUndecided) {
+        _strategy = chooseJoinStrategy();
+    }
+
     // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
     // '_handlingUnwind' would be set to true, and we would not have made it here.
     invariant(!_matchSrc);
 
-    auto matchStage =
-        makeMatchStageFromInput(inputDoc, _localField, _foreignFieldFieldName, BSONObj());
-    // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-    _fromPipeline.back() = matchStage;
-    auto pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
-
     std::vector<Value> results;
     int objsize = 0;
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
+    auto checkSize = [&](const Document& result) {
+        objsize += result.getApproximateSize();
+        // The message is only built, along with its $match stage, if the check fails.
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll() << " matching "
-                              << matchStage
+                              << makeMatchStageFromInput(
+                                     inputDoc, _localField, _foreignFieldFieldName, BSONObj())
                               << " exceeds maximum document size",
                 objsize <= BSONObjMaxInternalSize);
-        results.emplace_back(std::move(*result));
+    };
+
+    if (_strategy == JoinStrategy::kHashJoin) {
+        results = probeHashTable(inputDoc, nullptr);
+        for (auto&& result : results) {
+            checkSize(result.getDocument());
+        }
+    } else {
+        // We've already allocated space for the trailing $match stage in '_fromPipeline'.
+        _fromPipeline.back() =
+            makeMatchStageFromInput(inputDoc, _localField, _foreignFieldFieldName, BSONObj());
+        auto pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
+
+        while (auto result = pipeline->getNext()) {
+            checkSize(*result);
+            results.emplace_back(std::move(*result));
+        }
     }
 
     MutableDocument output(std::move(inputDoc));
@@ -285,6 +315,10 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _foreignDocs = {};
+    _foreignDocsByKey = boost::none;
+    _additionalFilterExpr.reset();
+    _probeResults = {};
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -368,7 +402,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
+    while (!_nextValue) {
         auto nextInput = pSource->getNext();
         if (!nextInput.isAdvanced()) {
             return nextInput;
@@ -376,24 +410,34 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
         _input = nextInput.releaseDocument();
 
-        BSONObj filter = _additionalFilter.value_or(BSONObj());
-        auto matchStage =
-            makeMatchStageFromInput(*_input, _localField, _foreignFieldFieldName, filter);
-        // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-        _fromPipeline.back() = matchStage;
-
-        if (_pipeline) {
-            _pipeline->dispose(pExpCtx->opCtx);
+        if (_strategy == JoinStrategy::kUndecided) {
+            _strategy = chooseJoinStrategy();
         }
-        _pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+        if (_strategy == JoinStrategy::kHashJoin) {
+            _probeResults = probeHashTable(*_input, _additionalFilterExpr.get());
+            _probeResultsIndex = 0;
+        } else {
+            BSONObj filter = _additionalFilter.value_or(BSONObj());
+            auto matchStage =
+                makeMatchStageFromInput(*_input, _localField, _foreignFieldFieldName, filter);
+
+            // We've already allocated space for the trailing $match stage in '_fromPipeline'.
+            _fromPipeline.back() = matchStage;
+
+            if (_pipeline) {
+                _pipeline->dispose(pExpCtx->opCtx);
+            }
+            _pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
+
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = getNextUnwindResult();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -411,7 +455,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = getNextUnwindResult();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -425,6 +469,173 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     return output.freeze();
 }
 
+boost::optional<Document> DocumentSourceLookUp::getNextUnwindResult() {
+    if (_strategy == JoinStrategy::kHashJoin) {
+        if (_probeResultsIndex == _probeResults.size()) {
+            return boost::none;
+        }
+        return _probeResults[_probeResultsIndex++].getDocument();
+    }
+    return _pipeline->getNext();
+}
+
+DocumentSourceLookUp::JoinStrategy DocumentSourceLookUp::chooseJoinStrategy() {
+    const long long maxMemoryBytes = internalLookupStageHashJoinMaxMemoryBytes.load();
+    if (maxMemoryBytes <= 0) {
+        return JoinStrategy::kNestedLoop;
+    }
+
+    BSONObjBuilder statsBuilder;
+    if (!_mongod->appendStorageStats(_fromExpCtx->ns, BSONObj(), &statsBuilder).isOK()) {
+        // The foreign collection does not exist, so each query will return immediately.
+        return JoinStrategy::kNestedLoop;
+    }
+    const BSONObj stats = statsBuilder.obj();
+    if (stats["size"].safeNumberLong() > maxMemoryBytes) {
+        return JoinStrategy::kNestedLoop;
+    }
+
+    // A query per input document is cheap if it can use an index on 'foreignField', unless the
+    // foreign collection is so small that planning each query costs more than reading it once.
+    // The indexes of a view's underlying collection are ignored since they are not used to answer
+    // a $match which follows the view pipeline in general.
+    const bool isView = _fromPipeline.size() > 1;
+    if (!isView && stats["count"].safeNumberLong() > kHashJoinSmallCollectionDocs) {
+        const auto foreignPath = _foreignField.fullPath();
+        for (auto&& index : _mongod->getIndexStats(pExpCtx->opCtx, _fromExpCtx->ns)) {
+            if (index.second.indexKey.firstElementFieldName() == foreignPath) {
+                return JoinStrategy::kNestedLoop;
+            }
+        }
+    }
+
+    if (!buildHashTable()) {
+        LOG(1) << "$lookup from " << _fromNs.ns()
+               << " exceeded the memory limit for a hash join, falling back to a query per "
+                  "input document";
+        return JoinStrategy::kNestedLoop;
+    }
+    return JoinStrategy::kHashJoin;
+}
+
+bool DocumentSourceLookUp::buildHashTable() {
+    const size_t maxMemoryBytes = internalLookupStageHashJoinMaxMemoryBytes.load();
+
+    // Read the foreign collection through the view pipeline, if any, leaving off the placeholder
+    // for the $match built from each input document.
+    const std::vector<BSONObj> rawPipeline(_fromPipeline.begin(), _fromPipeline.end() - 1);
+    auto pipeline = uassertStatusOK(_mongod->makePipeline(rawPipeline, _fromExpCtx));
+
+    _foreignDocsByKey =
+        _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+    const auto foreignPath = _foreignField.fullPath();
+
+    // A null or missing local value matches the foreign documents which {foreignField: null}
+    // matches. Those include documents where the path is missing, which have no value along it,
+    // so they are found by evaluating the predicate once per document here.
+    const BSONObj nullKeyObj = BSON("" << BSONNULL);
+    EqualityMatchExpression nullPredicate;
+    uassertStatusOK(nullPredicate.init(foreignPath, nullKeyObj.firstElement()));
+    nullPredicate.setCollator(_fromExpCtx->getCollator());
+    const Value nullKey(BSONNULL);
+
+    size_t memoryBytes = 0;
+    while (auto result = pipeline->getNext()) {
+        const size_t position = _foreignDocs.size();
+        _foreignDocs.push_back(result->toBson());
+        memoryBytes += _foreignDocs.back().objsize();
+
+        // Index the document under every value a query on 'foreignField' could match, that is each
+        // value along the path, including both trailing arrays and their elements, and under null
+        // if a query for null would match it.
+        BSONElementSet keys;
+        dotted_path_support::extractAllElementsAlongPath(_foreignDocs.back(), foreignPath, keys);
+        dotted_path_support::extractAllElementsAlongPath(
+            _foreignDocs.back(), foreignPath, keys, false);
+        for (auto&& key : keys) {
+            auto& positions = (*_foreignDocsByKey)[Value(key)];
+            if (positions.empty() || positions.back() != position) {
+                positions.push_back(position);
+                memoryBytes += key.size() + sizeof(size_t);
+            }
+        }
+        if (nullPredicate.matchesBSON(_foreignDocs.back())) {
+            auto& positions = (*_foreignDocsByKey)[nullKey];
+            if (positions.empty() || positions.back() != position) {
+                positions.push_back(position);
+                memoryBytes += sizeof(size_t);
+            }
+        }
+
+        if (memoryBytes > maxMemoryBytes) {
+            _foreignDocs = {};
+            _foreignDocsByKey = boost::none;
+            return false;
+        }
+    }
+
+    // The filter internalized from a following $match is the same for every input document, so
+    // it is parsed once rather than with each probe.
+    if (_handlingUnwind && _additionalFilter && !_additionalFilter->isEmpty()) {
+        _additionalFilterExpr = uassertStatusOK(MatchExpressionParser::parse(
+            *_additionalFilter, ExtensionsCallbackNoop(), _fromExpCtx->getCollator()));
+    }
+    return true;
+}
+
+std::vector<Value> DocumentSourceLookUp::probeHashTable(
+    const Document& input, const MatchExpression* additionalFilter) const {
+    Value localFieldVal = input.getNestedField(_localField);
+
+    // Missing values are treated as null, as by makeMatchStageFromInput().
+    if (localFieldVal.missing()) {
+        localFieldVal = Value(BSONNULL);
+    }
+
+    // An array local value matches the foreign documents equal to any of its elements.
+    BSONArrayBuilder probeKeysBuilder;
+    if (localFieldVal.isArray()) {
+        for (auto&& key : localFieldVal.getArray()) {
+            probeKeysBuilder << key;
+        }
+    } else {
+        probeKeysBuilder << localFieldVal;
+    }
+    const BSONObj probeKeys = probeKeysBuilder.obj();
+
+    // Collect the positions of the documents sharing a key with the input. The table may yield
+    // false positives, for instance through array elements along the path, so each candidate is
+    // checked against the equality a nested loop join would query with for that key.
+    std::vector<size_t> positions;
+    for (auto&& key : probeKeys) {
+        EqualityMatchExpression equality;
+        uassertStatusOK(equality.init(_foreignField.fullPath(), key));
+        equality.setCollator(_fromExpCtx->getCollator());
+
+        auto it = _foreignDocsByKey->find(Value(key));
+        if (it == _foreignDocsByKey->end()) {
+            continue;
+        }
+        for (auto&& position : it->second) {
+            if (equality.matchesBSON(_foreignDocs[position])) {
+                positions.push_back(position);
+            }
+        }
+    }
+    if (probeKeys.nFields() > 1) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+
+    std::vector<Value> results;
+    for (auto&& position : positions) {
+        if (!additionalFilter || additionalFilter->matchesBSON(_foreignDocs[position])) {
+            results.emplace_back(Document(_foreignDocs[position]));
+        }
+    }
+    return results;
+}
+
 void DocumentSourceLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument output(DOC(
@@ -34,9 +34,15 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
+// The most memory $lookup may use for an in-memory hash table of the foreign collection. A foreign
+// collection larger than this is joined by querying it once per input document. Zero disables the
+// hash join.
+extern AtomicInt32 internalLookupStageHashJoinMaxMemoryBytes;
+
 /**
  * Queries separate collection for equality matches with documents in the pipeline collection.
  * Adds matching documents to a new array field in the input document.
@@ -44,6 +50,18 @@ namespace mongo {
 class DocumentSourceLookUp final : public DocumentSourceNeedsMongod,
                                    public SplittableDocumentSource {
 public:
+    /**
+     * How input documents are joined with the foreign collection. With kNestedLoop a query is run
+     * against the foreign collection for every input document. With kHashJoin the foreign
+     * collection is read once into a hash table keyed on 'foreignField', which is then probed for
+     * each input document.
+     */
+    enum class JoinStrategy { kUndecided, kNestedLoop, kHashJoin };
+
+    // Foreign collections with at most this many documents are hash joined even when
+    // 'foreignField' is indexed.
+    static constexpr long long kHashJoinSmallCollectionDocs = 1000;
+
     static std::unique_ptr<LiteParsedDocumentSourceOneForeignCollection> liteParse(
         const AggregationRequest& request, const BSONElement& spec);
 
@@ -108,6 +126,10 @@ public:
         _handlingUnwind = true;
     }
 
+    JoinStrategy getJoinStrategy() const {
+        return _strategy;
+    }
+
 protected:
     void doDispose() final;
 
@@ -132,6 +154,33 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Picks the join strategy from the size of the foreign collection and whether 'foreignField' is
+     * indexed. Called before the first input document is joined.
+     */
+    JoinStrategy chooseJoinStrategy();
+
+    /**
+     * Reads the foreign collection into '_foreignDocs' and '_foreignDocsByKey'. Returns false, with
+     * the partial table released, if the table would exceed
+     * internalLookupStageHashJoinMaxMemoryBytes.
+     */
+    bool buildHashTable();
+
+    /**
+     * Returns the foreign documents that the query built from 'input' by makeMatchStageFromInput()
+     * would match, using the hash table, restricted to those matching 'additionalFilter' if it is
+     * not null. The documents are returned in the order they were read from the foreign collection.
+     */
+    std::vector<Value> probeHashTable(const Document& input,
+                                      const MatchExpression* additionalFilter) const;
+
+    /**
+     * Returns the next foreign document joined with '_input' while unwinding, or boost::none once
+     * they are exhausted.
+     */
+    boost::optional<Document> getNextUnwindResult();
+
     NamespaceString _fromNs;
     FieldPath _as;
     FieldPath _localField;
@@ -158,6 +207,22 @@ private:
     std::unique_ptr<Pipeline, Pipeline::Deleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    JoinStrategy _strategy = JoinStrategy::kUndecided;
+
+    // The hash table used when '_strategy' is kHashJoin. '_foreignDocs' holds the foreign
+    // collection in the order it was read, and '_foreignDocsByKey' maps each value found along
+    // 'foreignField' to the positions of the documents containing it.
+    std::vector<BSONObj> _foreignDocs;
+    boost::optional<ValueUnorderedMap<std::vector<size_t>>> _foreignDocsByKey;
+
+    // '_additionalFilter' parsed once the hash table is built, for probes while unwinding. Null if
+    // there is no such filter.
+    std::unique_ptr<MatchExpression> _additionalFilterExpr;
+
+    // The foreign documents joined with '_input' while unwinding with a hash join.
+    std::vector<Value> _probeResults;
+    size_t _probeResultsIndex = 0;
 };
 
 }  // namespace mongo
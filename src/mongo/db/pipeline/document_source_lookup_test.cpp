@@ -43,6 +43,7 @@
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/stub_mongod_interface.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -157,6 +158,32 @@ public:
         return false;
     }
 
+    Status appendStorageStats(const NamespaceString& nss,
+                              const BSONObj& param,
+                              BSONObjBuilder* builder) const final {
+        long long size = 0;
+        long long count = 0;
+        for (auto&& result : _mockResults) {
+            if (result.isAdvanced()) {
+                size += result.getDocument().toBson().objsize();
+                count++;
+            }
+        }
+        builder->appendNumber("size", size);
+        builder->appendNumber("count", numRecords.value_or(count));
+        return Status::OK();
+    }
+
+    CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
+                                          const NamespaceString& ns) final {
+        CollectionIndexUsageMap indexStats;
+        for (auto&& indexKey : indexKeys) {
+            indexStats[indexKey.toString()] =
+                CollectionIndexUsageTracker::IndexUsageStats(Date_t(), indexKey);
+        }
+        return indexStats;
+    }
+
     StatusWith<std::unique_ptr<Pipeline, Pipeline::Deleter>> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx) final {
@@ -171,6 +198,12 @@ public:
         return pipeline;
     }
 
+    // Overrides the document count reported for the foreign collection.
+    boost::optional<long long> numRecords;
+
+    // Key patterns of the indexes reported for the foreign collection.
+    std::vector<BSONObj> indexKeys;
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
 };
@@ -279,6 +312,203 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     lookup->dispose();
 }
 
+/**
+ * Creates a $lookup of 'fromNs' joining 'localField' with 'foreignField' into the field "as".
+ */
+intrusive_ptr<DocumentSourceLookUp> makeLookUp(
+    const intrusive_ptr<ExpressionContextForTest>& expCtx,
+    const NamespaceString& fromNs,
+    StringData localField,
+    StringData foreignField) {
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", localField},
+                                         {"foreignField", foreignField},
+                                         {"as", "as"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    return static_cast<DocumentSourceLookUp*>(parsed.get());
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldHashJoinSmallForeignCollection) {
+    auto expCtx = getExpCtx();
+    auto lookup = makeLookUp(expCtx, NamespaceString("test", "foreign"), "x", "y");
+
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"x", 1}},
+                                                       Document{{"x", vector<Value>{Value(2),
+                                                                                    Value(1)}}},
+                                                       Document{{"x", BSONNULL}},
+                                                       Document{{"x", 3}}});
+    lookup->setSource(mockLocalSource.get());
+
+    // Foreign documents matching through arrays, with a different numeric type, and with a
+    // missing field.
+    Document foreign0{{"_id", 0}, {"y", 1}};
+    Document foreign1{{"_id", 1}, {"y", vector<Value>{Value(1), Value(2)}}};
+    Document foreign2{{"_id", 2}, {"y", 2.0}};
+    Document foreign3{{"_id", 3}};
+    Document foreign4{{"_id", 4}, {"y", Document{{"z", 3}}}};
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document(foreign0),
+                                                             Document(foreign1),
+                                                             Document(foreign2),
+                                                             Document(foreign3),
+                                                             Document(foreign4)};
+    lookup->injectMongodInterface(
+        std::make_shared<MockMongodInterface>(std::move(mockForeignContents)));
+
+    auto next = lookup->getNext();
+    ASSERT(lookup->getJoinStrategy() == DocumentSourceLookUp::JoinStrategy::kHashJoin);
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"x", 1}, {"as", vector<Value>{Value(foreign0), Value(foreign1)}}}));
+
+    // An array matches any of its elements, and each foreign document is returned once, in the
+    // order of the foreign collection.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"x", vector<Value>{Value(2), Value(1)}},
+                  {"as", vector<Value>{Value(foreign0), Value(foreign1), Value(foreign2)}}}));
+
+    // Null matches foreign documents where the field is missing.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"x", BSONNULL}, {"as", vector<Value>{Value(foreign3)}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"x", 3}, {"as", vector<Value>{}}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinOfNullMatchesWhereAQueryForNullWould) {
+    auto expCtx = getExpCtx();
+    auto lookup = makeLookUp(expCtx, NamespaceString("test", "foreign"), "x", "y.z");
+
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"x", BSONNULL}}, Document{{"_id", 0}}});
+    lookup->setSource(mockLocalSource.get());
+
+    // A query for null matches a missing path, an explicit null, and an array with an element
+    // missing the field, but not a present value.
+    Document foreign0{{"_id", 0}};
+    Document foreign1{{"_id", 1}, {"y", Document{{"z", BSONNULL}}}};
+    Document foreign2{{"_id", 2}, {"y", vector<Value>{Value(Document{{"z", 1}}),
+                                                      Value(Document{{"w", 2}})}}};
+    Document foreign3{{"_id", 3}, {"y", Document{{"z", 1}}}};
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document(foreign0), Document(foreign1), Document(foreign2), Document(foreign3)};
+    lookup->injectMongodInterface(
+        std::make_shared<MockMongodInterface>(std::move(mockForeignContents)));
+
+    const vector<Value> expected{Value(foreign0), Value(foreign1), Value(foreign2)};
+
+    auto next = lookup->getNext();
+    ASSERT(lookup->getJoinStrategy() == DocumentSourceLookUp::JoinStrategy::kHashJoin);
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"x", BSONNULL}, {"as", expected}}));
+
+    // A missing local field is treated as null.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 0}, {"as", expected}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldHashJoinWhileUnwinding) {
+    auto expCtx = getExpCtx();
+    auto lookup = makeLookUp(expCtx, NamespaceString("test", "foreign"), "x", "y");
+    const bool preserveNullAndEmptyArrays = true;
+    lookup->setUnwindStage(DocumentSourceUnwind::create(
+        expCtx, "as", preserveNullAndEmptyArrays, std::string("index")));
+
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"x", 1}}, Document{{"x", 2}}});
+    lookup->setSource(mockLocalSource.get());
+
+    Document foreign0{{"_id", 0}, {"y", 1}};
+    Document foreign1{{"_id", 1}, {"y", 1}};
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document(foreign0),
+                                                             Document(foreign1)};
+    lookup->injectMongodInterface(
+        std::make_shared<MockMongodInterface>(std::move(mockForeignContents)));
+
+    auto next = lookup->getNext();
+    ASSERT(lookup->getJoinStrategy() == DocumentSourceLookUp::JoinStrategy::kHashJoin);
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"x", 1}, {"as", foreign0}, {"index", 0LL}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"x", 1}, {"as", foreign1}, {"index", 1LL}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"x", 2}, {"index", BSONNULL}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldQueryPerDocumentWhenForeignFieldIsIndexedInLargeCollection) {
+    auto expCtx = getExpCtx();
+    auto lookup = makeLookUp(expCtx, NamespaceString("test", "foreign"), "x", "y");
+
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"x", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    Document foreign0{{"_id", 0}, {"y", 1}};
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document(foreign0)};
+    auto mongod = std::make_shared<MockMongodInterface>(std::move(mockForeignContents));
+    mongod->numRecords = DocumentSourceLookUp::kHashJoinSmallCollectionDocs + 1;
+    mongod->indexKeys = {BSON("y" << 1 << "z" << 1)};
+    lookup->injectMongodInterface(mongod);
+
+    auto next = lookup->getNext();
+    ASSERT(lookup->getJoinStrategy() == DocumentSourceLookUp::JoinStrategy::kNestedLoop);
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"x", 1}, {"as", vector<Value>{Value(foreign0)}}}));
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldFallBackToQueryPerDocumentWhenHashTableExceedsMemoryLimit) {
+    auto expCtx = getExpCtx();
+    auto lookup = makeLookUp(expCtx, NamespaceString("test", "foreign"), "x", "y");
+
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"x", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    Document foreign0{{"_id", 0}, {"y", 1}};
+    Document foreign1{{"_id", 1}, {"y", 2}};
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document(foreign0),
+                                                             Document(foreign1)};
+    lookup->injectMongodInterface(
+        std::make_shared<MockMongodInterface>(std::move(mockForeignContents)));
+
+    // Only room for the first foreign document.
+    const int originalMaxMemoryBytes = internalLookupStageHashJoinMaxMemoryBytes.load();
+    ON_BLOCK_EXIT(
+        [&] { internalLookupStageHashJoinMaxMemoryBytes.store(originalMaxMemoryBytes); });
+    internalLookupStageHashJoinMaxMemoryBytes.store(foreign0.toBson().objsize() + 1);
+
+    auto next = lookup->getNext();
+    ASSERT(lookup->getJoinStrategy() == DocumentSourceLookUp::JoinStrategy::kNestedLoop);
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"x", 1}, {"as", vector<Value>{Value(foreign0)}}}));
+    lookup->dispose();
+}
+
 TEST_F(DocumentSourceLookUpTest, LookupReportsAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -71,6 +71,10 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
     // The user facing error should have been generated earlier.
     massert(17309, "Should never call getNext on a $match stage with $text clause", !_isTextQuery);
 
+    if (!_compiledExpression) {
+        _compiledExpression = stdx::make_unique<CompiledMatchExpression>(_expression.get());
+    }
+
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
         // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
@@ -79,7 +83,7 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
             ? nextInput.getDocument().toBson()
             : getObjectForMatch(nextInput.getDocument(), _dependencies.fields);
 
-        if (_expression->matchesBSON(toMatch)) {
+        if (_compiledExpression->matchesBSON(toMatch)) {
             return nextInput;
         }
 
@@ -366,6 +370,7 @@ void DocumentSourceMatch::joinMatchWith(intrusive_ptr<DocumentSourceMatch> other
     StatusWithMatchExpression status = uassertStatusOK(
         MatchExpressionParser::parse(_predicate, ExtensionsCallbackNoop(), pExpCtx->getCollator()));
     _expression = std::move(status.getValue());
+    _compiledExpression.reset();
     _dependencies = DepsTracker(_dependencies.getMetadataAvailable());
     getDependencies(&_dependencies);
 }
@@ -373,6 +378,7 @@ void DocumentSourceMatch::joinMatchWith(intrusive_ptr<DocumentSourceMatch> other
 pair<intrusive_ptr<DocumentSourceMatch>, intrusive_ptr<DocumentSourceMatch>>
 DocumentSourceMatch::splitSourceBy(const std::set<std::string>& fields,
                                    const StringMap<std::string>& renames) {
+    _compiledExpression.reset();
     pair<unique_ptr<MatchExpression>, unique_ptr<MatchExpression>> newExpr(
         expression::splitMatchExpressionBy(std::move(_expression), fields, renames));
 
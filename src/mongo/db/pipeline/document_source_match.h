@@ -32,6 +32,7 @@
 #include <utility>
 
 #include "mongo/client/connpool.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/pipeline/document_source.h"
 
@@ -154,6 +155,10 @@ private:
 
     std::unique_ptr<MatchExpression> _expression;
 
+    // '_expression' compiled on the first call to getNext(), once the pipeline has been optimized.
+    // Must be reset whenever '_expression' changes.
+    std::unique_ptr<CompiledMatchExpression> _compiledExpression;
+
     // Cache the dependencies so that we know what fields we need to serialize to BSON for matching.
     DepsTracker _dependencies;
 
@@ -41,9 +41,11 @@
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_geo_near.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_out.h"
 #include "mongo/db/pipeline/document_source_project.h"
+#include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
@@ -214,11 +216,45 @@ std::unique_ptr<Pipeline, Pipeline::Deleter> Pipeline::splitForSharded() {
     return shardPipeline;
 }
 
+namespace {
+
+/**
+ * Returns true if 'source' is a $sort without a limit whose output flows, through stages which are
+ * not split points, into a $group whose result does not depend on the order of its input. Such a
+ * sort cannot affect the result of the pipeline.
+ */
+bool isSortOnlyFeedingOrderInsensitiveGroup(DocumentSource* source,
+                                            const Pipeline::SourceContainer& following) {
+    auto sort = dynamic_cast<DocumentSourceSort*>(source);
+    if (!sort || sort->getLimit() != -1) {
+        return false;
+    }
+
+    for (auto&& next : following) {
+        if (auto group = dynamic_cast<DocumentSourceGroup*>(next.get())) {
+            return group->isInputOrderIrrelevant();
+        }
+        if (dynamic_cast<SplittableDocumentSource*>(next.get())) {
+            return false;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
 void Pipeline::Optimizations::Sharded::findSplitPoint(Pipeline* shardPipe, Pipeline* mergePipe) {
     while (!mergePipe->_sources.empty()) {
         intrusive_ptr<DocumentSource> current = mergePipe->_sources.front();
         mergePipe->_sources.pop_front();
 
+        // Splitting on a $sort would make the shards send every document to the merger. If the
+        // sort only feeds a $group which ignores input order, drop it and split on the $group
+        // instead, so that the shards send partial aggregates.
+        if (isSortOnlyFeedingOrderInsensitiveGroup(current.get(), mergePipe->_sources)) {
+            continue;
+        }
+
         // Check if this source is splittable
         SplittableDocumentSource* splittable =
             dynamic_cast<SplittableDocumentSource*>(current.get());
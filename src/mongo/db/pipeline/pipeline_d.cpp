@@ -51,6 +51,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 #include "mongo/db/pipeline/document_source_sample.h"
@@ -490,6 +491,20 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
     }
 
+    // A covered projection reports a field missing from the document as null. Only the key of a
+    // leading $group on a single field is unaffected by this, since missing and null keys group
+    // together, so the pipeline is answered from an index alone only when nothing else is needed.
+    auto groupStage = pipeline->_sources.empty()
+        ? nullptr
+        : dynamic_cast<DocumentSourceGroup*>(pipeline->_sources.front().get());
+    auto groupField = groupStage ? groupStage->getIdFieldPath() : boost::none;
+    const bool onlyNeedsGroupKey = groupField && !deps.needWholeDocument &&
+        !deps.getNeedTextScore() && deps.fields == std::set<std::string>{*groupField};
+    if (deps.hasNoRequirements() || onlyNeedsGroupKey) {
+        // Without a query, the pipeline may still be answered from an index alone.
+        plannerOpts |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    }
+
     BSONObj emptyProjection;
     if (sortStage) {
         // See if the query system can provide a non-blocking sort.
@@ -551,6 +566,34 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
     // sort.
     dassert(sortObj->isEmpty());
 
+    // A leading $group on a single field streams rather than hashes its input if the query system
+    // can provide the input from a covered scan of an index on that field. Grouping keys of a
+    // covered field can't be arrays, so documents with equal keys are adjacent in index order.
+    // This is only tried without a query: sorting on the group key could otherwise make the planner
+    // prefer a whole-index scan in that order over a selective index on the queried fields.
+    if (onlyNeedsGroupKey && queryObj.isEmpty() && !projectionObj->isEmpty() &&
+        (plannerOpts & QueryPlannerParams::NO_UNCOVERED_PROJECTIONS)) {
+        const BSONObj groupSort = BSON(*groupField << 1);
+        auto swExecutorGroup = attemptToGetExecutor(opCtx,
+                                                    collection,
+                                                    expCtx,
+                                                    queryObj,
+                                                    *projectionObj,
+                                                    groupSort,
+                                                    aggRequest,
+                                                    plannerOpts);
+        if (swExecutorGroup.isOK()) {
+            groupStage->allowStreaming();
+            *sortObj = groupSort;
+            return std::move(swExecutorGroup.getValue());
+        } else if (swExecutorGroup == ErrorCodes::QueryPlanKilled) {
+            return {ErrorCodes::OperationFailed,
+                    str::stream() << "Failed to determine whether query system can provide a "
+                                     "covered projection in the order of the $group key: "
+                                  << swExecutorGroup.getStatus().toString()};
+        }
+    }
+
     // See if the query system can cover the projection.
     auto swExecutorProj = attemptToGetExecutor(
         opCtx, collection, expCtx, queryObj, *projectionObj, *sortObj, aggRequest, plannerOpts);
@@ -45,7 +45,9 @@ class Pipeline::Optimizations::Sharded {
 public:
     /**
      * Moves everything before a splittable stage to the shards. If there
-     * are no splittable stages, moves everything to the shards.
+     * are no splittable stages, moves everything to the shards. A $sort
+     * which cannot change the result of a following $group is dropped so
+     * that the split happens on the $group.
      *
      * It is not safe to call this optimization multiple times.
      *
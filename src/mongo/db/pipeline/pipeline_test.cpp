@@ -1061,6 +1061,64 @@ class ShardedSortMatchProjSkipLimBecomesMatchTopKSortSkipProj : public Base {
 
 }  // namespace limitFieldsSentFromShardsToMerger
 
+namespace findSplitPoint {
+
+class SortBeforeOrderInsensitiveGroupSplitsOnGroup : public Base {
+    string inputPipeJson() {
+        return "[{$sort: {a: 1}}"
+               ",{$group: {_id: '$a', total: {$sum: '$b'}, avg: {$avg: '$c'}}}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: '$a', total: {$sum: '$b'}, avg: {$avg: '$c'}}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', total: {$sum: '$$ROOT.total'},"
+               "          avg: {$avg: '$$ROOT.avg'}, $doingMerge: true}}"
+               "]";
+    }
+};
+
+class SortBeforeOrderSensitiveGroupSplitsOnSort : public Base {
+    string inputPipeJson() {
+        return "[{$sort: {a: 1}}"
+               ",{$group: {_id: '$a', all: {$push: '$b'}}}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$sort: {sortKey: {a: 1}}}"
+               ",{$project: {_id: false, a: true, b: true}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[{$sort: {sortKey: {a: 1}, mergePresorted: true}}"
+               ",{$group: {_id: '$a', all: {$push: '$b'}}}"
+               "]";
+    }
+};
+
+class SortWithLimitBeforeOrderInsensitiveGroupSplitsOnSort : public Base {
+    string inputPipeJson() {
+        return "[{$sort: {a: 1}}"
+               ",{$limit: 5}"
+               ",{$group: {_id: '$a', total: {$sum: '$b'}}}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$sort: {sortKey: {a: 1}, limit: 5}}"
+               ",{$project: {_id: false, a: true, b: true}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[{$sort: {sortKey: {a: 1}, mergePresorted: true, limit: 5}}"
+               ",{$group: {_id: '$a', total: {$sum: '$b'}}}"
+               "]";
+    }
+};
+
+}  // namespace findSplitPoint
+
 namespace coalesceLookUpAndUnwind {
 
 class ShouldCoalesceUnwindOnAs : public Base {
@@ -1411,6 +1469,10 @@ public:
     All() : Suite("PipelineOptimizations") {}
     void setupTests() {
         add<Optimizations::Sharded::Empty>();
+        add<Optimizations::Sharded::findSplitPoint::SortBeforeOrderInsensitiveGroupSplitsOnGroup>();
+        add<Optimizations::Sharded::findSplitPoint::SortBeforeOrderSensitiveGroupSplitsOnSort>();
+        add<Optimizations::Sharded::findSplitPoint::
+                SortWithLimitBeforeOrderInsensitiveGroupSplitsOnSort>();
         add<Optimizations::Sharded::coalesceLookUpAndUnwind::ShouldCoalesceUnwindOnAs>();
         add<Optimizations::Sharded::coalesceLookUpAndUnwind::
                 ShouldCoalesceUnwindOnAsWithPreserveEmpty>();
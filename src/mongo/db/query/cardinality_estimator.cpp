@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/cardinality_estimator.h"
+
+#include <algorithm>
+
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns true if 'oil' is the single interval [MinKey, MaxKey], in either direction.
+ */
+bool isAllValues(const OrderedIntervalList& oil) {
+    if (oil.intervals.size() != 1) {
+        return false;
+    }
+    Interval minMax = IndexBoundsBuilder::allValues();
+    Interval maxMin = minMax;
+    maxMin.reverse();
+    return oil.intervals[0].equals(minMax) || oil.intervals[0].equals(maxMin);
+}
+
+}  // namespace
+
+boost::optional<double> CardinalityEstimator::estimateKeysExamined(
+    const QuerySolutionNode* root, const CollectionStatistics& stats) {
+    if (root->getType() == STAGE_IXSCAN) {
+        const auto* ixscan = static_cast<const IndexScanNode*>(root);
+        if (ixscan->bounds.isSimpleRange || ixscan->bounds.fields.empty()) {
+            return boost::none;
+        }
+        // The statistics only describe the leading field, so a scan whose later fields are
+        // bounded may examine far fewer keys than estimated. Leave such scans to the race.
+        for (size_t i = 1; i < ixscan->bounds.fields.size(); ++i) {
+            if (!isAllValues(ixscan->bounds.fields[i])) {
+                return boost::none;
+            }
+        }
+        auto indexStats = stats.get(ixscan->index.name);
+        if (!indexStats) {
+            return boost::none;
+        }
+        return indexStats->estimateKeys(ixscan->bounds.fields[0]);
+    }
+
+    if (root->children.empty()) {
+        return boost::none;
+    }
+
+    double estimate = 0;
+    for (const QuerySolutionNode* child : root->children) {
+        auto childEstimate = estimateKeysExamined(child, stats);
+        if (!childEstimate) {
+            return boost::none;
+        }
+        estimate += *childEstimate;
+    }
+    return estimate;
+}
+
+std::vector<size_t> CardinalityEstimator::selectCandidates(
+    const std::vector<boost::optional<double>>& estimates, double dominanceRatio) {
+    std::vector<size_t> selected;
+    const bool allEstimated =
+        std::all_of(estimates.begin(), estimates.end(), [](const boost::optional<double>& e) {
+            return static_cast<bool>(e);
+        });
+    if (!allEstimated || estimates.empty() || dominanceRatio < 1) {
+        for (size_t i = 0; i < estimates.size(); ++i) {
+            selected.push_back(i);
+        }
+        return selected;
+    }
+
+    double cheapest = *estimates[0];
+    for (const auto& estimate : estimates) {
+        cheapest = std::min(cheapest, *estimate);
+    }
+
+    // Treat estimates below one key as one key, so that a candidate expected to examine nothing
+    // only dominates candidates expected to examine more than 'dominanceRatio' keys.
+    const double threshold = std::max(cheapest, 1.0) * dominanceRatio;
+    for (size_t i = 0; i < estimates.size(); ++i) {
+        if (*estimates[i] <= threshold) {
+            selected.push_back(i);
+        }
+    }
+    return selected;
+}
+
+}  // namespace mongo
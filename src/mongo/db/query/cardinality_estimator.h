@@ -0,0 +1,69 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+namespace mongo {
+
+class CollectionStatistics;
+struct QuerySolutionNode;
+
+/**
+ * Estimates the cost of candidate query solutions from the index statistics gathered by the
+ * analyze command, so that the planner can discard hopeless candidates before racing them in a
+ * MultiPlanStage, or skip the race entirely when one candidate clearly dominates.
+ *
+ * The cost of a solution is the number of index keys its index scans are expected to examine.
+ * Only the bounds on the leading field of each index are taken into account, so index scans which
+ * also bound later fields are left unestimated.
+ */
+class CardinalityEstimator {
+public:
+    /**
+     * Returns the estimated number of index keys examined by the solution rooted at 'root', or
+     * boost::none if it contains a collection scan, an index scan over an index without
+     * statistics, an index scan with bounds on a field other than the leading one, or any other
+     * leaf whose cost cannot be estimated.
+     */
+    static boost::optional<double> estimateKeysExamined(const QuerySolutionNode* root,
+                                                        const CollectionStatistics& stats);
+
+    /**
+     * Given the estimated cost of each candidate, returns the positions of the candidates that
+     * should be kept: those whose cost is within a factor of 'dominanceRatio' of the cheapest.
+     * Every candidate is kept if any of them has no estimate. A single position is returned when
+     * one candidate dominates all others.
+     */
+    static std::vector<size_t> selectCandidates(
+        const std::vector<boost::optional<double>>& estimates, double dominanceRatio);
+};
+
+}  // namespace mongo
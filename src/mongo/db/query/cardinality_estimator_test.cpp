@@ -0,0 +1,160 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/cardinality_estimator.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::shared_ptr<const IndexStatistics> makeUniformStats(int numValues) {
+    IndexStatistics::Builder builder(10, numValues / 10);
+    for (int i = 0; i < numValues; ++i) {
+        BSONObj key = BSON("" << i);
+        builder.addKey(key.firstElement());
+    }
+    return builder.done(numValues);
+}
+
+std::unique_ptr<QuerySolutionNode> makeFetchOverIndexScan(const std::string& indexName,
+                                                          BSONObj bounds) {
+    auto ixscan = stdx::make_unique<IndexScanNode>(IndexEntry(BSON("a" << 1), indexName));
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(Interval(bounds, true, true));
+    ixscan->bounds.fields.push_back(oil);
+
+    auto fetch = stdx::make_unique<FetchNode>();
+    fetch->children.push_back(ixscan.release());
+    return std::move(fetch);
+}
+
+TEST(CardinalityEstimatorTest, EstimatesIndexScanFromStatistics) {
+    CollectionStatistics stats;
+    stats.set("a_1", makeUniformStats(1000));
+
+    auto root = makeFetchOverIndexScan("a_1", BSON("" << 0 << "" << 99));
+    auto estimate = CardinalityEstimator::estimateKeysExamined(root.get(), stats);
+    ASSERT(estimate);
+    ASSERT_APPROX_EQUAL(100.0, *estimate, 2.0);
+}
+
+TEST(CardinalityEstimatorTest, NoEstimateWithoutStatistics) {
+    CollectionStatistics stats;
+    stats.set("a_1", makeUniformStats(1000));
+
+    auto root = makeFetchOverIndexScan("b_1", BSON("" << 0 << "" << 99));
+    ASSERT(!CardinalityEstimator::estimateKeysExamined(root.get(), stats));
+}
+
+TEST(CardinalityEstimatorTest, EstimatesCompoundIndexScanWithUnboundedTrailingField) {
+    CollectionStatistics stats;
+    stats.set("a_1_b_1", makeUniformStats(1000));
+
+    IndexScanNode ixscan(IndexEntry(BSON("a" << 1 << "b" << 1), "a_1_b_1"));
+    OrderedIntervalList oilA("a");
+    oilA.intervals.push_back(Interval(BSON("" << 0 << "" << 99), true, true));
+    ixscan.bounds.fields.push_back(oilA);
+    OrderedIntervalList oilB("b");
+    oilB.intervals.push_back(IndexBoundsBuilder::allValues());
+    ixscan.bounds.fields.push_back(oilB);
+
+    auto estimate = CardinalityEstimator::estimateKeysExamined(&ixscan, stats);
+    ASSERT(estimate);
+    ASSERT_APPROX_EQUAL(100.0, *estimate, 2.0);
+}
+
+TEST(CardinalityEstimatorTest, NoEstimateForCompoundIndexScanWithBoundedTrailingField) {
+    CollectionStatistics stats;
+    stats.set("a_1_b_1", makeUniformStats(1000));
+
+    IndexScanNode ixscan(IndexEntry(BSON("a" << 1 << "b" << 1), "a_1_b_1"));
+    OrderedIntervalList oilA("a");
+    oilA.intervals.push_back(Interval(BSON("" << 0 << "" << 99), true, true));
+    ixscan.bounds.fields.push_back(oilA);
+    OrderedIntervalList oilB("b");
+    oilB.intervals.push_back(Interval(BSON("" << 5 << "" << 5), true, true));
+    ixscan.bounds.fields.push_back(oilB);
+
+    ASSERT(!CardinalityEstimator::estimateKeysExamined(&ixscan, stats));
+}
+
+TEST(CardinalityEstimatorTest, NoEstimateForCollectionScan) {
+    CollectionStatistics stats;
+    stats.set("a_1", makeUniformStats(1000));
+
+    CollectionScanNode collScan;
+    ASSERT(!CardinalityEstimator::estimateKeysExamined(&collScan, stats));
+}
+
+TEST(CardinalityEstimatorTest, SumsEstimatesOfChildren) {
+    CollectionStatistics stats;
+    stats.set("a_1", makeUniformStats(1000));
+
+    OrNode orNode;
+    orNode.children.push_back(
+        makeFetchOverIndexScan("a_1", BSON("" << 0 << "" << 99)).release());
+    orNode.children.push_back(
+        makeFetchOverIndexScan("a_1", BSON("" << 500 << "" << 699)).release());
+    auto estimate = CardinalityEstimator::estimateKeysExamined(&orNode, stats);
+    ASSERT(estimate);
+    ASSERT_APPROX_EQUAL(300.0, *estimate, 4.0);
+}
+
+TEST(CardinalityEstimatorTest, SelectsCandidatesWithinDominanceRatio) {
+    std::vector<boost::optional<double>> estimates{10.0, 1000.0, 50.0};
+    ASSERT(std::vector<size_t>({0, 2}) == CardinalityEstimator::selectCandidates(estimates, 10));
+}
+
+TEST(CardinalityEstimatorTest, SelectsSingleDominantCandidate) {
+    std::vector<boost::optional<double>> estimates{1000.0, 1.0};
+    ASSERT(std::vector<size_t>({1}) == CardinalityEstimator::selectCandidates(estimates, 10));
+}
+
+TEST(CardinalityEstimatorTest, KeepsAllCandidatesIfAnyIsNotEstimated) {
+    std::vector<boost::optional<double>> estimates{1.0, boost::none, 1000.0};
+    ASSERT(std::vector<size_t>({0, 1, 2}) ==
+           CardinalityEstimator::selectCandidates(estimates, 10));
+}
+
+TEST(CardinalityEstimatorTest, EstimatesBelowOneKeyAreTreatedAsOneKey) {
+    std::vector<boost::optional<double>> estimates{0.0, 5.0};
+    ASSERT(std::vector<size_t>({0, 1}) == CardinalityEstimator::selectCandidates(estimates, 10));
+
+    estimates = {0.0, 11.0};
+    ASSERT(std::vector<size_t>({0}) == CardinalityEstimator::selectCandidates(estimates, 10));
+}
+
+}  // namespace
+}  // namespace mongo
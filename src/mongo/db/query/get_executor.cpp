@@ -36,9 +36,11 @@
 #include <limits>
 #include <memory>
 
+#include "mongo/base/counter.h"
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/client/dbclientinterface.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
@@ -59,9 +61,11 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/cardinality_estimator.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_executor.h"
@@ -189,6 +193,25 @@ void fillOutPlannerParams(OperationContext* opCtx,
         plannerParams->options |= QueryPlannerParams::INDEX_INTERSECTION;
     }
 
+    // Compound indices whose leading field has few distinct values, according to the statistics
+    // gathered by analyze, may be skip-scanned.
+    const long long maxSkipScanPrefixes = internalQueryPlannerMaxSkipScanPrefixes.load();
+    const CollectionStatistics& stats = *collection->infoCache()->getCollectionStatistics();
+    if (maxSkipScanPrefixes > 0 && !stats.empty()) {
+        const long long numRecords = collection->numRecords(opCtx);
+        const double maxChangeRatio = internalQueryIndexStatisticsMaxChangeRatio.load();
+        for (const auto& index : plannerParams->indices) {
+            if (index.keyPattern.nFields() < 2) {
+                continue;
+            }
+            auto indexStats = stats.get(index.name);
+            if (indexStats && !indexStats->isStale(numRecords, maxChangeRatio) &&
+                indexStats->numDistinct() <= maxSkipScanPrefixes) {
+                plannerParams->skipScanIndices.insert(index.name);
+            }
+        }
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     // Doc-level locking storage engines cannot answer predicates implicitly via exact index
@@ -225,6 +248,77 @@ struct PrepareExecutionResult {
     unique_ptr<PlanStage> root;
 };
 
+Counter64 plansDiscardedByEstimate;
+ServerStatusMetricField<Counter64> displayPlansDiscardedByEstimate(
+    "query.planner.plansDiscardedByEstimate", &plansDiscardedByEstimate);
+
+Counter64 rankingSkippedByEstimate;
+ServerStatusMetricField<Counter64> displayRankingSkippedByEstimate(
+    "query.planner.rankingSkippedByEstimate", &rankingSkippedByEstimate);
+
+/**
+ * Deletes from 'solutions' the candidates that the index statistics gathered by the analyze
+ * command estimate to examine far more keys than the cheapest candidate, leaving fewer plans for
+ * the MultiPlanStage to rank, or a single plan that needs no ranking at all.
+ *
+ * The estimates ignore early termination, so queries with a limit are left to the ranking. They
+ * also ignore the cost of a blocking sort, so sorted queries are left to it too, which keeps the
+ * plan that provides the sort order as the MultiPlanStage's backup in case an in-memory sort
+ * exceeds its memory limit. Nothing is discarded once the collection has grown or shrunk too much
+ * since it was analyzed, as the statistics no longer describe it and only the ranking can notice.
+ */
+void discardSolutionsByEstimate(OperationContext* opCtx,
+                                Collection* collection,
+                                const CanonicalQuery& canonicalQuery,
+                                vector<QuerySolution*>* solutions) {
+    if (!internalQueryPlannerUseIndexStatistics.load() || solutions->size() < 2) {
+        return;
+    }
+
+    const CollectionStatistics& stats = *collection->infoCache()->getCollectionStatistics();
+    const QueryRequest& qr = canonicalQuery.getQueryRequest();
+    if (stats.empty() || qr.getLimit() || qr.getNToReturn() || !qr.getSort().isEmpty()) {
+        return;
+    }
+    if (stats.isStale(collection->numRecords(opCtx),
+                      internalQueryIndexStatisticsMaxChangeRatio.load())) {
+        LOG(2) << "Ignoring stale index statistics for query: "
+               << redact(canonicalQuery.toStringShort());
+        return;
+    }
+
+    std::vector<boost::optional<double>> estimates;
+    for (const QuerySolution* solution : *solutions) {
+        estimates.push_back(
+            CardinalityEstimator::estimateKeysExamined(solution->root.get(), stats));
+    }
+    const std::vector<size_t> selected = CardinalityEstimator::selectCandidates(
+        estimates, internalQueryPlannerIndexStatisticsDominanceRatio.load());
+    if (selected.size() == solutions->size()) {
+        return;
+    }
+
+    vector<QuerySolution*> kept;
+    for (size_t ix = 0, next = 0; ix < solutions->size(); ++ix) {
+        if (next < selected.size() && selected[next] == ix) {
+            kept.push_back((*solutions)[ix]);
+            ++next;
+        } else {
+            delete (*solutions)[ix];
+        }
+    }
+
+    LOG(2) << "Index statistics discarded " << solutions->size() - kept.size() << " of "
+           << solutions->size()
+           << " candidate plans for query: " << redact(canonicalQuery.toStringShort());
+
+    plansDiscardedByEstimate.increment(solutions->size() - kept.size());
+    if (kept.size() == 1) {
+        rankingSkippedByEstimate.increment();
+    }
+    solutions->swap(kept);
+}
+
 /**
  * Build an execution tree for the query described in 'canonicalQuery'.
  *
@@ -419,6 +513,8 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    discardSolutionsByEstimate(opCtx, collection, *canonicalQuery, &solutions);
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         PlanStage* rawRoot;
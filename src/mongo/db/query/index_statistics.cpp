@@ -0,0 +1,300 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/interval.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+BSONObj wrapValue(const BSONElement& value) {
+    BSONObjBuilder bob;
+    bob.appendAs(value, "");
+    return bob.obj();
+}
+
+/**
+ * Returns the fraction of the numeric range (low, high) covered by (lo, hi), or a negative value if
+ * any bound is not a number.
+ */
+double numericOverlap(const BSONElement& low,
+                      const BSONElement& high,
+                      const BSONElement& lo,
+                      const BSONElement& hi) {
+    if (!low.isNumber() || !high.isNumber() || !lo.isNumber() || !hi.isNumber()) {
+        return -1.0;
+    }
+
+    const double width = high.numberDouble() - low.numberDouble();
+    const double covered = std::min(hi.numberDouble(), high.numberDouble()) -
+        std::max(lo.numberDouble(), low.numberDouble());
+    if (!std::isfinite(width) || std::isnan(covered) || width <= 0) {
+        return -1.0;
+    }
+    return std::max(0.0, std::min(1.0, covered / width));
+}
+
+}  // namespace
+
+//
+// IndexStatistics::Builder
+//
+
+IndexStatistics::Builder::Builder(size_t maxBuckets, long long initialBucketDepth)
+    : _maxBuckets(std::max<size_t>(1, maxBuckets)),
+      _bucketDepth(std::max(1LL, initialBucketDepth)) {}
+
+void IndexStatistics::Builder::addKey(const BSONElement& leadingField) {
+    if (_numKeys == 0) {
+        _lowerBound = wrapValue(leadingField);
+    }
+    ++_numKeys;
+
+    if (!_currentValue.isEmpty()) {
+        const int cmp = leadingField.woCompare(_currentValue.firstElement(), false);
+        dassert(cmp >= 0);
+        if (cmp == 0) {
+            ++_current.numKeys;
+            ++_current.numUpperBoundKeys;
+            return;
+        }
+        if (_current.numKeys >= _bucketDepth) {
+            _closeBucket();
+        }
+    }
+
+    _currentValue = wrapValue(leadingField);
+    ++_current.numKeys;
+    _current.numUpperBoundKeys = 1;
+    ++_current.numDistinct;
+    ++_numDistinct;
+}
+
+void IndexStatistics::Builder::_closeBucket() {
+    _current.upperBound = _currentValue;
+    _buckets.push_back(std::move(_current));
+    _current = Bucket();
+
+    if (_buckets.size() >= 2 * _maxBuckets) {
+        _compact();
+    }
+}
+
+void IndexStatistics::Builder::_compact() {
+    std::vector<Bucket> merged;
+    merged.reserve((_buckets.size() + 1) / 2);
+    for (size_t i = 0; i < _buckets.size(); i += 2) {
+        if (i + 1 == _buckets.size()) {
+            merged.push_back(std::move(_buckets[i]));
+            break;
+        }
+        Bucket bucket = std::move(_buckets[i + 1]);
+        bucket.numKeys += _buckets[i].numKeys;
+        bucket.numDistinct += _buckets[i].numDistinct;
+        merged.push_back(std::move(bucket));
+    }
+    _buckets = std::move(merged);
+    _bucketDepth *= 2;
+}
+
+std::unique_ptr<IndexStatistics> IndexStatistics::Builder::done(long long numRecords) {
+    if (_current.numKeys > 0) {
+        _closeBucket();
+    }
+    while (_buckets.size() > _maxBuckets) {
+        _compact();
+    }
+
+    std::unique_ptr<IndexStatistics> stats(new IndexStatistics());
+    stats->_lowerBound = std::move(_lowerBound);
+    stats->_buckets = std::move(_buckets);
+    stats->_numKeys = _numKeys;
+    stats->_numDistinct = _numDistinct;
+    stats->_numRecords = numRecords;
+    return stats;
+}
+
+//
+// IndexStatistics
+//
+
+double IndexStatistics::estimateKeys(const Interval& interval) const {
+    if (_buckets.empty()) {
+        return 0;
+    }
+
+    BSONElement lo = interval.start;
+    BSONElement hi = interval.end;
+    bool loInclusive = interval.startInclusive;
+    bool hiInclusive = interval.endInclusive;
+    const int loVsHi = lo.woCompare(hi, false);
+    if (loVsHi > 0) {
+        std::swap(lo, hi);
+        std::swap(loInclusive, hiInclusive);
+    } else if (loVsHi == 0 && !(loInclusive && hiInclusive)) {
+        return 0;
+    }
+    const bool isPoint = loVsHi == 0;
+
+    double estimate = 0;
+    BSONElement bucketLow = _lowerBound.firstElement();
+    bool firstBucket = true;
+    for (const Bucket& bucket : _buckets) {
+        const BSONElement upper = bucket.upperBound.firstElement();
+
+        // The first bucket includes the lowest value seen; later ones start above the previous
+        // bucket's upper bound.
+        const int hiVsLow = hi.woCompare(bucketLow, false);
+        if (hiVsLow < 0 || (hiVsLow == 0 && !(firstBucket && hiInclusive))) {
+            break;
+        }
+
+        const int loVsUpper = lo.woCompare(upper, false);
+        const int hiVsUpper = hi.woCompare(upper, false);
+        if (loVsUpper > 0) {
+            bucketLow = upper;
+            firstBucket = false;
+            continue;
+        }
+
+        // The keys equal to the upper bound are counted exactly.
+        if ((loVsUpper < 0 || loInclusive) && (hiVsUpper > 0 || (hiVsUpper == 0 && hiInclusive))) {
+            estimate += bucket.numUpperBoundKeys;
+        }
+
+        // The remaining keys of the bucket are assumed to be spread evenly over its other values,
+        // or over its numeric range when the bounds are numbers.
+        const double interiorKeys = bucket.numKeys - bucket.numUpperBoundKeys;
+        if (interiorKeys > 0 && loVsUpper < 0) {
+            const int loVsLow = lo.woCompare(bucketLow, false);
+            const bool coversLow = loVsLow < 0 || (loVsLow == 0 && (!firstBucket || loInclusive));
+            if (coversLow && hiVsUpper >= 0) {
+                estimate += interiorKeys;
+            } else if (isPoint) {
+                estimate += interiorKeys / std::max(1LL, bucket.numDistinct - 1);
+            } else {
+                const double fraction = numericOverlap(bucketLow, upper, lo, hi);
+                estimate += interiorKeys * (fraction >= 0 ? fraction : 0.5);
+            }
+        }
+
+        bucketLow = upper;
+        firstBucket = false;
+    }
+    return estimate;
+}
+
+double IndexStatistics::estimateKeys(const OrderedIntervalList& oil) const {
+    double estimate = 0;
+    for (const Interval& interval : oil.intervals) {
+        estimate += estimateKeys(interval);
+    }
+    return std::min(estimate, static_cast<double>(_numKeys));
+}
+
+bool IndexStatistics::isStale(long long numRecords, double maxChangeRatio) const {
+    const double change = std::abs(static_cast<double>(numRecords - _numRecords));
+    return change > maxChangeRatio * std::max(_numRecords, 1LL);
+}
+
+void IndexStatistics::appendToBuilder(BSONObjBuilder* builder, bool includeHistogram) const {
+    builder->appendNumber("numKeys", _numKeys);
+    builder->appendNumber("numDistinct", _numDistinct);
+    builder->appendNumber("numRecords", _numRecords);
+    builder->append("multikeyFanout", multikeyFanout());
+    builder->appendNumber("numBuckets", static_cast<long long>(_buckets.size()));
+
+    if (!includeHistogram) {
+        return;
+    }
+
+    if (!_buckets.empty()) {
+        builder->appendAs(_lowerBound.firstElement(), "lowerBound");
+    }
+    BSONArrayBuilder histogram(builder->subarrayStart("histogram"));
+    for (const Bucket& bucket : _buckets) {
+        BSONObjBuilder bucketBuilder(histogram.subobjStart());
+        bucketBuilder.appendAs(bucket.upperBound.firstElement(), "upperBound");
+        bucketBuilder.appendNumber("numKeys", bucket.numKeys);
+        bucketBuilder.appendNumber("numUpperBoundKeys", bucket.numUpperBoundKeys);
+        bucketBuilder.appendNumber("numDistinct", bucket.numDistinct);
+    }
+}
+
+//
+// CollectionStatistics
+//
+
+std::shared_ptr<const IndexStatistics> CollectionStatistics::get(StringData indexName) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _statsByIndexName.find(indexName);
+    return it == _statsByIndexName.end() ? nullptr : it->second;
+}
+
+void CollectionStatistics::set(StringData indexName,
+                               std::shared_ptr<const IndexStatistics> stats) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _statsByIndexName[indexName] = std::move(stats);
+}
+
+void CollectionStatistics::remove(StringData indexName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _statsByIndexName.erase(indexName);
+}
+
+void CollectionStatistics::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _statsByIndexName.clear();
+}
+
+bool CollectionStatistics::empty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _statsByIndexName.empty();
+}
+
+bool CollectionStatistics::isStale(long long numRecords, double maxChangeRatio) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& entry : _statsByIndexName) {
+        if (entry.second->isStale(numRecords, maxChangeRatio)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace mongo
@@ -0,0 +1,219 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+struct Interval;
+struct OrderedIntervalList;
+
+/**
+ * Statistics describing the distribution of the leading field of an index's keys. Built by the
+ * analyze command from a full scan of the index and used by the planner to estimate how many keys
+ * an index scan over given bounds examines.
+ *
+ * The distribution is kept as an equi-depth histogram: each bucket covers the values above the
+ * previous bucket's upper bound up to and including its own, and holds roughly the same number of
+ * keys. Buckets only ever end on a change of value, so a frequent value is never split across
+ * buckets, and the number of keys equal to each upper bound is recorded exactly.
+ */
+class IndexStatistics {
+    MONGO_DISALLOW_COPYING(IndexStatistics);
+
+public:
+    struct Bucket {
+        // Single-field object with an empty field name holding the bucket's largest value.
+        BSONObj upperBound;
+
+        // Keys in the bucket, including those equal to 'upperBound'.
+        long long numKeys = 0;
+
+        // Keys equal to 'upperBound'.
+        long long numUpperBoundKeys = 0;
+
+        // Distinct values in the bucket, including 'upperBound'.
+        long long numDistinct = 0;
+    };
+
+    /**
+     * Accumulates the leading key fields of an index in ascending order into an IndexStatistics.
+     * The histogram starts with buckets of 'initialBucketDepth' keys and, whenever it grows to
+     * twice 'maxBuckets' buckets, merges neighbouring buckets and doubles the depth, so the index
+     * size does not need to be known up front.
+     */
+    class Builder {
+        MONGO_DISALLOW_COPYING(Builder);
+
+    public:
+        Builder(size_t maxBuckets, long long initialBucketDepth);
+
+        /**
+         * Adds the leading field of the next key. Values must be passed in ascending order.
+         */
+        void addKey(const BSONElement& leadingField);
+
+        /**
+         * Returns the statistics for the keys added so far. 'numRecords' is the number of
+         * documents in the collection, used to compute the multikey fan-out.
+         */
+        std::unique_ptr<IndexStatistics> done(long long numRecords);
+
+    private:
+        void _closeBucket();
+        void _compact();
+
+        const size_t _maxBuckets;
+        long long _bucketDepth;
+
+        BSONObj _lowerBound;
+        std::vector<Bucket> _buckets;
+
+        // The bucket being filled, and the run of equal values at its end.
+        Bucket _current;
+        BSONObj _currentValue;
+
+        long long _numKeys = 0;
+        long long _numDistinct = 0;
+    };
+
+    /**
+     * Returns the estimated number of keys whose leading field falls within 'interval'. The
+     * interval may be oriented in either direction.
+     */
+    double estimateKeys(const Interval& interval) const;
+
+    /**
+     * Returns the estimated number of keys whose leading field falls within any of the intervals
+     * of 'oil'.
+     */
+    double estimateKeys(const OrderedIntervalList& oil) const;
+
+    long long numKeys() const {
+        return _numKeys;
+    }
+
+    long long numDistinct() const {
+        return _numDistinct;
+    }
+
+    long long numRecords() const {
+        return _numRecords;
+    }
+
+    /**
+     * Average number of keys generated per document. Greater than one for multikey indexes.
+     */
+    double multikeyFanout() const {
+        return _numRecords > 0 ? static_cast<double>(_numKeys) / _numRecords : 1.0;
+    }
+
+    const std::vector<Bucket>& buckets() const {
+        return _buckets;
+    }
+
+    /**
+     * Returns true if the collection, which now holds 'numRecords' documents, has changed by more
+     * than 'maxChangeRatio' of its size when the statistics were gathered.
+     */
+    bool isStale(long long numRecords, double maxChangeRatio) const;
+
+    /**
+     * Appends a summary of the statistics, and the histogram when 'includeHistogram' is true.
+     */
+    void appendToBuilder(BSONObjBuilder* builder, bool includeHistogram) const;
+
+private:
+    IndexStatistics() = default;
+
+    BSONObj _lowerBound;
+    std::vector<Bucket> _buckets;
+    long long _numKeys = 0;
+    long long _numDistinct = 0;
+    long long _numRecords = 0;
+};
+
+/**
+ * Holds the IndexStatistics of a collection's indexes, keyed by index name. Owned by the
+ * collection's CollectionInfoCache. Readers hold on to the shared_ptr they were handed, so
+ * statistics may be replaced by a concurrent analyze without invalidating a plan estimate.
+ */
+class CollectionStatistics {
+    MONGO_DISALLOW_COPYING(CollectionStatistics);
+
+public:
+    CollectionStatistics() = default;
+
+    /**
+     * Returns the statistics for the named index, or nullptr if the index was never analyzed.
+     */
+    std::shared_ptr<const IndexStatistics> get(StringData indexName) const;
+
+    /**
+     * Adds or replaces the statistics for the named index.
+     */
+    void set(StringData indexName, std::shared_ptr<const IndexStatistics> stats);
+
+    /**
+     * Removes the statistics for the named index. No effect if there are none.
+     */
+    void remove(StringData indexName);
+
+    /**
+     * Removes the statistics of every index.
+     */
+    void clear();
+
+    bool empty() const;
+
+    /**
+     * Returns true if the statistics of any index are stale, as by IndexStatistics::isStale().
+     */
+    bool isStale(long long numRecords, double maxChangeRatio) const;
+
+private:
+    StringMap<std::shared_ptr<const IndexStatistics>> _statsByIndexName;
+
+    /**
+     * Protects '_statsByIndexName'.
+     */
+    mutable stdx::mutex _mutex;
+};
+
+}  // namespace mongo
@@ -0,0 +1,240 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/interval.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+void addKeys(IndexStatistics::Builder* builder, int value, int count) {
+    BSONObj key = BSON("" << value);
+    for (int i = 0; i < count; ++i) {
+        builder->addKey(key.firstElement());
+    }
+}
+
+Interval makeInterval(BSONObj bounds, bool startInclusive, bool endInclusive) {
+    return Interval(bounds, startInclusive, endInclusive);
+}
+
+Interval pointInterval(int value) {
+    return makeInterval(BSON("" << value << "" << value), true, true);
+}
+
+Interval allValues() {
+    BSONObjBuilder bob;
+    bob.appendMinKey("");
+    bob.appendMaxKey("");
+    return makeInterval(bob.obj(), true, true);
+}
+
+TEST(IndexStatisticsTest, EmptyIndex) {
+    IndexStatistics::Builder builder(10, 100);
+    auto stats = builder.done(0);
+    ASSERT_EQ(0, stats->numKeys());
+    ASSERT_EQ(0, stats->numDistinct());
+    ASSERT(stats->buckets().empty());
+    ASSERT_EQ(0, stats->estimateKeys(allValues()));
+}
+
+TEST(IndexStatisticsTest, UniformValuesFillEqualBuckets) {
+    IndexStatistics::Builder builder(10, 100);
+    for (int i = 0; i < 1000; ++i) {
+        addKeys(&builder, i, 1);
+    }
+    auto stats = builder.done(1000);
+    ASSERT_EQ(1000, stats->numKeys());
+    ASSERT_EQ(1000, stats->numDistinct());
+    ASSERT_EQ(10U, stats->buckets().size());
+    for (const auto& bucket : stats->buckets()) {
+        ASSERT_EQ(100, bucket.numKeys);
+    }
+
+    ASSERT_EQ(1000, stats->estimateKeys(allValues()));
+    ASSERT_APPROX_EQUAL(1.0, stats->estimateKeys(pointInterval(500)), 0.1);
+    ASSERT_APPROX_EQUAL(
+        100.0, stats->estimateKeys(makeInterval(BSON("" << 100 << "" << 199), true, true)), 2.0);
+    ASSERT_APPROX_EQUAL(
+        250.0, stats->estimateKeys(makeInterval(BSON("" << 0 << "" << 249), true, true)), 2.0);
+}
+
+TEST(IndexStatisticsTest, FrequentValueIsCountedExactly) {
+    IndexStatistics::Builder builder(10, 100);
+    addKeys(&builder, 0, 900);
+    for (int i = 1; i <= 100; ++i) {
+        addKeys(&builder, i, 1);
+    }
+    auto stats = builder.done(1000);
+    ASSERT_EQ(1000, stats->numKeys());
+    ASSERT_EQ(101, stats->numDistinct());
+
+    ASSERT_EQ(900, stats->estimateKeys(pointInterval(0)));
+    ASSERT_APPROX_EQUAL(1.0, stats->estimateKeys(pointInterval(50)), 0.1);
+
+    // Excluding the frequent value leaves only the rare ones.
+    BSONObjBuilder bob;
+    bob.append("", 0);
+    bob.appendMaxKey("");
+    ASSERT_EQ(100, stats->estimateKeys(makeInterval(bob.obj(), false, true)));
+}
+
+TEST(IndexStatisticsTest, ValuesOutsideTheHistogramAreEstimatedAsAbsent) {
+    IndexStatistics::Builder builder(10, 10);
+    for (int i = 100; i < 200; ++i) {
+        addKeys(&builder, i, 1);
+    }
+    auto stats = builder.done(100);
+    ASSERT_EQ(0, stats->estimateKeys(pointInterval(50)));
+    ASSERT_EQ(0, stats->estimateKeys(pointInterval(250)));
+    ASSERT_EQ(0, stats->estimateKeys(makeInterval(BSON("" << 0 << "" << 99), true, true)));
+}
+
+TEST(IndexStatisticsTest, DescendingIntervalsAreEstimatedLikeAscendingOnes) {
+    IndexStatistics::Builder builder(10, 10);
+    for (int i = 0; i < 100; ++i) {
+        addKeys(&builder, i, 3);
+    }
+    auto stats = builder.done(300);
+    ASSERT_EQ(stats->estimateKeys(makeInterval(BSON("" << 10 << "" << 40), true, false)),
+              stats->estimateKeys(makeInterval(BSON("" << 40 << "" << 10), false, true)));
+}
+
+TEST(IndexStatisticsTest, EmptyIntervalIsEstimatedAsNoKeys) {
+    IndexStatistics::Builder builder(10, 10);
+    addKeys(&builder, 5, 10);
+    auto stats = builder.done(10);
+    ASSERT_EQ(10, stats->estimateKeys(pointInterval(5)));
+    ASSERT_EQ(0, stats->estimateKeys(makeInterval(BSON("" << 5 << "" << 5), true, false)));
+}
+
+TEST(IndexStatisticsTest, BucketsAreMergedToStayWithinLimit) {
+    IndexStatistics::Builder builder(4, 1);
+    for (int i = 0; i < 100; ++i) {
+        addKeys(&builder, i, 1);
+    }
+    auto stats = builder.done(100);
+    ASSERT_LTE(stats->buckets().size(), 4U);
+
+    long long numKeys = 0;
+    long long numDistinct = 0;
+    for (const auto& bucket : stats->buckets()) {
+        numKeys += bucket.numKeys;
+        numDistinct += bucket.numDistinct;
+    }
+    ASSERT_EQ(100, numKeys);
+    ASSERT_EQ(100, numDistinct);
+    ASSERT_EQ(100, stats->estimateKeys(allValues()));
+}
+
+TEST(IndexStatisticsTest, OrderedIntervalListSumsIntervals) {
+    IndexStatistics::Builder builder(10, 10);
+    for (int i = 0; i < 100; ++i) {
+        addKeys(&builder, i, 2);
+    }
+    auto stats = builder.done(200);
+
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(pointInterval(9));
+    oil.intervals.push_back(pointInterval(19));
+    oil.intervals.push_back(pointInterval(29));
+    ASSERT_EQ(6, stats->estimateKeys(oil));
+}
+
+TEST(IndexStatisticsTest, MultikeyFanout) {
+    IndexStatistics::Builder builder(10, 10);
+    for (int i = 0; i < 100; ++i) {
+        addKeys(&builder, i, 3);
+    }
+    auto stats = builder.done(100);
+    ASSERT_EQ(300, stats->numKeys());
+    ASSERT_EQ(3.0, stats->multikeyFanout());
+}
+
+TEST(IndexStatisticsTest, StaleOnceCollectionSizeChanges) {
+    IndexStatistics::Builder builder(10, 100);
+    addKeys(&builder, 1, 1000);
+    auto stats = builder.done(1000);
+    ASSERT_FALSE(stats->isStale(1000, 0.1));
+    ASSERT_FALSE(stats->isStale(1100, 0.1));
+    ASSERT_FALSE(stats->isStale(900, 0.1));
+    ASSERT_TRUE(stats->isStale(1101, 0.1));
+    ASSERT_TRUE(stats->isStale(899, 0.1));
+
+    // Any document inserted into a collection analyzed while empty makes its statistics stale.
+    IndexStatistics::Builder emptyBuilder(10, 100);
+    auto emptyStats = emptyBuilder.done(0);
+    ASSERT_FALSE(emptyStats->isStale(0, 0.1));
+    ASSERT_TRUE(emptyStats->isStale(1, 0.1));
+}
+
+TEST(CollectionStatisticsTest, SetGetRemove) {
+    CollectionStatistics collStats;
+    ASSERT(collStats.empty());
+    ASSERT(!collStats.get("a_1"));
+
+    IndexStatistics::Builder builder(10, 10);
+    addKeys(&builder, 1, 1);
+    std::shared_ptr<const IndexStatistics> stats = builder.done(1);
+    collStats.set("a_1", stats);
+    collStats.set("b_1", stats);
+    ASSERT(!collStats.empty());
+    ASSERT_EQ(stats, collStats.get("a_1"));
+
+    collStats.remove("a_1");
+    ASSERT(!collStats.get("a_1"));
+    ASSERT_EQ(stats, collStats.get("b_1"));
+
+    collStats.clear();
+    ASSERT(collStats.empty());
+}
+
+TEST(CollectionStatisticsTest, StaleIfAnyIndexIsStale) {
+    CollectionStatistics collStats;
+    ASSERT_FALSE(collStats.isStale(1000, 0.1));
+
+    IndexStatistics::Builder oldBuilder(10, 10);
+    addKeys(&oldBuilder, 1, 1);
+    collStats.set("a_1", oldBuilder.done(100));
+    IndexStatistics::Builder newBuilder(10, 10);
+    addKeys(&newBuilder, 1, 1);
+    collStats.set("b_1", newBuilder.done(1000));
+
+    ASSERT_TRUE(collStats.isStale(1000, 0.1));
+    collStats.remove("a_1");
+    ASSERT_FALSE(collStats.isStale(1000, 0.1));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -62,6 +62,10 @@ public:
         // The client wants the fetched object and the RecordId that refers to it.  Delegating
         // the fetch to the runner allows fetching outside of a lock.
         IXSCAN_FETCH = 1,
+
+        // The client wants every key of a multikey index, rather than only the first key of each
+        // record.
+        IXSCAN_NO_DEDUP = 2,
     };
 
     /**
@@ -169,6 +169,23 @@ public:
         return Status::OK();
     }
 
+    /**
+     * Removes the least recently used entry from the kv-store and passes ownership of it to the
+     * caller. Returns a null unique_ptr if the kv-store is empty.
+     *
+     * Lets callers enforce a budget other than the number of entries, for example one in bytes.
+     */
+    std::unique_ptr<V> removeLeastRecentlyUsed() {
+        if (_kvList.empty()) {
+            return std::unique_ptr<V>();
+        }
+        V* evictedEntry = _kvList.back().second;
+        _kvMap.erase(_kvList.back().first);
+        _kvList.pop_back();
+        _currentSize--;
+        return std::unique_ptr<V>(evictedEntry);
+    }
+
     /**
      * Deletes all entries in the kv-store.
      */
@@ -175,6 +175,34 @@ TEST(LRUKeyValueTest, ReplaceKeyTest) {
     assertInKVStore(cache, 4, 5);
 }
 
+/**
+ * Test that removeLeastRecentlyUsed() hands back entries in LRU order, taking promotions made by
+ * get() into account.
+ */
+TEST(LRUKeyValueTest, RemoveLeastRecentlyUsedTest) {
+    LRUKeyValue<int, int> cache(10);
+    ASSERT(NULL == cache.removeLeastRecentlyUsed().get());
+
+    cache.add(1, new int(1));
+    cache.add(2, new int(2));
+    cache.add(3, new int(3));
+
+    // Promote 1 so that 2 becomes the least recently used entry.
+    assertInKVStore(cache, 1, 1);
+
+    std::unique_ptr<int> evicted = cache.removeLeastRecentlyUsed();
+    ASSERT_EQUALS(*evicted, 2);
+    ASSERT_EQUALS(cache.size(), 2U);
+    assertNotInKVStore(cache, 2);
+
+    evicted = cache.removeLeastRecentlyUsed();
+    ASSERT_EQUALS(*evicted, 3);
+    evicted = cache.removeLeastRecentlyUsed();
+    ASSERT_EQUALS(*evicted, 1);
+    ASSERT_EQUALS(cache.size(), 0U);
+    ASSERT(NULL == cache.removeLeastRecentlyUsed().get());
+}
+
 /**
  * Test iteration over the kv-store.
  */
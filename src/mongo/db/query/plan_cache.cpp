@@ -33,6 +33,7 @@
 #include "mongo/db/query/plan_cache.h"
 
 #include <algorithm>
+#include <functional>
 #include <math.h>
 #include <memory>
 #include <vector>
@@ -249,6 +250,38 @@ void encodeGeoNearMatchExpression(const GeoNearMatchExpression* tree, StringBuil
     }
 }
 
+// Allowance for the stage-specific stats of a plan stage whose size is not estimated in detail.
+const size_t kSpecificStatsSizeEstimate = 128;
+
+size_t estimateIndexTreeSize(const PlanCacheIndexTree& tree) {
+    size_t size =
+        sizeof(tree) + tree.orPushdowns.capacity() * sizeof(PlanCacheIndexTree::OrPushdown);
+    if (tree.entry) {
+        size += sizeof(IndexEntry) + tree.entry->keyPattern.objsize() +
+            tree.entry->infoObj.objsize() + tree.entry->name.capacity();
+    }
+    for (const PlanCacheIndexTree* child : tree.children) {
+        size += estimateIndexTreeSize(*child);
+    }
+    return size;
+}
+
+size_t estimateStatsSize(const PlanStageStats& stats) {
+    size_t size = sizeof(stats);
+    if (stats.specific) {
+        size += kSpecificStatsSizeEstimate;
+        // Index scans carry their bounds, which grow with the size of $in lists.
+        if (STAGE_IXSCAN == stats.stageType) {
+            auto ixStats = static_cast<const IndexScanStats*>(stats.specific.get());
+            size += ixStats->keyPattern.objsize() + ixStats->indexBounds.objsize();
+        }
+    }
+    for (const auto& child : stats.children) {
+        size += estimateStatsSize(*child);
+    }
+    return size;
+}
+
 }  // namespace
 
 //
@@ -385,9 +418,39 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
         fb->score = feedback[i]->score;
         entry->feedback.push_back(fb);
     }
+
+    // Copy usage stats.
+    entry->hits = hits;
+    entry->works = works;
+    entry->replans = replans;
+    entry->estimatedEntrySizeBytes = estimatedEntrySizeBytes;
     return entry;
 }
 
+size_t PlanCacheEntryFeedback::estimateObjectSizeInBytes() const {
+    return sizeof(*this) + (stats ? estimateStatsSize(*stats) : 0);
+}
+
+size_t PlanCacheEntry::estimateObjectSizeInBytes() const {
+    size_t size = sizeof(*this) + query.objsize() + sort.objsize() + projection.objsize() +
+        collation.objsize();
+    for (const SolutionCacheData* scd : plannerData) {
+        size += sizeof(*scd);
+        if (scd->tree) {
+            size += estimateIndexTreeSize(*scd->tree);
+        }
+    }
+    for (const auto& stats : decision->stats) {
+        size += estimateStatsSize(*stats);
+    }
+    size += decision->scores.capacity() * sizeof(double) +
+        decision->candidateOrder.capacity() * sizeof(size_t);
+    for (const PlanCacheEntryFeedback* fb : feedback) {
+        size += fb->estimateObjectSizeInBytes();
+    }
+    return size;
+}
+
 std::string PlanCacheEntry::toString() const {
     return str::stream() << "(query: " << query.toString() << ";sort: " << sort.toString()
                          << ";projection: " << projection.toString()
@@ -486,6 +549,10 @@ std::string SolutionCacheData::toString() const {
                                  << "tree=" << this->tree->toString() << ")";
         case COLLSCAN_SOLN:
             return "(collection scan)";
+        case SKIP_SCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
         case USE_INDEX_TAGS_SOLN:
             verify(this->tree.get());
             return str::stream() << "(index-tagged expression tree: "
@@ -498,9 +565,17 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : _cache(internalQueryCacheSize.load()) {}
+PlanCache::PlanCache() : PlanCache("") {}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns) : _ns(ns) {
+    // Split the entry limit evenly between the partitions, rounding up so that a small limit does
+    // not leave a partition unable to hold anything.
+    const size_t maxEntries = std::max(internalQueryCacheSize.load(), 0);
+    const size_t maxEntriesPerPartition = (maxEntries + kNumPartitions - 1) / kNumPartitions;
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>(maxEntriesPerPartition));
+    }
+}
 
 PlanCache::~PlanCache() {}
 
@@ -676,30 +751,60 @@ Status PlanCache::add(const CanonicalQuery& query,
         projBuilder.append(elem);
     }
     entry->projection = projBuilder.obj();
-
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(computeKey(query), entry);
-
-    if (NULL != evictedEntry.get()) {
+    entry->estimatedEntrySizeBytes = entry->estimateObjectSizeInBytes();
+
+    const PlanCacheKey key = computeKey(query);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
+
+    // A query shape that is already cached is being replanned. The new entry keeps the usage
+    // stats of the one it replaces.
+    PlanCacheEntry* replacedEntry;
+    if (partition.cache.get(key, &replacedEntry).isOK()) {
+        entry->hits = replacedEntry->hits;
+        entry->works = replacedEntry->works;
+        entry->replans = replacedEntry->replans + 1;
+        partition.bytes -= replacedEntry->estimatedEntrySizeBytes;
+    }
+
+    partition.bytes += entry->estimatedEntrySizeBytes;
+    std::unique_ptr<PlanCacheEntry> evictedEntry = partition.cache.add(key, entry);
+    if (evictedEntry) {
+        partition.bytes -= evictedEntry->estimatedEntrySizeBytes;
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
                << "removed least recently used entry " << redact(evictedEntry->toString());
     }
 
+    evictOverBudget(&partition);
     return Status::OK();
 }
 
+void PlanCache::evictOverBudget(Partition* partition) const {
+    const size_t maxBytesPerPartition =
+        std::max(internalQueryCacheMaxSizeBytes.load(), 0LL) / kNumPartitions;
+    while (partition->bytes > maxBytesPerPartition) {
+        std::unique_ptr<PlanCacheEntry> evictedEntry = partition->cache.removeLeastRecentlyUsed();
+        invariant(evictedEntry);
+        partition->bytes -= evictedEntry->estimatedEntrySizeBytes;
+        LOG(1) << _ns << ": plan cache maximum size exceeded - "
+               << "removed least recently used entry " << redact(evictedEntry->toString());
+    }
+}
+
 Status PlanCache::get(const CanonicalQuery& query, CachedSolution** crOut) const {
     PlanCacheKey key = computeKey(query);
     verify(crOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
     invariant(entry);
 
+    ++entry->hits;
     *crOut = new CachedSolution(key, *entry);
 
     return Status::OK();
@@ -712,30 +817,51 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     std::unique_ptr<PlanCacheEntryFeedback> autoFeedback(feedback);
     PlanCacheKey ck = computeKey(cq);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = getPartition(ck);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
+    Status cacheStatus = partition.cache.get(ck, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
     invariant(entry);
 
-    // We store up to a constant number of feedback entries.
+    if (autoFeedback->stats) {
+        entry->works += autoFeedback->stats->common.works;
+    }
+
+    // We store up to a constant number of feedback entries. Their stats trees can be as large as
+    // the rest of the entry, so they count towards the partition's budget.
     if (entry->feedback.size() < static_cast<size_t>(internalQueryCacheFeedbacksStored.load())) {
+        const size_t feedbackBytes = autoFeedback->estimateObjectSizeInBytes();
         entry->feedback.push_back(autoFeedback.release());
+        entry->estimatedEntrySizeBytes += feedbackBytes;
+        partition.bytes += feedbackBytes;
+        evictOverBudget(&partition);
     }
 
     return Status::OK();
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    const PlanCacheKey key = computeKey(canonicalQuery);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
+    PlanCacheEntry* entry;
+    Status cacheStatus = partition.cache.get(key, &entry);
+    if (!cacheStatus.isOK()) {
+        return cacheStatus;
+    }
+    partition.bytes -= entry->estimatedEntrySizeBytes;
+    return partition.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> partitionLock(partition->mutex);
+        partition->cache.clear();
+        partition->bytes = 0;
+    }
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -750,9 +876,10 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
     PlanCacheKey key = computeKey(query);
     verify(entryOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -764,25 +891,46 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
 }
 
 std::vector<PlanCacheEntry*> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<PlanCacheEntry*> entries;
     typedef std::list<std::pair<PlanCacheKey, PlanCacheEntry*>>::const_iterator ConstIterator;
-    for (ConstIterator i = _cache.begin(); i != _cache.end(); i++) {
-        PlanCacheEntry* entry = i->second;
-        entries.push_back(entry->clone());
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> partitionLock(partition->mutex);
+        for (ConstIterator i = partition->cache.begin(); i != partition->cache.end(); i++) {
+            PlanCacheEntry* entry = i->second;
+            entries.push_back(entry->clone());
+        }
     }
 
     return entries;
 }
 
 bool PlanCache::contains(const CanonicalQuery& cq) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.hasKey(computeKey(cq));
+    const PlanCacheKey key = computeKey(cq);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
+    return partition.cache.hasKey(key);
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t size = 0;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> partitionLock(partition->mutex);
+        size += partition->cache.size();
+    }
+    return size;
+}
+
+size_t PlanCache::sizeBytes() const {
+    size_t bytes = 0;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> partitionLock(partition->mutex);
+        bytes += partition->bytes;
+    }
+    return bytes;
+}
+
+PlanCache::Partition& PlanCache::getPartition(const PlanCacheKey& key) const {
+    return *_partitions[std::hash<PlanCacheKey>()(key) % kNumPartitions];
 }
 
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
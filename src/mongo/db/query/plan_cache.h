@@ -54,6 +54,11 @@ struct QuerySolutionNode;
  * feedback is available to anyone who retrieves that query in the future.
  */
 struct PlanCacheEntryFeedback {
+    /**
+     * Returns an estimate of the number of bytes held by this feedback.
+     */
+    size_t estimateObjectSizeInBytes() const;
+
     // How well did the cached plan perform?
     std::unique_ptr<PlanStageStats> stats;
 
@@ -174,6 +179,10 @@ struct SolutionCacheData {
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
+        // The cached plan is a skip scan of the index
+        // whose IndexEntry is stored in 'tree'.
+        SKIP_SCAN_SOLN,
+
         // Build the solution by using 'tree'
         // to tag the match expression.
         USE_INDEX_TAGS_SOLN
@@ -249,6 +258,13 @@ public:
     // For debugging.
     std::string toString() const;
 
+    /**
+     * Returns an estimate of the memory held by this entry: the query shape, the planner data
+     * and the ranking stats of every candidate plan. Queries with large $in lists produce large
+     * shapes and index bounds, so the plan cache budgets itself on this estimate.
+     */
+    size_t estimateObjectSizeInBytes() const;
+
     //
     // Planner data
     //
@@ -279,6 +295,23 @@ public:
     // Annotations from cached runs.  The CachedPlanStage provides these stats about its
     // runs when they complete.
     std::vector<PlanCacheEntryFeedback*> feedback;
+
+    //
+    // Usage stats. Maintained by the PlanCache under the lock of the partition holding the entry,
+    // and carried over when the entry is replaced by a replanned one.
+    //
+
+    // Number of times the entry was handed out by PlanCache::get().
+    uint64_t hits = 0;
+
+    // Sum of the works of the cached runs reported through PlanCache::feedback().
+    uint64_t works = 0;
+
+    // Number of times the entry for this query shape was replaced by a newly planned one.
+    uint64_t replans = 0;
+
+    // Value of estimateObjectSizeInBytes() when the entry was added to the cache.
+    size_t estimatedEntrySizeBytes = 0;
 };
 
 /**
@@ -286,6 +319,9 @@ public:
  * mapping, the cache contains information on why that mapping was made and statistics on the
  * cache entry's actual performance on subsequent runs.
  *
+ * Entries are spread over a fixed number of partitions by a hash of their key. Each partition has
+ * its own mutex, LRU list and share of the byte budget, so lookups of different query shapes on a
+ * hot collection do not serialize on a single lock.
  */
 class PlanCache {
 private:
@@ -402,6 +438,11 @@ public:
      */
     size_t size() const;
 
+    /**
+     * Returns the sum of the estimated sizes of the entries in the cache.
+     */
+    size_t sizeBytes() const;
+
     /**
      * Updates internal state kept about the collection's indexes.  Must be called when the set
      * of indexes on the associated collection have changed.
@@ -415,10 +456,32 @@ private:
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
+    /**
+     * One slice of the cache. A key always maps to the same partition.
+     */
+    struct Partition {
+        explicit Partition(size_t maxEntries) : cache(maxEntries) {}
+
+        // Protects 'cache' and 'bytes', and the usage stats of the entries in 'cache'.
+        stdx::mutex mutex;
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry> cache;
+
+        // Sum of the estimatedEntrySizeBytes of the entries in 'cache'.
+        size_t bytes = 0;
+    };
+
+    static const size_t kNumPartitions = 16;
+
+    Partition& getPartition(const PlanCacheKey& key) const;
+
+    /**
+     * Removes least recently used entries from 'partition' until its entries fit in its share of
+     * internalQueryCacheMaxSizeBytes. The caller must hold the partition's mutex.
+     */
+    void evictOverBudget(Partition* partition) const;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Full namespace of collection.
     std::string _ns;
@@ -423,6 +423,137 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+TEST(PlanCacheTest, EntryTracksHitsWorksAndReplans) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+    ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+
+    for (int i = 0; i < 2; ++i) {
+        CachedSolution* rawCachedSolution;
+        ASSERT_OK(planCache.get(*cq, &rawCachedSolution));
+        delete rawCachedSolution;
+    }
+
+    auto feedback = stdx::make_unique<PlanCacheEntryFeedback>();
+    CommonStats common("COLLSCAN");
+    common.works = 7;
+    feedback->stats = stdx::make_unique<PlanStageStats>(common, STAGE_COLLSCAN);
+    feedback->score = 1.0;
+    ASSERT_OK(planCache.feedback(*cq, feedback.release()));
+
+    PlanCacheEntry* rawEntry;
+    ASSERT_OK(planCache.getEntry(*cq, &rawEntry));
+    unique_ptr<PlanCacheEntry> entry(rawEntry);
+    ASSERT_EQUALS(entry->hits, 2U);
+    ASSERT_EQUALS(entry->works, 7U);
+    ASSERT_EQUALS(entry->replans, 0U);
+
+    // Replanning the shape replaces the entry but keeps its usage stats.
+    ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+    ASSERT_OK(planCache.getEntry(*cq, &rawEntry));
+    entry.reset(rawEntry);
+    ASSERT_EQUALS(entry->hits, 2U);
+    ASSERT_EQUALS(entry->works, 7U);
+    ASSERT_EQUALS(entry->replans, 1U);
+    ASSERT_EQUALS(entry->feedback.size(), 0U);
+    ASSERT_EQUALS(planCache.size(), 1U);
+}
+
+TEST(PlanCacheTest, EvictsEntriesLargerThanByteBudget) {
+    const long long oldMaxSizeBytes = internalQueryCacheMaxSizeBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryCacheMaxSizeBytes.store(oldMaxSizeBytes); });
+
+    BSONArrayBuilder inList;
+    for (int i = 0; i < 1000; ++i) {
+        inList.append(i);
+    }
+    unique_ptr<CanonicalQuery> smallCq(canonicalize("{a: 1}"));
+    unique_ptr<CanonicalQuery> largeCq(canonicalize(BSON("b" << BSON("$in" << inList.arr()))));
+
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+
+    // Measure both entries with the default budget, which holds them easily.
+    PlanCache planCache;
+    ASSERT_OK(planCache.add(*smallCq, solns, createDecision(1U)));
+    const size_t smallBytes = planCache.sizeBytes();
+    ASSERT_OK(planCache.add(*largeCq, solns, createDecision(1U)));
+    const size_t largeBytes = planCache.sizeBytes() - smallBytes;
+    ASSERT_GREATER_THAN(largeBytes, smallBytes);
+    ASSERT_EQUALS(planCache.size(), 2U);
+
+    ASSERT_OK(planCache.remove(*largeCq));
+    ASSERT_EQUALS(planCache.sizeBytes(), smallBytes);
+    planCache.clear();
+    ASSERT_EQUALS(planCache.sizeBytes(), 0U);
+
+    // Give each of the 16 partitions room for the small entry but not for the large one. The
+    // large entry goes in first so that it cannot push the small one out of a shared partition.
+    internalQueryCacheMaxSizeBytes.store(16 * (smallBytes + (largeBytes - smallBytes) / 2));
+    ASSERT_OK(planCache.add(*largeCq, solns, createDecision(1U)));
+    ASSERT_FALSE(planCache.contains(*largeCq));
+    ASSERT_OK(planCache.add(*smallCq, solns, createDecision(1U)));
+    ASSERT_TRUE(planCache.contains(*smallCq));
+    ASSERT_FALSE(planCache.contains(*largeCq));
+    ASSERT_EQUALS(planCache.size(), 1U);
+    ASSERT_EQUALS(planCache.sizeBytes(), smallBytes);
+}
+
+TEST(PlanCacheTest, FeedbackCountsTowardsByteBudget) {
+    const long long oldMaxSizeBytes = internalQueryCacheMaxSizeBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryCacheMaxSizeBytes.store(oldMaxSizeBytes); });
+
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+
+    // Feedback from an index scan over a long $in list carries its bounds.
+    BSONArrayBuilder inList;
+    for (int i = 0; i < 1000; ++i) {
+        inList.append(BSON_ARRAY(i << i));
+    }
+    const BSONObj bounds = BSON("a" << inList.arr());
+    auto makeFeedback = [&bounds] {
+        auto feedback = stdx::make_unique<PlanCacheEntryFeedback>();
+        auto ixStats = stdx::make_unique<IndexScanStats>();
+        ixStats->indexBounds = bounds;
+        feedback->stats =
+            stdx::make_unique<PlanStageStats>(CommonStats("IXSCAN"), STAGE_IXSCAN);
+        feedback->stats->specific = std::move(ixStats);
+        feedback->score = 1.0;
+        return feedback.release();
+    };
+
+    PlanCache planCache;
+    ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+    const size_t entryBytes = planCache.sizeBytes();
+    ASSERT_OK(planCache.feedback(*cq, makeFeedback()));
+    const size_t feedbackBytes = planCache.sizeBytes() - entryBytes;
+    ASSERT_GREATER_THAN(feedbackBytes, static_cast<size_t>(bounds.objsize()));
+
+    PlanCacheEntry* rawEntry;
+    ASSERT_OK(planCache.getEntry(*cq, &rawEntry));
+    unique_ptr<PlanCacheEntry> entry(rawEntry);
+    ASSERT_EQUALS(entry->estimatedEntrySizeBytes, entryBytes + feedbackBytes);
+
+    // Give each partition room for the entry with one feedback but not with two.
+    internalQueryCacheMaxSizeBytes.store(16 * (entryBytes + feedbackBytes + feedbackBytes / 2));
+    ASSERT_OK(planCache.feedback(*cq, makeFeedback()));
+    ASSERT_FALSE(planCache.contains(*cq));
+    ASSERT_EQUALS(planCache.sizeBytes(), 0U);
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
@@ -1316,6 +1447,49 @@ TEST_F(CachePlanSelectionTest, ContainedOrAndIntersection) {
         "]}}}}");
 }
 
+//
+// Skip scans
+//
+
+TEST_F(CachePlanSelectionTest, SkipScan) {
+    addIndex(BSON("a" << 1 << "b" << 1), "a_1_b_1");
+    params.skipScanIndices.insert("a_1_b_1");
+    BSONObj query = fromjson("{b: {$gt: 2, $lte: 5}}");
+    runQuery(query);
+    assertPlanCacheRecoversSolution(
+        query,
+        "{fetch: {filter: {b: {$gt: 2, $lte: 5}}, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey', 'MaxKey', true, true]], b: [[2, 5, false, true]]}}}}}");
+    assertPlanCacheRecoversSolution(query, "{cscan: {dir: 1}}");
+}
+
+TEST_F(CachePlanSelectionTest, SkipScanIsNotRecoveredOnceIndexIsIneligible) {
+    addIndex(BSON("a" << 1 << "b" << 1), "a_1_b_1");
+    params.skipScanIndices.insert("a_1_b_1");
+    BSONObj query = fromjson("{b: 3}");
+    runQuery(query);
+    QuerySolution* skipScan =
+        firstMatchingSolution("{fetch: {filter: {b: 3}, node: {ixscan: {pattern: {a: 1, b: 1}}}}}");
+
+    // For instance, the index's statistics now show too many distinct values of 'a'.
+    params.skipScanIndices.clear();
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(query);
+    auto cq = assertGet(CanonicalQuery::canonicalize(
+        opCtx.get(), std::move(qr), ExtensionsCallbackDisallowExtensions()));
+
+    QuerySolution qs;
+    qs.cacheData.reset(skipScan->cacheData->clone());
+    std::vector<QuerySolution*> solutions;
+    solutions.push_back(&qs);
+    PlanCacheEntry entry(solutions, createDecision(1U));
+    CachedSolution cachedSoln(ck, entry);
+    QuerySolution* out;
+    ASSERT_NOT_OK(QueryPlanner::planFromCache(*cq, params, cachedSoln, &out));
+}
+
 /**
  * Test functions for computeKey.  Cache keys are intentionally obfuscated and are
  * meaningful only within the current lifetime of the server process. Users should treat plan
@@ -45,6 +45,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
@@ -1283,6 +1284,72 @@ QuerySolutionNode* QueryPlannerAccess::scanWholeIndex(const IndexEntry& index,
     return solnRoot;
 }
 
+// static
+QuerySolutionNode* QueryPlannerAccess::makeSkipScan(const IndexEntry& index,
+                                                    const CanonicalQuery& query,
+                                                    const QueryPlannerParams& params) {
+    // Only the top-level predicates of the query constrain every result.
+    std::vector<MatchExpression*> predicates;
+    MatchExpression* root = query.root();
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    unique_ptr<IndexScanNode> isn = make_unique<IndexScanNode>(index);
+    isn->maxScan = query.getQueryRequest().getMaxScan();
+    isn->addKeyMetadata = query.getQueryRequest().returnKey();
+    isn->queryCollator = query.getCollator();
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+
+    bool hasBounds = false;
+    BSONObjIterator it(index.keyPattern);
+    for (size_t pos = 0; it.more(); ++pos) {
+        BSONElement elt = it.next();
+        OrderedIntervalList* oil = &isn->bounds.fields[pos];
+        oil->name = elt.fieldName();
+
+        // The leading field is never constrained, see QueryPlannerIXSelect::findSkipScanIndices.
+        bool translated = false;
+        for (size_t i = 0; pos > 0 && i < predicates.size(); ++i) {
+            MatchExpression* pred = predicates[i];
+            if (!Indexability::nodeCanUseIndexOnOwnField(pred) ||
+                pred->path() != elt.fieldNameStringData() ||
+                !QueryPlannerIXSelect::compatible(elt, index, pred, query.getCollator())) {
+                continue;
+            }
+
+            // The whole query is evaluated by the fetch, so the tightness doesn't matter.
+            IndexBoundsBuilder::BoundsTightness tightness;
+            if (translated) {
+                IndexBoundsBuilder::translateAndIntersect(pred, elt, index, oil, &tightness);
+            } else {
+                IndexBoundsBuilder::translate(pred, elt, index, oil, &tightness);
+                translated = true;
+            }
+        }
+
+        if (!translated) {
+            IndexBoundsBuilder::allValuesForField(elt, oil);
+        }
+        hasBounds = hasBounds || translated;
+    }
+
+    if (!hasBounds) {
+        return NULL;
+    }
+
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    unique_ptr<FetchNode> fetch = make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return fetch.release();
+}
+
 // static
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
@@ -197,6 +197,16 @@ public:
                                              const QueryPlannerParams& params,
                                              int direction = 1);
 
+    /**
+     * Return a plan that skip-scans the provided compound index. The leading field of the index
+     * is scanned in full while the bounds of the other fields come from the top-level predicates
+     * of 'query', so the index scan seeks past each distinct value of the leading field as soon
+     * as its keys leave the bounds. Returns NULL if no predicate generates bounds on the index.
+     */
+    static QuerySolutionNode* makeSkipScan(const IndexEntry& index,
+                                           const CanonicalQuery& query,
+                                           const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
@@ -164,6 +164,37 @@ void QueryPlannerIXSelect::findRelevantIndices(const unordered_set<string>& fiel
     }
 }
 
+// static
+void QueryPlannerIXSelect::findSkipScanIndices(const unordered_set<string>& fields,
+                                               const vector<IndexEntry>& allIndices,
+                                               const std::set<string>& skipScanIndices,
+                                               vector<IndexEntry>* out) {
+    for (const auto& index : allIndices) {
+        if (!skipScanIndices.count(index.name) || index.keyPattern.nFields() < 2) {
+            continue;
+        }
+
+        // Intersecting bounds is only safe on indices that are not multikey, and documents
+        // missing from sparse or partial indices would be missed by the scan.
+        if (INDEX_BTREE != index.type || index.multikey || index.sparse || index.filterExpr) {
+            continue;
+        }
+
+        BSONObjIterator it(index.keyPattern);
+        if (fields.count(it.next().fieldName())) {
+            // The index is relevant already.
+            continue;
+        }
+
+        while (it.more()) {
+            if (fields.count(it.next().fieldName())) {
+                out->push_back(index);
+                break;
+            }
+        }
+    }
+}
+
 // static
 bool QueryPlannerIXSelect::compatible(const BSONElement& elt,
                                       const IndexEntry& index,
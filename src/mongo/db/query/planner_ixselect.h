@@ -28,6 +28,9 @@
 
 #pragma once
 
+#include <set>
+#include <string>
+
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/index_entry.h"
 #include "mongo/db/query/query_solution.h"
@@ -61,6 +64,16 @@ public:
                                     const std::vector<IndexEntry>& indices,
                                     std::vector<IndexEntry>* out);
 
+    /**
+     * Find the indices named in 'skipScanIndices' which can be skip-scanned: compound btree
+     * indices with predicates over some of their non-leading fields but not over their leading
+     * field.
+     */
+    static void findSkipScanIndices(const unordered_set<std::string>& fields,
+                                    const std::vector<IndexEntry>& indices,
+                                    const std::set<std::string>& skipScanIndices,
+                                    std::vector<IndexEntry>* out);
+
     /**
      * Return true if the index key pattern field 'elt' (which belongs to 'index') can be used
      * to answer the predicate 'node'.
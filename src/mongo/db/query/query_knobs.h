@@ -57,6 +57,25 @@ extern AtomicBool internalQueryPlannerEnableIndexIntersection;
 // Do we use hash-based intersection for rooted $and queries?
 extern AtomicBool internalQueryPlannerEnableHashIntersection;
 
+// Do we use the index statistics gathered by the analyze command to discard candidate plans before
+// ranking them?
+extern AtomicBool internalQueryPlannerUseIndexStatistics;
+
+// A candidate plan is discarded without being ranked if its estimated number of keys examined is
+// more than this many times that of the cheapest candidate.
+extern AtomicDouble internalQueryPlannerIndexStatisticsDominanceRatio;
+
+// How many buckets does the analyze command keep in the histogram of each index?
+extern AtomicInt32 internalQueryIndexStatisticsHistogramBuckets;
+
+// Index statistics are ignored by the planner once the number of documents in the collection has
+// changed by more than this fraction since the analyze command gathered them.
+extern AtomicDouble internalQueryIndexStatisticsMaxChangeRatio;
+
+// A compound index whose leading field the query leaves unconstrained may be skip-scanned if the
+// analyze command found at most this many distinct values of that field. Zero disables skip scans.
+extern AtomicInt32 internalQueryPlannerMaxSkipScanPrefixes;
+
 //
 // plan cache
 //
@@ -64,6 +83,10 @@ extern AtomicBool internalQueryPlannerEnableHashIntersection;
 // How many entries in the cache?
 extern AtomicInt32 internalQueryCacheSize;
 
+// How many bytes may the entries of a collection's plan cache hold in total? Entries are evicted
+// in LRU order once their estimated size exceeds this budget.
+extern AtomicInt64 internalQueryCacheMaxSizeBytes;
+
 // How many feedback entries do we collect before possibly evicting from the cache based on bad
 // performance?
 extern AtomicInt32 internalQueryCacheFeedbacksStored;
@@ -104,6 +127,10 @@ extern AtomicInt32 internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// Number of index scan results a FETCH stage below a blocking sort buffers and then fetches in
+// RecordId order. One disables batching.
+extern AtomicInt32 internalQueryExecFetchBatchSize;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
@@ -114,4 +141,8 @@ extern AtomicInt32 internalInsertMaxBatchSize;
 
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
+// The number of input documents $group evaluates before passing them to its accumulators. A value
+// of 1 processes each document as soon as it is read.
+extern AtomicInt32 internalDocumentSourceGroupBatchSize;
+
 }  // namespace mongo
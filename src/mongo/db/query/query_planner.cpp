@@ -443,6 +443,30 @@ Status QueryPlanner::planFromCache(const CanonicalQuery& query,
             *out = soln;
             return Status::OK();
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        // The index may no longer be eligible for a skip scan, for instance if it has become
+        // multikey or its statistics now show too many distinct prefixes.
+        unordered_set<string> fields;
+        QueryPlannerIXSelect::getFields(query.root(), "", &fields);
+        vector<IndexEntry> skipScanIndices;
+        QueryPlannerIXSelect::findSkipScanIndices(
+            fields, params.indices, params.skipScanIndices, &skipScanIndices);
+
+        QuerySolution* soln = NULL;
+        for (const auto& index : skipScanIndices) {
+            if (index.name != winnerCacheData.tree->entry->name) {
+                continue;
+            }
+            if (QuerySolutionNode* solnRoot =
+                    QueryPlannerAccess::makeSkipScan(index, query, params)) {
+                soln = QueryPlannerAnalysis::analyzeDataAccess(query, params, solnRoot);
+            }
+        }
+        if (soln == NULL) {
+            return Status(ErrorCodes::BadValue, "plan cache error: skip scan soln");
+        }
+        *out = soln;
+        return Status::OK();
     }
 
     // SolutionCacheData::USE_TAGS_SOLN == cacheData->solnType
@@ -906,6 +930,40 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         return Status::OK();
     }
 
+    // If no index has a predicate over its leading field, a compound index with few distinct
+    // values of that field can still be skip-scanned. Such plans compete with the collection
+    // scan, and whichever wins is cached.
+    size_t numSkipScans = 0;
+    if (out->empty() && !params.skipScanIndices.empty() && !isTailable &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+        vector<IndexEntry> skipScanIndices;
+        QueryPlannerIXSelect::findSkipScanIndices(
+            fields, params.indices, params.skipScanIndices, &skipScanIndices);
+
+        for (const auto& index : skipScanIndices) {
+            QuerySolutionNode* solnRoot = QueryPlannerAccess::makeSkipScan(index, query, params);
+            if (!solnRoot) {
+                continue;
+            }
+
+            QuerySolution* soln = QueryPlannerAnalysis::analyzeDataAccess(query, params, solnRoot);
+            if (soln) {
+                PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+                indexTree->setIndexEntry(index);
+                SolutionCacheData* scd = new SolutionCacheData();
+                scd->tree.reset(indexTree);
+                scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+                soln->cacheData.reset(scd);
+
+                LOG(5) << "Planner: outputting skip scan of index " << index.name << ":" << endl
+                       << redact(soln->toString());
+                out->push_back(soln);
+                ++numSkipScans;
+            }
+        }
+    }
+
     // If a sort order is requested, there may be an index that provides it, even if that
     // index is not over any predicates in the query.
     //
@@ -997,6 +1055,50 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         }
     }
 
+    // A query without a predicate or a sort which only needs index keys can scan an index instead
+    // of the collection. The index with the fewest fields has the smallest keys.
+    const bool wantsCoveredScan = (params.options & QueryPlannerParams::IS_COUNT)
+        ? !(params.options & QueryPlannerParams::INCLUDE_SHARD_FILTER)
+        : (params.options & QueryPlannerParams::NO_UNCOVERED_PROJECTIONS) &&
+            !query.getQueryRequest().getProj().isEmpty();
+    if ((params.options & QueryPlannerParams::GENERATE_COVERED_IXSCANS) && wantsCoveredScan &&
+        out->empty() && query.getQueryObj().isEmpty() &&
+        query.getQueryRequest().getSort().isEmpty() && !isTailable) {
+        unique_ptr<QuerySolution> bestSoln;
+        int bestNumFields = 0;
+        for (const auto& index : params.indices) {
+            // Every document must have exactly one key in the index.
+            if (INDEX_BTREE != index.type || index.multikey || index.sparse || index.filterExpr) {
+                continue;
+            }
+
+            const int numFields = index.keyPattern.nFields();
+            if (bestSoln && bestNumFields <= numFields) {
+                continue;
+            }
+
+            // Uncovered projections are rejected, so any solution found is covered.
+            unique_ptr<QuerySolution> soln(buildWholeIXSoln(index, query, params));
+            if (soln) {
+                PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+                indexTree->setIndexEntry(index);
+                SolutionCacheData* scd = new SolutionCacheData();
+                scd->tree.reset(indexTree);
+                scd->solnType = SolutionCacheData::WHOLE_IXSCAN_SOLN;
+                scd->wholeIXSolnDir = 1;
+                soln->cacheData.reset(scd);
+
+                bestSoln = std::move(soln);
+                bestNumFields = numFields;
+            }
+        }
+
+        if (bestSoln) {
+            LOG(5) << "Planner: outputting soln that scans a whole index without fetching.";
+            out->push_back(bestSoln.release());
+        }
+    }
+
     // geoNear and text queries *require* an index.
     // Also, if a hint is specified it indicates that we MUST use it.
     bool possibleToCollscan =
@@ -1007,7 +1109,8 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
     bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
-    bool collscanNeeded = (0 == out->size() && canTableScan);
+    // Skip scans only pay off for few distinct prefixes, so they have to beat a collscan.
+    bool collscanNeeded = (numSkipScans == out->size() && canTableScan);
 
     if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
         QuerySolution* collscan = buildCollscanSoln(query, isTailable, params);
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/db/jsobj.h"
@@ -95,6 +97,11 @@ struct QueryPlannerParams {
         // Set this if you don't want any plans with a non-covered projection stage. All projections
         // must be provided/covered by an index.
         NO_UNCOVERED_PROJECTIONS = 1 << 10,
+
+        // Set this if a query without a predicate may be answered by scanning a whole index on its
+        // own: one that covers the projection when NO_UNCOVERED_PROJECTIONS is set, or any index
+        // that holds a key for every document when IS_COUNT is set.
+        GENERATE_COVERED_IXSCANS = 1 << 11,
     };
 
     // See Options enum above.
@@ -115,6 +122,10 @@ struct QueryPlannerParams {
     // plans via the MultiPlanStage, and the set of possible plans is very large for certain
     // index+query combinations.
     size_t maxIndexedSolutions;
+
+    // Names of the compound indices which may be skip-scanned when the query has no predicate
+    // over their leading field. See QueryPlannerAccess::makeSkipScan().
+    std::set<std::string> skipScanIndices;
 };
 
 }  // namespace mongo
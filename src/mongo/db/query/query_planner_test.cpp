@@ -5269,4 +5269,137 @@ TEST_F(QueryPlannerTest, ContainedOrPathLevelMultikeyCannotCompoundTrailingField
     assertSolutionExists("{cscan: {dir: 1}}}}");
 }
 
+//
+// Skip scans
+//
+
+TEST_F(QueryPlannerTest, SkipScanNonLeadingFieldCompetesWithCollscan) {
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1), nullptr, "a_1_b_1_c_1");
+    params.skipScanIndices.insert("a_1_b_1_c_1");
+
+    runQuery(fromjson("{b: {$gt: 2, $lte: 5}, c: 3, d: 4}"));
+    assertNumSolutions(2);
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$gt: 2, $lte: 5}, c: 3, d: 4}, node: {ixscan: {pattern: "
+        "{a: 1, b: 1, c: 1}, bounds: {a: [['MinKey', 'MaxKey', true, true]], "
+        "b: [[2, 5, false, true]], c: [[3, 3, true, true]]}}}}}");
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanAlignsBoundsWithDescendingFields) {
+    addIndex(BSON("a" << 1 << "b" << -1), nullptr, "a_1_b_-1");
+    params.skipScanIndices.insert("a_1_b_-1");
+
+    runQuery(fromjson("{b: {$in: [1, 7]}}"));
+    assertNumSolutions(2);
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$in: [1, 7]}}, node: {ixscan: {pattern: {a: 1, b: -1}, bounds: "
+        "{a: [['MinKey', 'MaxKey', true, true]], b: [[7, 7, true, true], [1, 1, true, true]]}}}}}");
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanUnlessIndexIsEligible) {
+    addIndex(BSON("a" << 1 << "b" << 1), nullptr, "a_1_b_1");
+
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanOnMultikeyIndex) {
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+    params.skipScanIndices.insert("hari_king_of_the_stove");
+
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanWhenLeadingFieldHasPredicate) {
+    addIndex(BSON("a" << 1 << "b" << 1), nullptr, "a_1_b_1");
+    params.skipScanIndices.insert("a_1_b_1");
+
+    runQuery(fromjson("{a: {$gt: 1}, b: 5}"));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [[1, Infinity, false, true]], b: [[5, 5, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanWhenOnlyNestedPredicatesUseIndex) {
+    addIndex(BSON("a" << 1 << "b" << 1), nullptr, "a_1_b_1");
+    params.skipScanIndices.insert("a_1_b_1");
+
+    runQuery(fromjson("{$or: [{b: 5}, {c: 6}]}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+//
+// Covered scans of a whole index for queries without a predicate.
+//
+
+TEST_F(QueryPlannerTest, CoveredProjectionWithoutPredicateScansWholeIndex) {
+    params.options = QueryPlannerParams::NO_UNCOVERED_PROJECTIONS |
+        QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    addIndex(BSON("a" << 1));
+
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{_id: 0, a: 1}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: {ixscan: {filter: null, pattern: {a: 1}, "
+        "bounds: {a: [['MinKey', 'MaxKey', true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CoveredProjectionPrefersIndexWithFewestFields) {
+    params.options = QueryPlannerParams::NO_UNCOVERED_PROJECTIONS |
+        QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{_id: 0, a: 1}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoCoveredWholeIndexScanForUncoveredProjection) {
+    params.options = QueryPlannerParams::NO_UNCOVERED_PROJECTIONS |
+        QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    addIndex(BSON("a" << 1));
+
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{_id: 0, a: 1, b: 1}"));
+    assertNumSolutions(0U);
+}
+
+TEST_F(QueryPlannerTest, NoCoveredWholeIndexScanOnSparseOrMultikeyIndex) {
+    params.options = QueryPlannerParams::INCLUDE_COLLSCAN |
+        QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    addIndex(BSON("a" << 1), true);
+    addIndex(BSON("a" << 1 << "b" << 1), false, true);
+
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{_id: 0, a: 1}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{proj: {spec: {_id: 0, a: 1}, node: {cscan: {dir: 1}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoCoveredWholeIndexScanWithoutOption) {
+    params.options = QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
+    addIndex(BSON("a" << 1));
+
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{_id: 0, a: 1}"));
+    assertNumSolutions(0U);
+}
+
+TEST_F(QueryPlannerTest, CountWithoutPredicateScansSmallestIndex) {
+    params.options = QueryPlannerParams::IS_COUNT | QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQuery(BSONObj());
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {b: 1}}}}}");
+}
+
 }  // namespace
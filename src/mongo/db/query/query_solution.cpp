@@ -275,25 +275,14 @@ void AndHashNode::appendToString(mongoutils::str::stream* ss, int indent) const
 }
 
 bool AndHashNode::fetched() const {
-    // Any WSM output from this stage came from all children stages.  If any child provides
-    // fetched data, we merge that fetched data into the WSM we output.
-    for (size_t i = 0; i < children.size(); ++i) {
-        if (children[i]->fetched()) {
-            return true;
-        }
-    }
-    return false;
+    // Only RecordIds are kept from all but the last child, so the WSM output from this stage is
+    // the one output by the last child.
+    return children.back()->fetched();
 }
 
 bool AndHashNode::hasField(const string& field) const {
-    // Any WSM output from this stage came from all children stages.  Therefore we have all
-    // fields covered in our children.
-    for (size_t i = 0; i < children.size(); ++i) {
-        if (children[i]->hasField(field)) {
-            return true;
-        }
-    }
-    return false;
+    // The WSM output from this stage is the one output by the last child.
+    return children.back()->hasField(field);
 }
 
 QuerySolutionNode* AndHashNode::clone() const {
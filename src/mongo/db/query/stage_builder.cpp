@@ -56,6 +56,7 @@
 #include "mongo/db/exec/text.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -65,6 +66,47 @@ namespace mongo {
 using std::unique_ptr;
 using stdx::make_unique;
 
+namespace {
+
+/**
+ * Returns true if 'target' is below a blocking SORT in the tree rooted at 'node', and every stage
+ * between them neither depends on nor cuts short the order of its input. The order in which
+ * 'target' returns its results then does not change the results of the query. In particular, this
+ * is never the case when the sort of the query is provided by the children of 'target', since the
+ * planner adds no SORT stage then.
+ */
+bool isBelowBlockingSort(const QuerySolutionNode* node,
+                         const QuerySolutionNode* target,
+                         bool belowSort) {
+    if (node == target) {
+        return belowSort;
+    }
+
+    switch (node->getType()) {
+        case STAGE_SORT:
+            belowSort = true;
+            break;
+        case STAGE_FETCH:
+        case STAGE_KEEP_MUTATIONS:
+        case STAGE_OR:
+        case STAGE_PROJECTION:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_SORT_KEY_GENERATOR:
+            break;
+        default:
+            belowSort = false;
+    }
+
+    for (auto&& child : node->children) {
+        if (isBelowBlockingSort(child, target, belowSort)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
 PlanStage* buildStages(OperationContext* opCtx,
                        Collection* collection,
                        const CanonicalQuery& cq,
@@ -104,7 +146,14 @@ PlanStage* buildStages(OperationContext* opCtx,
         if (NULL == childStage) {
             return NULL;
         }
-        return new FetchStage(opCtx, ws, childStage, fn->filter.get(), collection);
+        // Only a FETCH whose output order is irrelevant buffers results, so that each batch can
+        // be fetched in RecordId order.
+        const bool sortBatches = isBelowBlockingSort(qsol.root.get(), fn, false);
+        const size_t batchSize =
+            sortBatches ? static_cast<size_t>(std::max(internalQueryExecFetchBatchSize.load(), 1))
+                        : 1;
+        return new FetchStage(
+            opCtx, ws, childStage, fn->filter.get(), collection, batchSize, sortBatches);
     } else if (STAGE_SORT == root->getType()) {
         const SortNode* sn = static_cast<const SortNode*>(root);
         PlanStage* childStage = buildStages(opCtx, collection, cq, qsol, sn->children[0], ws);
@@ -430,6 +430,7 @@ void BackgroundSync::_produce(OperationContext* opCtx) {
             syncSourceResp.rbid,
             true /* requireFresherSyncSource */,
             &dataReplicatorExternalState,
+            _oplogBuffer.get(),
             stdx::bind(&BackgroundSync::_enqueueDocuments,
                        this,
                        stdx::placeholders::_1,
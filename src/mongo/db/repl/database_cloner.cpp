@@ -85,6 +85,10 @@ BSONObj createListCollectionsCommandObject(const BSONObj& filter) {
 
 }  // namespace
 
+// The maximum number of collections in a database that are cloned at the same time. Values less
+// than 1 are treated as 1.
+MONGO_EXPORT_SERVER_PARAMETER(maxNumInitialSyncCollectionClonersPerDatabase, int, 1);
+
 DatabaseCloner::DatabaseCloner(executor::TaskExecutor* executor,
                                OldThreadPool* dbWorkThreadPool,
                                const HostAndPort& source,
@@ -372,17 +376,39 @@ void DatabaseCloner::_listCollectionsCallback(const StatusWith<Fetcher::QueryRes
         }
     }
 
-    // Start first collection cloner.
-    _currentCollectionClonerIter = _collectionCloners.begin();
+    // Start as many collection cloners as we are allowed to run concurrently.
+    _nextCollectionClonerIter = _collectionCloners.begin();
+    _startCollectionCloners_inlock();
+    if (_numActiveCollectionCloners == 0) {
+        invariant(!_collectionClonerStartStatus.isOK());
+        _finishCallback_inlock(lk, _collectionClonerStartStatus);
+        return;
+    }
+}
 
-    LOG(1) << "    cloning collection " << _currentCollectionClonerIter->getSourceNamespace();
+void DatabaseCloner::_startCollectionCloners_inlock() {
+    const std::size_t maxActive =
+        std::max(1, maxNumInitialSyncCollectionClonersPerDatabase.load());
+    while (_numActiveCollectionCloners < maxActive &&
+           _nextCollectionClonerIter != _collectionCloners.end()) {
+        auto&& cloner = *_nextCollectionClonerIter;
+        ++_nextCollectionClonerIter;
 
-    Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-    if (!startStatus.isOK()) {
-        LOG(1) << "    failed to start collection cloning on "
-               << _currentCollectionClonerIter->getSourceNamespace() << ": " << redact(startStatus);
-        _finishCallback_inlock(lk, startStatus);
-        return;
+        LOG(1) << "    cloning collection " << cloner.getSourceNamespace();
+        Status startStatus = _startCollectionCloner(cloner);
+        if (!startStatus.isOK()) {
+            LOG(1) << "    failed to start collection cloning on " << cloner.getSourceNamespace()
+                   << ": " << redact(startStatus);
+            // Do not start any more cloners. Cloners that are already running are shut down and
+            // the database cloner completes with this status once the last of them finishes.
+            _collectionClonerStartStatus = startStatus;
+            _nextCollectionClonerIter = _collectionCloners.end();
+            for (auto&& collectionCloner : _collectionCloners) {
+                collectionCloner.shutdown();
+            }
+            return;
+        }
+        ++_numActiveCollectionCloners;
     }
 }
 
@@ -406,22 +432,18 @@ void DatabaseCloner::_collectionClonerCallback(const Status& status, const Names
     lk.unlock();
     _collectionWork(newStatus, nss);
     lk.lock();
-    _currentCollectionClonerIter++;
+    invariant(_numActiveCollectionCloners > 0);
+    --_numActiveCollectionCloners;
 
-    if (_currentCollectionClonerIter != _collectionCloners.end()) {
-        Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-        if (!startStatus.isOK()) {
-            LOG(1) << "    failed to start collection cloning on "
-                   << _currentCollectionClonerIter->getSourceNamespace() << ": "
-                   << redact(startStatus);
-            _finishCallback_inlock(lk, startStatus);
-            return;
-        }
+    _startCollectionCloners_inlock();
+    if (_numActiveCollectionCloners > 0) {
         return;
     }
 
     Status finalStatus(Status::OK());
-    if (_failedNamespaces.size() > 0) {
+    if (!_collectionClonerStartStatus.isOK()) {
+        finalStatus = _collectionClonerStartStatus;
+    } else if (_failedNamespaces.size() > 0) {
         finalStatus = {ErrorCodes::InitialSyncFailure,
                        str::stream() << "Failed to clone " << _failedNamespaces.size()
                                      << " collection(s) in '"
@@ -41,6 +41,7 @@
 #include "mongo/db/repl/base_cloner.h"
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/net/hostandport.h"
@@ -58,6 +59,9 @@ using UniqueLock = stdx::unique_lock<stdx::mutex>;
 
 class StorageInterface;
 
+// Server parameter bounding the number of collection cloners a DatabaseCloner runs at once.
+extern AtomicInt32 maxNumInitialSyncCollectionClonersPerDatabase;
+
 class DatabaseCloner : public BaseCloner {
     MONGO_DISALLOW_COPYING(DatabaseCloner);
 
@@ -201,6 +205,13 @@ private:
      */
     void _finishCallback_inlock(UniqueLock& lk, const Status& status);
 
+    /**
+     * Starts pending collection cloners until 'maxNumInitialSyncCollectionClonersPerDatabase'
+     * cloners are active or there are none left to start. If a cloner fails to start, records the
+     * error in '_collectionClonerStartStatus', shuts down the active cloners and starts no more.
+     */
+    void _startCollectionCloners_inlock();
+
     //
     // All member variables are labeled with one of the following codes indicating the
     // synchronization rules for accessing them.
@@ -233,7 +244,9 @@ private:
     std::vector<BSONObj> _collectionInfos;                               // (M)
     std::vector<NamespaceString> _collectionNamespaces;                  // (M)
     std::list<CollectionCloner> _collectionCloners;                      // (M)
-    std::list<CollectionCloner>::iterator _currentCollectionClonerIter;  // (M)
+    std::list<CollectionCloner>::iterator _nextCollectionClonerIter;     // (M)
+    std::size_t _numActiveCollectionCloners = 0;                         // (M)
+    Status _collectionClonerStartStatus = Status::OK();                  // (M)
     std::vector<std::pair<Status, NamespaceString>> _failedNamespaces;   // (M)
     CollectionCloner::ScheduleDbWorkFn
         _scheduleDbWorkFn;  // (RT) Function for scheduling database work using the executor.
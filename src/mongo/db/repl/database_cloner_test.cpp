@@ -40,6 +40,7 @@
 #include "mongo/unittest/task_executor_proxy.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace {
 
@@ -874,4 +875,77 @@ TEST_F(DatabaseClonerTest, CreateCollections) {
     stats.commitCalled = true;
 }
 
+TEST_F(DatabaseClonerTest, CollectionClonersRunConcurrentlyUpToLimit) {
+    const auto oldMaxCloners = maxNumInitialSyncCollectionClonersPerDatabase.load();
+    maxNumInitialSyncCollectionClonersPerDatabase.store(2);
+    ON_BLOCK_EXIT([oldMaxCloners] {
+        maxNumInitialSyncCollectionClonersPerDatabase.store(oldMaxCloners);
+    });
+
+    ASSERT_OK(_databaseCloner->startup());
+
+    auto net = getNet();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+        processNetworkResponse(createListCollectionsResponse(0,
+                                                             BSON_ARRAY(BSON("name"
+                                                                             << "a"
+                                                                             << "options"
+                                                                             << BSONObj())
+                                                                        << BSON("name"
+                                                                                << "b"
+                                                                                << "options"
+                                                                                << BSONObj())
+                                                                        << BSON("name"
+                                                                                << "c"
+                                                                                << "options"
+                                                                                << BSONObj()))));
+
+        // The first two collection cloners start together. The third waits for a free slot.
+        auto countA = net->getNextReadyRequest();
+        assertRemoteCommandNameEquals("count", countA->getRequest());
+        ASSERT_EQUALS("a", countA->getRequest().cmdObj.firstElement().String());
+        auto countB = net->getNextReadyRequest();
+        assertRemoteCommandNameEquals("count", countB->getRequest());
+        ASSERT_EQUALS("b", countB->getRequest().cmdObj.firstElement().String());
+        ASSERT_FALSE(net->hasReadyRequests());
+        scheduleNetworkResponse(countA, createCountResponse(0));
+        scheduleNetworkResponse(countB, createCountResponse(0));
+        net->runReadyNetworkOperations();
+
+        // Answer the remaining requests in whatever order the cloners issue them. The cloner for
+        // 'c' must not send its count until the cloner for 'a' or 'b' has received its last batch.
+        int findsAnswered = 0;
+        bool sawCountC = false;
+        while (net->hasReadyRequests()) {
+            auto noi = net->getNextReadyRequest();
+            const auto& cmdObj = noi->getRequest().cmdObj;
+            const auto commandName = cmdObj.firstElementFieldName();
+            if (str::equals(commandName, "count")) {
+                ASSERT_EQUALS("c", cmdObj.firstElement().String());
+                ASSERT_GREATER_THAN(findsAnswered, 0);
+                sawCountC = true;
+                scheduleNetworkResponse(noi, createCountResponse(0));
+            } else if (str::equals(commandName, "listIndexes")) {
+                scheduleNetworkResponse(noi, createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+            } else {
+                assertRemoteCommandNameEquals("find", noi->getRequest());
+                ++findsAnswered;
+                scheduleNetworkResponse(noi, createCursorResponse(0, BSONArray()));
+            }
+            net->runReadyNetworkOperations();
+        }
+        ASSERT_TRUE(sawCountC);
+        ASSERT_EQUALS(3, findsAnswered);
+    }
+
+    _databaseCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_FALSE(_databaseCloner->isActive());
+    ASSERT_EQUALS(3U, _collections.size());
+    ASSERT_OK(_collections[NamespaceString{"db.a"}].status);
+    ASSERT_OK(_collections[NamespaceString{"db.b"}].status);
+    ASSERT_OK(_collections[NamespaceString{"db.c"}].status);
+}
+
 }  // namespace
@@ -669,6 +669,7 @@ void InitialSyncer::_lastOplogEntryFetcherCallbackForBeginTimestamp(
                                         _rollbackChecker->getBaseRBID(),
                                         false /* requireFresherSyncSource */,
                                         _dataReplicatorExternalState.get(),
+                                        _oplogBuffer.get(),
                                         stdx::bind(&InitialSyncer::_enqueueDocuments,
                                                    this,
                                                    stdx::placeholders::_1,
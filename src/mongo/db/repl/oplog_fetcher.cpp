@@ -35,7 +35,9 @@
 #include "mongo/base/counter.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
@@ -63,6 +65,17 @@ ServerStatusMetricField<Counter64> displayOpsRead("repl.network.ops", &opsReadSt
 // The bytes read via the oplog reader
 Counter64 networkByteStats;
 ServerStatusMetricField<Counter64> displayBytesRead("repl.network.bytes", &networkByteStats);
+// The getMore requests whose batch size was limited by the space left in the oplog buffer
+Counter64 flowControlledGetMoreStats;
+ServerStatusMetricField<Counter64> displayFlowControlledGetMores(
+    "repl.network.flowControlledGetmores", &flowControlledGetMoreStats);
+
+// Limit the size of getMore batches to the space left in the oplog buffer, so that the fetcher does
+// not fetch more than it can buffer and then block the replication executor waiting for space.
+MONGO_EXPORT_SERVER_PARAMETER(oplogFetcherUsesBufferFlowControl, bool, true);
+
+// The most data a single getMore response can carry.
+const std::size_t kMaxGetMoreBatchBytes = BSONObjMaxUserSize;
 
 /**
  * Calculates await data timeout based on the current replica set configuration.
@@ -83,11 +96,15 @@ Milliseconds calculateAwaitDataTimeout(const ReplSetConfig& config) {
 BSONObj makeGetMoreCommandObject(const NamespaceString& nss,
                                  CursorId cursorId,
                                  OpTimeWithTerm lastCommittedWithCurrentTerm,
-                                 Milliseconds fetcherMaxTimeMS) {
+                                 Milliseconds fetcherMaxTimeMS,
+                                 boost::optional<long long> batchSize) {
     BSONObjBuilder cmdBob;
     cmdBob.append("getMore", cursorId);
     cmdBob.append("collection", nss.coll());
     cmdBob.append("maxTimeMS", durationCount<Milliseconds>(fetcherMaxTimeMS));
+    if (batchSize) {
+        cmdBob.append("batchSize", *batchSize);
+    }
     if (lastCommittedWithCurrentTerm.value != OpTime::kUninitializedTerm) {
         cmdBob.append("term", lastCommittedWithCurrentTerm.value);
         lastCommittedWithCurrentTerm.opTime.append(&cmdBob, "lastKnownCommittedOpTime");
@@ -302,6 +319,26 @@ StatusWith<OplogFetcher::DocumentsInfo> OplogFetcher::validateDocuments(
     return info;
 }
 
+boost::optional<long long> OplogFetcher::calculateGetMoreBatchSize(const OplogBuffer& oplogBuffer,
+                                                                  const DocumentsInfo& info) {
+    const auto maxSize = oplogBuffer.getMaxSize();
+    if (maxSize == 0 || info.networkDocumentCount == 0) {
+        return boost::none;
+    }
+
+    const auto size = oplogBuffer.getSize();
+    const std::size_t freeBytes = size < maxSize ? maxSize - size : 0;
+    if (freeBytes >= kMaxGetMoreBatchBytes) {
+        return boost::none;
+    }
+
+    // Always ask for at least one operation so that the cursor makes progress. Enqueueing it will
+    // wait for the applier to make room in the buffer.
+    const std::size_t averageDocumentBytes =
+        std::max<std::size_t>(1U, info.networkDocumentBytes / info.networkDocumentCount);
+    return static_cast<long long>(std::max<std::size_t>(1U, freeBytes / averageDocumentBytes));
+}
+
 OplogFetcher::OplogFetcher(executor::TaskExecutor* executor,
                            OpTimeWithHash lastFetched,
                            HostAndPort source,
@@ -311,6 +348,7 @@ OplogFetcher::OplogFetcher(executor::TaskExecutor* executor,
                            int requiredRBID,
                            bool requireFresherSyncSource,
                            DataReplicatorExternalState* dataReplicatorExternalState,
+                           const OplogBuffer* oplogBuffer,
                            EnqueueDocumentsFn enqueueDocumentsFn,
                            OnShutdownCallbackFn onShutdownCallbackFn)
     : AbstractOplogFetcher(executor,
@@ -324,6 +362,7 @@ OplogFetcher::OplogFetcher(executor::TaskExecutor* executor,
       _requiredRBID(requiredRBID),
       _requireFresherSyncSource(requireFresherSyncSource),
       _dataReplicatorExternalState(dataReplicatorExternalState),
+      _oplogBuffer(oplogBuffer),
       _enqueueDocumentsFn(enqueueDocumentsFn),
       _awaitDataTimeout(calculateAwaitDataTimeout(config)) {
 
@@ -455,7 +494,6 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
     // Record time for each batch.
     getmoreReplStats.recordMillis(durationCount<Milliseconds>(queryResponse.elapsedMillis));
 
-    // TODO: back pressure handling will be added in SERVER-23499.
     auto status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
     if (!status.isOK()) {
         return status;
@@ -481,10 +519,25 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
         return Status(ErrorCodes::InvalidSyncSource, errMsg);
     }
 
+    boost::optional<long long> batchSize;
+    if (_oplogBuffer && oplogFetcherUsesBufferFlowControl.load()) {
+        batchSize = calculateGetMoreBatchSize(*_oplogBuffer, info);
+        if (batchSize) {
+            flowControlledGetMoreStats.increment();
+            LOG(2) << "oplog buffer has " << _oplogBuffer->getSize() << " of "
+                   << _oplogBuffer->getMaxSize()
+                   << " bytes in use; requesting next batch of at most " << *batchSize
+                   << " operations";
+        }
+    }
+
     auto lastCommittedWithCurrentTerm =
         _dataReplicatorExternalState->getCurrentTermAndLastCommittedOpTime();
-    return makeGetMoreCommandObject(
-        queryResponse.nss, queryResponse.cursorId, lastCommittedWithCurrentTerm, _awaitDataTimeout);
+    return makeGetMoreCommandObject(queryResponse.nss,
+                                    queryResponse.cursorId,
+                                    lastCommittedWithCurrentTerm,
+                                    _awaitDataTimeout,
+                                    batchSize);
 }
 }  // namespace repl
 }  // namespace mongo
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <cstddef>
 
 #include "mongo/base/disallow_copying.h"
@@ -44,6 +45,8 @@
 namespace mongo {
 namespace repl {
 
+class OplogBuffer;
+
 MONGO_FP_FORWARD_DECLARE(stopReplProducer);
 
 /**
@@ -62,7 +65,9 @@ MONGO_FP_FORWARD_DECLARE(stopReplProducer);
  * Pushes operations from each batch of operations onto a buffer using the "enqueueDocumentsFn"
  * function.
  *
- * Issues a getMore command after successfully processing each batch of operations.
+ * Issues a getMore command after successfully processing each batch of operations. If an oplog
+ * buffer is provided and it does not have room for a full batch, the getMore asks for only as many
+ * operations as are expected to fit in the remaining space.
  *
  * When there is an error or when it is not possible to issue another getMore request, calls
  * "onShutdownCallbackFn" to signal the end of processing.
@@ -109,6 +114,15 @@ public:
                                                        bool first,
                                                        Timestamp lastTS);
 
+    /**
+     * Returns the "batchSize" to send with the next getMore so that the batch fits in the space
+     * left in 'oplogBuffer', estimated from the average size of the operations in 'info'.
+     * Returns boost::none if the buffer is unbounded, has room for a full batch or there is no
+     * size estimate to go on.
+     */
+    static boost::optional<long long> calculateGetMoreBatchSize(const OplogBuffer& oplogBuffer,
+                                                                const DocumentsInfo& info);
+
     /**
      * Invariants if validation fails on any of the provided arguments.
      */
@@ -121,6 +135,7 @@ public:
                  int requiredRBID,
                  bool requireFresherSyncSource,
                  DataReplicatorExternalState* dataReplicatorExternalState,
+                 const OplogBuffer* oplogBuffer,
                  EnqueueDocumentsFn enqueueDocumentsFn,
                  OnShutdownCallbackFn onShutdownCallbackFn);
 
@@ -167,6 +182,11 @@ private:
     bool _requireFresherSyncSource;
 
     DataReplicatorExternalState* const _dataReplicatorExternalState;
+
+    // Buffer that '_enqueueDocumentsFn' pushes operations into. May be null, in which case getMore
+    // requests are not limited by the space left in the buffer.
+    const OplogBuffer* const _oplogBuffer;
+
     const EnqueueDocumentsFn _enqueueDocumentsFn;
     const Milliseconds _awaitDataTimeout;
 };
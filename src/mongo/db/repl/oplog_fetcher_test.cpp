@@ -32,6 +32,7 @@
 
 #include "mongo/db/repl/abstract_oplog_fetcher_test_fixture.h"
 #include "mongo/db/repl/data_replicator_external_state_mock.h"
+#include "mongo/db/repl/oplog_buffer.h"
 #include "mongo/db/repl/oplog_fetcher.h"
 #include "mongo/rpc/metadata.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
@@ -52,6 +53,52 @@ using executor::RemoteCommandRequest;
 using executor::RemoteCommandResponse;
 using NetworkGuard = executor::NetworkInterfaceMock::InNetworkGuard;
 
+/**
+ * Oplog buffer that only reports the sizes it is configured with. Used to test flow control.
+ */
+class OplogBufferWithFixedSize : public OplogBuffer {
+public:
+    OplogBufferWithFixedSize(std::size_t maxSize, std::size_t size)
+        : maxSize(maxSize), size(size) {}
+
+    void startup(OperationContext*) override {}
+    void shutdown(OperationContext*) override {}
+    void pushEvenIfFull(OperationContext*, const Value&) override {}
+    void push(OperationContext*, const Value&) override {}
+    void pushAllNonBlocking(OperationContext*,
+                            Batch::const_iterator,
+                            Batch::const_iterator) override {}
+    void waitForSpace(OperationContext*, std::size_t) override {}
+    bool isEmpty() const override {
+        return size == 0;
+    }
+    std::size_t getMaxSize() const override {
+        return maxSize;
+    }
+    std::size_t getSize() const override {
+        return size;
+    }
+    std::size_t getCount() const override {
+        return 0;
+    }
+    void clear(OperationContext*) override {}
+    bool tryPop(OperationContext*, Value*) override {
+        return false;
+    }
+    bool waitForData(Seconds) override {
+        return false;
+    }
+    bool peek(OperationContext*, Value*) override {
+        return false;
+    }
+    boost::optional<Value> lastObjectPushed(OperationContext*) const override {
+        return boost::none;
+    }
+
+    std::size_t maxSize;
+    std::size_t size;
+};
+
 class OplogFetcherTest : public AbstractOplogFetcherTest {
 protected:
     void setUp() override;
@@ -172,6 +219,7 @@ std::unique_ptr<ShutdownState> OplogFetcherTest::processSingleBatch(RemoteComman
                               rbid,
                               requireFresherSyncSource,
                               dataReplicatorExternalState.get(),
+                              nullptr,
                               enqueueDocumentsFn,
                               stdx::ref(*shutdownState));
 
@@ -216,6 +264,7 @@ TEST_F(
                               -1,
                               true,
                               dataReplicatorExternalState.get(),
+                              nullptr,
                               enqueueDocumentsFn,
                               [](Status) {});
     auto cmdObj = oplogFetcher.getFindQuery_forTest();
@@ -238,6 +287,7 @@ TEST_F(OplogFetcherTest,
                               -1,
                               true,
                               dataReplicatorExternalState.get(),
+                              nullptr,
                               enqueueDocumentsFn,
                               [](Status) {});
     auto cmdObj = oplogFetcher.getFindQuery_forTest();
@@ -258,6 +308,7 @@ TEST_F(OplogFetcherTest, MetadataObjectContainsMetadataFieldsUnderProtocolVersio
                                     -1,
                                     true,
                                     dataReplicatorExternalState.get(),
+                                    nullptr,
                                     enqueueDocumentsFn,
                                     [](Status) {})
                            .getMetadataObject_forTest();
@@ -276,6 +327,7 @@ TEST_F(OplogFetcherTest, MetadataObjectIsEmptyUnderProtocolVersion0) {
                                     -1,
                                     true,
                                     dataReplicatorExternalState.get(),
+                                    nullptr,
                                     enqueueDocumentsFn,
                                     [](Status) {})
                            .getMetadataObject_forTest();
@@ -295,6 +347,7 @@ TEST_F(OplogFetcherTest, AwaitDataTimeoutShouldEqualHalfElectionTimeoutUnderProt
                                 -1,
                                 true,
                                 dataReplicatorExternalState.get(),
+                                nullptr,
                                 enqueueDocumentsFn,
                                 [](Status) {})
                        .getAwaitDataTimeout_forTest();
@@ -311,6 +364,7 @@ TEST_F(OplogFetcherTest, AwaitDataTimeoutShouldBeAConstantUnderProtocolVersion0)
                                 -1,
                                 true,
                                 dataReplicatorExternalState.get(),
+                                nullptr,
                                 enqueueDocumentsFn,
                                 [](Status) {})
                        .getAwaitDataTimeout_forTest();
@@ -607,6 +661,80 @@ TEST_F(OplogFetcherTest, OplogFetcherShouldExcludeFirstDocumentInFirstBatchWhenE
     ASSERT_OK(shutdownState->getStatus());
 }
 
+TEST_F(OplogFetcherTest, GetMoreBatchSizeIsLimitedBySpaceLeftInOplogBuffer) {
+    const std::size_t maxSize = 1024 * 1024;
+    OplogBufferWithFixedSize oplogBuffer(maxSize, 0);
+
+    ShutdownState shutdownState;
+    OplogFetcher oplogFetcher(&getExecutor(),
+                              lastFetched,
+                              source,
+                              nss,
+                              _createConfig(true),
+                              0,
+                              rbid,
+                              true,
+                              dataReplicatorExternalState.get(),
+                              &oplogBuffer,
+                              enqueueDocumentsFn,
+                              stdx::ref(shutdownState));
+    ASSERT_OK(oplogFetcher.startup());
+
+    auto firstEntry = makeNoopOplogEntry(lastFetched);
+    auto secondEntry = makeNoopOplogEntry({{Seconds(456), 0}, lastFetched.opTime.getTerm()}, 200);
+    auto metadataObj = makeOplogQueryMetadataObject(remoteNewerOpTime, rbid, 2, 2);
+    processNetworkResponse(
+        {makeCursorResponse(22LL, {firstEntry, secondEntry}), metadataObj, Milliseconds(0)}, true);
+
+    auto thirdEntry = makeNoopOplogEntry({{Seconds(789), 0}, lastFetched.opTime.getTerm()}, 300);
+    auto request = processNetworkResponse(makeCursorResponse(0, {thirdEntry}, false));
+
+    ASSERT_EQUALS(std::string("getMore"), request.cmdObj.firstElementFieldName());
+    const auto averageDocumentBytes = (firstEntry.objsize() + secondEntry.objsize()) / 2;
+    ASSERT_EQUALS(static_cast<long long>(maxSize / averageDocumentBytes),
+                  request.cmdObj["batchSize"].numberLong());
+
+    oplogFetcher.join();
+    ASSERT_OK(shutdownState.getStatus());
+}
+
+TEST_F(OplogFetcherTest, CalculateGetMoreBatchSizeReturnsNoneForUnboundedOplogBuffer) {
+    OplogBufferWithFixedSize oplogBuffer(0, 100 * 1024 * 1024);
+    OplogFetcher::DocumentsInfo info;
+    info.networkDocumentCount = 10;
+    info.networkDocumentBytes = 1000;
+    ASSERT_FALSE(OplogFetcher::calculateGetMoreBatchSize(oplogBuffer, info));
+}
+
+TEST_F(OplogFetcherTest, CalculateGetMoreBatchSizeReturnsNoneIfOplogBufferHasRoomForFullBatch) {
+    OplogBufferWithFixedSize oplogBuffer(256 * 1024 * 1024, 0);
+    OplogFetcher::DocumentsInfo info;
+    info.networkDocumentCount = 10;
+    info.networkDocumentBytes = 1000;
+    ASSERT_FALSE(OplogFetcher::calculateGetMoreBatchSize(oplogBuffer, info));
+}
+
+TEST_F(OplogFetcherTest, CalculateGetMoreBatchSizeReturnsNoneIfBatchWasEmpty) {
+    OplogBufferWithFixedSize oplogBuffer(256 * 1024 * 1024, 256 * 1024 * 1024);
+    ASSERT_FALSE(OplogFetcher::calculateGetMoreBatchSize(oplogBuffer, {}));
+}
+
+TEST_F(OplogFetcherTest, CalculateGetMoreBatchSizeUsesAverageDocumentSize) {
+    OplogBufferWithFixedSize oplogBuffer(256 * 1024 * 1024, 256 * 1024 * 1024 - 5000);
+    OplogFetcher::DocumentsInfo info;
+    info.networkDocumentCount = 10;
+    info.networkDocumentBytes = 1000;
+    ASSERT_EQUALS(50LL, *OplogFetcher::calculateGetMoreBatchSize(oplogBuffer, info));
+}
+
+TEST_F(OplogFetcherTest, CalculateGetMoreBatchSizeRequestsAtLeastOneDocumentIfOplogBufferIsFull) {
+    OplogBufferWithFixedSize oplogBuffer(256 * 1024 * 1024, 300 * 1024 * 1024);
+    OplogFetcher::DocumentsInfo info;
+    info.networkDocumentCount = 10;
+    info.networkDocumentBytes = 1000;
+    ASSERT_EQUALS(1LL, *OplogFetcher::calculateGetMoreBatchSize(oplogBuffer, info));
+}
+
 TEST_F(OplogFetcherTest, OplogFetcherShouldReportErrorsThrownFromCallback) {
     auto metadataObj = makeOplogQueryMetadataObject(remoteNewerOpTime, rbid, 2, 2);
 
@@ -749,6 +877,7 @@ RemoteCommandRequest OplogFetcherTest::testTwoBatchHandling(bool isV1ElectionPro
                               rbid,
                               true,
                               dataReplicatorExternalState.get(),
+                              nullptr,
                               enqueueDocumentsFn,
                               stdx::ref(shutdownState));
     ASSERT_EQUALS(OplogFetcher::State::kPreStart, oplogFetcher.getState_forTest());
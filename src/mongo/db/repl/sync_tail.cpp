@@ -66,6 +66,8 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
+#include "mongo/db/storage/snapshot_manager.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
@@ -82,6 +84,10 @@ namespace repl {
 
 AtomicInt32 SyncTail::replBatchLimitOperations{50 * 1000};
 
+// Hangs oplog application after a batch has been applied, while it still blocks readers that
+// conflict with it.
+MONGO_FP_DECLARE(hangBeforeCompletingOplogBatch);
+
 /**
  * This variable determines the number of writer threads SyncTail will have. It has a default
  * value, which varies based on architecture and can be overridden using the
@@ -481,6 +487,7 @@ void scheduleWritesToOplog(OperationContext* opCtx,
             const auto opCtxHolder = cc().makeOperationContext();
             const auto opCtx = opCtxHolder.get();
             opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+            opCtx->lockState()->setShouldAcquireTicket(false);
             UnreplicatedWritesBlock uwb(opCtx);
 
             std::vector<BSONObj> docs;
@@ -571,6 +578,47 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * Returns true for commands whose only effect is on the single collection named by their first
+ * field. These do not have to be applied in a batch of their own: fillWriterVectors() assigns them
+ * to the same writer as every other op on that collection in the batch, and the writer applies
+ * them in oplog order.
+ *
+ * Commands which may touch other namespaces (renameCollection, dropDatabase, applyOps,
+ * convertToCapped, view definitions, system collections) are still applied one at a time.
+ */
+bool isCollectionLocalCommand(const OplogEntry& entry) {
+    if (!entry.isCommand() || entry.o.type() != Object) {
+        return false;
+    }
+
+    const BSONObj cmd = entry.o.Obj();
+    const BSONElement first = cmd.firstElement();
+    if (first.type() != String || first.valueStringData().empty() ||
+        first.valueStringData().startsWith("system.")) {
+        return false;
+    }
+
+    const StringData name = first.fieldNameStringData();
+    if (name == "create" || name == "collMod") {
+        return !cmd.hasField("viewOn") && !cmd.hasField("pipeline");
+    }
+    return name == "drop" || name == "emptycapped" || name == "dropIndexes" ||
+        name == "deleteIndexes";
+}
+
+/**
+ * Returns the namespace an op applies to. For collection-local commands this is the collection
+ * named by the command rather than the "<db>.$cmd" namespace of the entry.
+ */
+std::string getTargetNamespaceString(const OplogEntry& entry) {
+    if (isCollectionLocalCommand(entry)) {
+        return nsToDatabaseSubstring(entry.ns).toString() + "." +
+            entry.o.Obj().firstElement().valueStringData();
+    }
+    return entry.ns.toString();
+}
+
 // This only modifies the isForCappedCollection field on each op. It does not alter the ops vector
 // in any other way.
 void fillWriterVectors(OperationContext* opCtx,
@@ -582,19 +630,48 @@ void fillWriterVectors(OperationContext* opCtx,
 
     CachedCollectionProperties collPropertiesCache;
 
+    // Collections targeted by a command in this batch, mapped to whether the batch creates them as
+    // capped. Every op on these collections is hashed by namespace alone so that the command and
+    // the ops before and after it are applied in order by a single writer.
+    StringMap<bool> commandNamespaces;
     for (auto&& op : *ops) {
+        if (isCollectionLocalCommand(op)) {
+            const BSONObj cmd = op.o.Obj();
+            const bool createsCapped =
+                cmd.firstElement().fieldNameStringData() == "create" && cmd["capped"].trueValue();
+            auto& isCapped = commandNamespaces[getTargetNamespaceString(op)];
+            isCapped = isCapped || createsCapped;
+        }
+    }
+
+    for (auto&& op : *ops) {
+        if (op.isCommand()) {
+            // Only collection-local commands share a batch with other ops; anything else is alone.
+            StringMapTraits::HashedKey hashedTarget(getTargetNamespaceString(op));
+            auto& writer = (*writerVectors)[hashedTarget.hash() % numWriters];
+            writer.push_back(&op);
+            continue;
+        }
+
         StringMapTraits::HashedKey hashedNs(op.ns);
         uint32_t hash = hashedNs.hash();
 
         if (op.isCrudOpType()) {
             auto collProperties = collPropertiesCache.getCollectionProperties(opCtx, hashedNs);
 
+            auto commandNs = commandNamespaces.find(op.ns);
+            const bool dependsOnCommand = commandNs != commandNamespaces.end();
+            if (dependsOnCommand) {
+                collProperties.isCapped = collProperties.isCapped || commandNs->second;
+            }
+
             // For doc locking engines, include the _id of the document in the hash so we get
             // parallelism even if all writes are to a single collection.
             //
             // For capped collections, this is illegal, since capped collections must preserve
-            // insertion order.
-            if (supportsDocLocking && !collProperties.isCapped) {
+            // insertion order. Neither can ops on a collection that a command in this batch
+            // creates, drops or modifies be spread across writers.
+            if (supportsDocLocking && !collProperties.isCapped && !dependsOnCommand) {
                 BSONElement id = op.getIdElement();
                 BSONElementComparator elementHasher(BSONElementComparator::FieldNamesMode::kIgnore,
                                                     collProperties.collator);
@@ -901,7 +978,8 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* opCtx,
 
     // Check for ops that must be processed one at a time.
     if (entry.raw.isEmpty() ||       // sentinel that network queue is drained.
-        (entry.opType[0] == 'c') ||  // commands.
+        // Commands, except those confined to a single collection.
+        (entry.isCommand() && !isCollectionLocalCommand(entry)) ||
         // Index builds are achieved through the use of an insert op, not a command op.
         // The following line is the same as what the insert code uses to detect an index build.
         (!entry.ns.empty() && nsToCollectionSubstring(entry.ns) == "system.indexes")) {
@@ -1067,10 +1145,19 @@ Status multiSyncApply_noAbort(OperationContext* opCtx,
     // allow us to get through the magic barrier
     opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
 
+    // Oplog application is bounded by the writer pool; don't queue it behind user operations.
+    opCtx->lockState()->setShouldAcquireTicket(false);
+
     if (oplogEntryPointers->size() > 1) {
         std::stable_sort(oplogEntryPointers->begin(),
                          oplogEntryPointers->end(),
-                         [](const OplogEntry* l, const OplogEntry* r) { return l->ns < r->ns; });
+                         [](const OplogEntry* l, const OplogEntry* r) {
+                             if (!l->isCommand() && !r->isCommand()) {
+                                 return l->ns < r->ns;
+                             }
+                             // Sort collection-local commands with the ops on their collection.
+                             return getTargetNamespaceString(*l) < getTargetNamespaceString(*r);
+                         });
     }
 
     // This function is only called in steady state replication.
@@ -1187,6 +1274,9 @@ Status multiInitialSyncApply_noAbort(OperationContext* opCtx,
     // allow us to get through the magic barrier
     opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
 
+    // Oplog application is bounded by the writer pool; don't queue it behind user operations.
+    opCtx->lockState()->setShouldAcquireTicket(false);
+
     // This function is only called in initial sync, as its name suggests.
     const bool inSteadyStateReplication = false;
 
@@ -1299,6 +1389,29 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
         }
     }
 
+    if (MONGO_FAIL_POINT(hangBeforeCompletingOplogBatch)) {
+        log() << "hangBeforeCompletingOplogBatch fail point enabled. Blocking until fail point is "
+                 "disabled.";
+        while (MONGO_FAIL_POINT(hangBeforeCompletingOplogBatch)) {
+            mongo::sleepmillis(100);
+        }
+    }
+
+    // The batch is fully applied and we still hold the ParallelBatchWriterMode lock, so this is a
+    // consistent point for secondary reads to read from while the next batch is applied.
+    if (secondaryReadsFromBatchBoundarySnapshot && replCoord->getMemberState().secondary()) {
+        if (auto snapshotManager =
+                getGlobalServiceContext()->getGlobalStorageEngine()->getSnapshotManager()) {
+            auto name = replCoord->reserveSnapshotName(nullptr);
+            Status status = snapshotManager->createBatchBoundarySnapshot(name);
+            if (!status.isOK()) {
+                warning() << "failed to create snapshot for secondary reads, which will not read "
+                             "from a snapshot until one is created: "
+                          << redact(status);
+            }
+        }
+    }
+
     // We have now written all database writes and updated the oplog to match.
     return ops.back().getOpTime();
 }
@@ -620,6 +620,49 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_BSONOBJ_EQ(op2.raw, operationsWrittenToOplog[1]);
 }
 
+TEST_F(SyncTailTest, MultiApplyAssignsCollectionLocalCommandToSameWriterAsOperationsOnCollection) {
+    NamespaceString nss("test.t");
+    OldThreadPool writerPool(4);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn = [&mutex, &operationsApplied](
+        MultiApplier::OperationPtrs* operationsForWriterThreadToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+    _storageInterface->insertDocumentsFn =
+        [](OperationContext*, const NamespaceString&, const std::vector<BSONObj>&) {
+            return Status::OK();
+        };
+
+    auto op1 = makeCreateCollectionOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("capped" << true << "size" << 4096));
+    auto op2 =
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 1));
+    auto op3 =
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL}, nss, BSON("_id" << 2));
+
+    auto lastOpTime = unittest::assertGet(
+        multiApply(_opCtx.get(), &writerPool, {op1, op2, op3}, applyOperationFn));
+    ASSERT_EQUALS(op3.getOpTime(), lastOpTime);
+
+    // The create and both inserts must be applied by one writer, in oplog order, and the inserts
+    // must not be grouped since the collection is created as capped.
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(1U, operationsApplied.size());
+    ASSERT_EQUALS(3U, operationsApplied[0].size());
+    ASSERT_EQUALS(op1, operationsApplied[0][0]);
+    ASSERT_EQUALS(op2, operationsApplied[0][1]);
+    ASSERT_EQUALS(op3, operationsApplied[0][2]);
+    ASSERT_TRUE(operationsApplied[0][1].isForCappedCollection);
+    ASSERT_TRUE(operationsApplied[0][2].isForCappedCollection);
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     auto op = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss);
@@ -704,6 +747,27 @@ TEST_F(SyncTailTest, MultiSyncApplySortsOperationsStablyByNamespaceBeforeApplyin
     ASSERT_EQUALS(op4, operationsApplied[3]);
 }
 
+TEST_F(SyncTailTest, MultiSyncApplySortsCollectionLocalCommandsWithOperationsOnTheirCollection) {
+    NamespaceString nss1("test.t1");
+    NamespaceString nss2("test.t2");
+    auto op1 =
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss2, BSON("_id" << 1));
+    auto op2 = makeCreateCollectionOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss1);
+    auto op3 =
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL}, nss1, BSON("_id" << 1));
+    MultiApplier::Operations operationsApplied;
+    auto syncApply = [&operationsApplied](OperationContext*, const BSONObj& op, bool) {
+        operationsApplied.push_back(OplogEntry(op));
+        return Status::OK();
+    };
+    MultiApplier::OperationPtrs ops = {&op1, &op2, &op3};
+    ASSERT_OK(multiSyncApply_noAbort(_opCtx.get(), &ops, syncApply));
+    ASSERT_EQUALS(3U, operationsApplied.size());
+    ASSERT_EQUALS(op2, operationsApplied[0]);
+    ASSERT_EQUALS(op3, operationsApplied[1]);
+    ASSERT_EQUALS(op1, operationsApplied[2]);
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyGroupsInsertOperationByNamespaceBeforeApplying) {
     int seconds = 0;
     auto makeOp = [&seconds](const NamespaceString& nss) {
@@ -102,6 +102,33 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
+/**
+ * Prefix-compressed spill files store the serialized form of each KV pair as the longest run of
+ * bytes it shares with the previous pair's at the same offsets, and the bytes around that run:
+ *     varint head size | head bytes | varint run size | varint tail size | tail bytes
+ * Serialized keys usually start with a size header, so the run of bytes that consecutive sorted
+ * keys share follows a head that differs whenever the sizes do.
+ */
+inline void appendVarUInt(BufBuilder& buf, uint32_t value) {
+    while (value >= 0x80) {
+        buf.appendUChar(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    buf.appendUChar(static_cast<unsigned char>(value));
+}
+
+inline uint32_t readVarUInt(BufReader& reader) {
+    uint32_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        massert(40620, "corrupt prefix-compressed sorter data", shift < 35);
+        const uint8_t byte = reader.read<uint8_t>();
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+}
+
 /** Ensures a named file is deleted when this object goes out of scope */
 class FileDeleter {
 public:
@@ -154,8 +181,10 @@ public:
 
     FileIterator(const std::string& fileName,
                  const Settings& settings,
-                 std::shared_ptr<FileDeleter> fileDeleter)
+                 std::shared_ptr<FileDeleter> fileDeleter,
+                 bool prefixCompressed = false)
         : _settings(settings),
+          _prefixCompressed(prefixCompressed),
           _done(false),
           _fileName(fileName),
           _fileDeleter(fileDeleter),
@@ -180,6 +209,10 @@ public:
         verify(!_done);
         fillIfNeeded();
 
+        if (_prefixCompressed) {
+            return nextPrefixCompressed();
+        }
+
         // Note: key must be read before value so can't pass directly to Data constructor
         auto first = Key::deserializeForSorter(*_reader, _settings.first);
         auto second = Value::deserializeForSorter(*_reader, _settings.second);
@@ -187,6 +220,29 @@ public:
     }
 
 private:
+    /**
+     * Rebuilds the serialized form of the next KV pair from the bytes it shares with the previous
+     * one, then deserializes it. Unowned results point into '_record', which the next call
+     * overwrites.
+     */
+    Data nextPrefixCompressed() {
+        const uint32_t head = readVarUInt(*_reader);
+        const char* headData = static_cast<const char*>(_reader->skip(head));
+        const uint32_t shared = readVarUInt(*_reader);
+        const uint32_t tail = readVarUInt(*_reader);
+        massert(40621,
+                "corrupt prefix-compressed sorter data",
+                shared == 0 || head + shared <= _record.size());
+        _record.resize(head + shared);
+        _record.replace(0, head, headData, head);
+        _record.append(static_cast<const char*>(_reader->skip(tail)), tail);
+
+        BufReader recordReader(_record.data(), _record.size());
+        auto first = Key::deserializeForSorter(recordReader, _settings.first);
+        auto second = Value::deserializeForSorter(recordReader, _settings.second);
+        return Data(std::move(first), std::move(second));
+    }
+
     void fillIfNeeded() {
         verify(!_done);
 
@@ -264,9 +320,11 @@ private:
     }
 
     const Settings _settings;
+    const bool _prefixCompressed;
     bool _done;
     std::unique_ptr<char[]> _buffer;
     std::unique_ptr<BufReader> _reader;
+    std::string _record;  // Serialized form of the last KV pair, if '_prefixCompressed'.
     std::string _fileName;
     std::shared_ptr<FileDeleter> _fileDeleter;  // Must outlive _file
     std::ifstream _file;
@@ -806,7 +864,7 @@ inline unsigned nextFileNumber() {
 
 template <typename Key, typename Value>
 SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings), _prefixCompress(opts.prefixCompressSpills) {
     namespace str = mongoutils::str;
 
     // This should be checked by consumers, but if we get here don't allow writes.
@@ -839,8 +897,39 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Se
 
 template <typename Key, typename Value>
 void SortedFileWriter<Key, Value>::addAlreadySorted(const Key& key, const Value& val) {
-    key.serializeForSorter(_buffer);
-    val.serializeForSorter(_buffer);
+    if (_prefixCompress) {
+        _record.reset();
+        key.serializeForSorter(_record);
+        val.serializeForSorter(_record);
+
+        const char* record = _record.buf();
+        const size_t recordSize = _record.len();
+        const size_t maxShared = std::min(recordSize, _previousRecord.size());
+        size_t head = 0;
+        size_t shared = 0;
+        for (size_t runStart = 0; runStart < maxShared;) {
+            size_t runEnd = runStart;
+            while (runEnd < maxShared && record[runEnd] == _previousRecord[runEnd]) {
+                runEnd++;
+            }
+            if (runEnd - runStart > shared) {
+                head = runStart;
+                shared = runEnd - runStart;
+            }
+            runStart = runEnd + 1;
+        }
+
+        const size_t tail = recordSize - head - shared;
+        sorter::appendVarUInt(_buffer, head);
+        _buffer.appendBuf(record, head);
+        sorter::appendVarUInt(_buffer, shared);
+        sorter::appendVarUInt(_buffer, tail);
+        _buffer.appendBuf(record + head + shared, tail);
+        _previousRecord.assign(record, recordSize);
+    } else {
+        key.serializeForSorter(_buffer);
+        val.serializeForSorter(_buffer);
+    }
 
     if (_buffer.len() > 64 * 1024)
         spill();
@@ -903,7 +992,8 @@ template <typename Key, typename Value>
 SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     spill();
     _file.close();
-    return new sorter::FileIterator<Key, Value>(_fileName, _settings, _fileDeleter);
+    return new sorter::FileIterator<Key, Value>(
+        _fileName, _settings, _fileDeleter, _prefixCompress);
 }
 
 //
@@ -98,8 +98,15 @@ struct SortOptions {
     bool extSortAllowed;         /// If false, uassert if more mem needed than allowed.
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
+    bool prefixCompressSpills;   /// If true, each spilled KV pair is stored as the bytes it
+                                 /// doesn't share with the serialized form of the previous one
+                                 /// at the same offsets.
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          prefixCompressSpills(false) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -122,6 +129,11 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& PrefixCompressSpills(bool newPrefixCompressSpills = true) {
+        prefixCompressSpills = newPrefixCompressSpills;
+        return *this;
+    }
 };
 
 /// This is the output from the sorting framework
@@ -200,10 +212,16 @@ private:
     void spill();
 
     const Settings _settings;
+    const bool _prefixCompress;
     std::string _fileName;
     std::shared_ptr<sorter::FileDeleter> _fileDeleter;  // Must outlive _file
     std::ofstream _file;
     BufBuilder _buffer;
+
+    // Used when '_prefixCompress' is set: the serialized form of the KV pair being added, and
+    // that of the one added before it.
+    BufBuilder _record;
+    std::string _previousRecord;
 };
 }
 
@@ -91,6 +91,35 @@ private:
     int _i;
 };
 
+// Serialized with a size header, like BSON and KeyString keys.
+class StringWrapper {
+public:
+    StringWrapper(std::string str = "") : _str(std::move(str)) {}
+    const std::string& str() const {
+        return _str;
+    }
+
+    /// members for Sorter
+    struct SorterDeserializeSettings {};  // unused
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendNum(static_cast<int>(_str.size()));
+        buf.appendStr(_str, /*includeEndingNull=*/false);
+    }
+    static StringWrapper deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        const int size = buf.read<LittleEndian<int>>();
+        return std::string(static_cast<const char*>(buf.skip(size)), size);
+    }
+    int memUsageForSorter() const {
+        return sizeof(StringWrapper) + _str.size();
+    }
+    StringWrapper getOwned() const {
+        return *this;
+    }
+
+private:
+    std::string _str;
+};
+
 typedef pair<IntWrapper, IntWrapper> IWPair;
 typedef SortIteratorInterface<IntWrapper, IntWrapper> IWIterator;
 typedef Sorter<IntWrapper, IntWrapper> IWSorter;
@@ -271,12 +300,70 @@ public:
             ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
                                         make_shared<IntIterator>(0, 10 * 1000 * 1000));
         }
+        {  // prefix compressed
+            const SortOptions prefixOpts = SortOptions(opts).PrefixCompressSpills();
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(prefixOpts);
+            for (int i = 0; i < 1000 * 1000; i++)
+                sorter.addAlreadySorted(i, -i);
+
+            ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
+                                        make_shared<IntIterator>(0, 1000 * 1000));
+        }
 
         ASSERT(boost::filesystem::is_empty(tempDir.path()));
     }
 };
 
 
+class SortedFileWriterPrefixCompressionTests {
+public:
+    void run() {
+        // Sorted keys that share a long prefix but, unlike consecutive integers, differ in size.
+        std::vector<std::string> keys;
+        for (int i = 0; i < 100 * 1000; i++) {
+            keys.push_back(str::stream() << "a/long/prefix/shared/by/every/key/" << i
+                                         << std::string(i % 7, 'x'));
+        }
+        std::sort(keys.begin(), keys.end());
+
+        // Spills are also compressed with snappy, which finds some of the same repetition.
+        const size_t uncompressedSize = spillSize(keys, false);
+        const size_t compressedSize = spillSize(keys, true);
+        ASSERT_LT(compressedSize, uncompressedSize / 10 * 9);
+    }
+
+private:
+    /**
+     * Spills 'keys' to a file, checks that they read back in order, and returns the file's size.
+     */
+    size_t spillSize(const std::vector<std::string>& keys, bool prefixCompress) {
+        unittest::TempDir tempDir("sortedFileWriterPrefixCompressionTests");
+        const SortOptions opts =
+            SortOptions().TempDir(tempDir.path()).PrefixCompressSpills(prefixCompress);
+
+        SortedFileWriter<StringWrapper, IntWrapper> writer(opts);
+        for (size_t i = 0; i < keys.size(); i++) {
+            writer.addAlreadySorted(keys[i], i);
+        }
+        std::unique_ptr<SortIteratorInterface<StringWrapper, IntWrapper>> it(writer.done());
+
+        size_t size = 0;
+        for (boost::filesystem::directory_iterator file(tempDir.path()), end; file != end;
+             ++file) {
+            size += boost::filesystem::file_size(file->path());
+        }
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            ASSERT(it->more());
+            const auto next = it->next();
+            ASSERT_EQ(keys[i], next.first.str());
+            ASSERT_EQ(static_cast<int>(i), next.second);
+        }
+        ASSERT(!it->more());
+        return size;
+    }
+};
+
 class MergeIteratorTests {
 public:
     void run() {
@@ -550,6 +637,7 @@ public:
     void setupTests() {
         add<InMemIterTests>();
         add<SortedFileWriterAndFileIteratorTests>();
+        add<SortedFileWriterPrefixCompressionTests>();
         add<MergeIteratorTests>();
         add<SorterTests::Basic>();
         add<SorterTests::Limit>();
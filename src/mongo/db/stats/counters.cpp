@@ -44,38 +44,31 @@ using std::endl;
 OpCounters::OpCounters() {}
 
 void OpCounters::gotInserts(int n) {
-    RARELY _checkWrap();
-    _insert.fetchAndAdd(n);
+    _insert.add(n);
 }
 
 void OpCounters::gotInsert() {
-    RARELY _checkWrap();
-    _insert.fetchAndAdd(1);
+    _insert.add(1);
 }
 
 void OpCounters::gotQuery() {
-    RARELY _checkWrap();
-    _query.fetchAndAdd(1);
+    _query.add(1);
 }
 
 void OpCounters::gotUpdate() {
-    RARELY _checkWrap();
-    _update.fetchAndAdd(1);
+    _update.add(1);
 }
 
 void OpCounters::gotDelete() {
-    RARELY _checkWrap();
-    _delete.fetchAndAdd(1);
+    _delete.add(1);
 }
 
 void OpCounters::gotGetMore() {
-    RARELY _checkWrap();
-    _getmore.fetchAndAdd(1);
+    _getmore.add(1);
 }
 
 void OpCounters::gotCommand() {
-    RARELY _checkWrap();
-    _command.fetchAndAdd(1);
+    _command.add(1);
 }
 
 void OpCounters::gotOp(int op, bool isCommand) {
@@ -106,31 +99,14 @@ void OpCounters::gotOp(int op, bool isCommand) {
     }
 }
 
-void OpCounters::_checkWrap() {
-    const unsigned MAX = 1 << 30;
-
-    bool wrap = _insert.loadRelaxed() > MAX || _query.loadRelaxed() > MAX ||
-        _update.loadRelaxed() > MAX || _delete.loadRelaxed() > MAX ||
-        _getmore.loadRelaxed() > MAX || _command.loadRelaxed() > MAX;
-
-    if (wrap) {
-        _insert.store(0);
-        _query.store(0);
-        _update.store(0);
-        _delete.store(0);
-        _getmore.store(0);
-        _command.store(0);
-    }
-}
-
 BSONObj OpCounters::getObj() const {
     BSONObjBuilder b;
-    b.append("insert", _insert.loadRelaxed());
-    b.append("query", _query.loadRelaxed());
-    b.append("update", _update.loadRelaxed());
-    b.append("delete", _delete.loadRelaxed());
-    b.append("getmore", _getmore.loadRelaxed());
-    b.append("command", _command.loadRelaxed());
+    b.appendIntOrLL("insert", _insert.get());
+    b.appendIntOrLL("query", _query.get());
+    b.appendIntOrLL("update", _update.get());
+    b.appendIntOrLL("delete", _delete.get());
+    b.appendIntOrLL("getmore", _getmore.get());
+    b.appendIntOrLL("command", _command.get());
     return b.obj();
 }
 
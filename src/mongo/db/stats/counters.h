@@ -32,6 +32,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/basic.h"
+#include "mongo/db/stats/sharded_counter.h"
 #include "mongo/util/concurrency/spin_lock.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/processinfo.h"
@@ -40,7 +41,8 @@ namespace mongo {
 
 /**
  * for storing operation counters
- * note: not thread safe.  ok with that for speed
+ * each counter is sharded across threads, so counting an operation does not contend for a cache
+ * line shared with other threads. the shards are only summed when the counters are read.
  */
 class OpCounters {
 public:
@@ -58,36 +60,32 @@ public:
     BSONObj getObj() const;
 
     // thse are used by snmp, and other things, do not remove
-    const AtomicUInt32* getInsert() const {
-        return &_insert;
+    long long getInsert() const {
+        return _insert.get();
     }
-    const AtomicUInt32* getQuery() const {
-        return &_query;
+    long long getQuery() const {
+        return _query.get();
     }
-    const AtomicUInt32* getUpdate() const {
-        return &_update;
+    long long getUpdate() const {
+        return _update.get();
     }
-    const AtomicUInt32* getDelete() const {
-        return &_delete;
+    long long getDelete() const {
+        return _delete.get();
     }
-    const AtomicUInt32* getGetMore() const {
-        return &_getmore;
+    long long getGetMore() const {
+        return _getmore.get();
     }
-    const AtomicUInt32* getCommand() const {
-        return &_command;
+    long long getCommand() const {
+        return _command.get();
     }
 
 private:
-    void _checkWrap();
-
-    // todo: there will be a lot of cache line contention on these.  need to do something
-    //       else eventually.
-    AtomicUInt32 _insert;
-    AtomicUInt32 _query;
-    AtomicUInt32 _update;
-    AtomicUInt32 _delete;
-    AtomicUInt32 _getmore;
-    AtomicUInt32 _command;
+    ShardedCounter _insert;
+    ShardedCounter _query;
+    ShardedCounter _update;
+    ShardedCounter _delete;
+    ShardedCounter _getmore;
+    ShardedCounter _command;
 };
 
 extern OpCounters globalOpCounters;
@@ -153,6 +153,20 @@ void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, His
     data->sum += latency;
 }
 
+void OperationLatencyHistogram::_mergeData(const HistogramData& other, HistogramData* data) {
+    for (int i = 0; i < kMaxBuckets; i++) {
+        data->buckets[i] += other.buckets[i];
+    }
+    data->entryCount += other.entryCount;
+    data->sum += other.sum;
+}
+
+void OperationLatencyHistogram::merge(const OperationLatencyHistogram& other) {
+    _mergeData(other._reads, &_reads);
+    _mergeData(other._writes, &_writes);
+    _mergeData(other._commands, &_commands);
+}
+
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
     int bucket = _getBucket(latency);
     switch (type) {
@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+const size_t kMaxStatsShards = 64;
+
+/**
+ * Returns the shard the calling thread should update in sharded statistics, a number in
+ * [0, kMaxStatsShards). Threads are given shards round-robin the first time they ask, so that
+ * concurrently running threads mostly land on different shards.
+ */
+size_t statsShardForCurrentThread();
+
+/**
+ * A 64-bit counter which many threads can increment without contending for a single cache line.
+ * Each thread adds into the cell for its stats shard, and each cell has a cache line to itself.
+ * Reading the counter sums the cells, so it is only suited to values which are written far more
+ * often than they are read, such as the statistics reported by serverStatus.
+ *
+ * Reads are not atomic with respect to concurrent increments, and may miss increments which
+ * happen while the cells are being summed.
+ */
+class ShardedCounter {
+public:
+    void add(int64_t n) {
+        _cells[statsShardForCurrentThread()].value.fetchAndAdd(n);
+    }
+
+    int64_t get() const {
+        int64_t total = 0;
+        for (const auto& cell : _cells) {
+            total += cell.value.loadRelaxed();
+        }
+        return total;
+    }
+
+private:
+    static const size_t kCacheLineSize = 64;
+
+    struct alignas(kCacheLineSize) Cell {
+        AtomicInt64 value{0};
+        char padding[kCacheLineSize - sizeof(AtomicInt64)];
+    };
+
+    std::array<Cell, kMaxStatsShards> _cells;
+};
+
+}  // namespace mongo
@@ -0,0 +1,81 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/sharded_counter.h"
+
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(ShardedCounterTest, StartsAtZero) {
+    ShardedCounter counter;
+    ASSERT_EQ(0, counter.get());
+}
+
+TEST(ShardedCounterTest, SumsAddsFromOneThread) {
+    ShardedCounter counter;
+    counter.add(1);
+    counter.add(41);
+    counter.add(-2);
+    ASSERT_EQ(40, counter.get());
+}
+
+TEST(ShardedCounterTest, SumsAddsFromManyThreads) {
+    const int kThreads = 2 * kMaxStatsShards + 3;
+    const int kAddsPerThread = 1000;
+
+    ShardedCounter counter;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < kAddsPerThread; j++) {
+                counter.add(1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(kThreads * kAddsPerThread, counter.get());
+}
+
+TEST(ShardedCounterTest, ThreadKeepsItsShard) {
+    const size_t shard = statsShardForCurrentThread();
+    ASSERT_LT(shard, kMaxStatsShards);
+    ASSERT_EQ(shard, statsShardForCurrentThread());
+}
+
+}  // namespace
+}  // namespace mongo
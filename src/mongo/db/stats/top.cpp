@@ -35,6 +35,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/sharded_counter.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -67,11 +68,28 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       remove(older.remove, newer.remove),
       commands(older.commands, newer.commands) {}
 
+void Top::CollectionData::add(const CollectionData& other) {
+    total.add(other.total);
+    readLock.add(other.readLock);
+    writeLock.add(other.writeLock);
+    queries.add(other.queries);
+    getmore.add(other.getmore);
+    insert.add(other.insert);
+    update.add(other.update);
+    remove.add(other.remove);
+    commands.add(other.commands);
+    opLatencyHistogram.merge(other.opLatencyHistogram);
+}
+
 // static
 Top& Top::get(ServiceContext* service) {
     return getTop(service);
 }
 
+Top::Shard& Top::_shardForCurrentThread() {
+    return _shards[statsShardForCurrentThread() % kNumShards];
+}
+
 void Top::record(OperationContext* opCtx,
                  StringData ns,
                  LogicalOp logicalOp,
@@ -82,15 +100,20 @@ void Top::record(OperationContext* opCtx,
     if (ns[0] == '?')
         return;
 
-    auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-
-    if ((command || logicalOp == LogicalOp::opQuery) && ns == _lastDropped) {
-        _lastDropped = "";
-        return;
+    if ((command || logicalOp == LogicalOp::opQuery) && _hasLastDropped.load()) {
+        stdx::lock_guard<SimpleMutex> lk(_lastDroppedLock);
+        if (ns == _lastDropped) {
+            _lastDropped = "";
+            _hasLastDropped.store(false);
+            return;
+        }
     }
 
-    CollectionData& coll = _usage[hashedNs];
+    auto hashedNs = UsageMap::HashedKey(ns);
+    Shard& shard = _shardForCurrentThread();
+    stdx::lock_guard<SimpleMutex> lk(shard.lock);
+
+    CollectionData& coll = shard.usage[hashedNs];
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
 }
 
@@ -140,23 +163,33 @@ void Top::_record(OperationContext* opCtx,
 }
 
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
+    for (auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> lk(shard.lock);
+        shard.usage.erase(ns);
+    }
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
         // collection namespace which must be ignored. This does not apply to a database drop.
+        stdx::lock_guard<SimpleMutex> lk(_lastDroppedLock);
         _lastDropped = ns.toString();
+        _hasLastDropped.store(true);
     }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    out.clear();
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> lk(shard.lock);
+        for (const auto& entry : shard.usage) {
+            out[entry.first].add(entry.second);
+        }
+    }
 }
 
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    UsageMap usage;
+    cloneMap(usage);
+    _appendToUsageMap(b, usage);
 }
 
 void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
@@ -199,9 +232,16 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    OperationLatencyHistogram histogram;
+    for (auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> lk(shard.lock);
+        auto it = shard.usage.find(hashedNs);
+        if (it != shard.usage.end()) {
+            histogram.merge(it->second.opLatencyHistogram);
+        }
+    }
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    histogram.append(includeHistograms, &latencyStatsBuilder);
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -209,13 +249,18 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    Shard& shard = _shardForCurrentThread();
+    stdx::lock_guard<SimpleMutex> guard(shard.lock);
+    _incrementHistogram(opCtx, latency, &shard.globalHistogramStats, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram histogram;
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> guard(shard.lock);
+        histogram.merge(shard.globalHistogramStats);
+    }
+    histogram.append(includeHistograms, builder);
 }
 
 void Top::_incrementHistogram(OperationContext* opCtx,
@@ -29,11 +29,13 @@
 
 #pragma once
 
+#include <array>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/string_map.h"
@@ -44,6 +46,10 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * Each thread records into one of several shards, each with its own lock, namespace map and
+ * global latency histogram, so that operations running on different threads do not serialize on
+ * a single mutex. The shards are merged when the statistics are read.
  */
 class Top {
 public:
@@ -61,6 +67,11 @@ public:
             count++;
             time += micros;
         }
+
+        void add(const UsageData& other) {
+            count += other.count;
+            time += other.time;
+        }
     };
 
     struct CollectionData {
@@ -82,6 +93,11 @@ public:
         UsageData remove;
         UsageData commands;
         OperationLatencyHistogram opLatencyHistogram;
+
+        /**
+         * Adds the usage and latencies recorded in 'other' into this one.
+         */
+        void add(const CollectionData& other);
     };
 
     enum class LockType {
@@ -125,6 +141,18 @@ public:
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
 private:
+    // Enough shards that concurrently running operations rarely share one, without multiplying
+    // the per-namespace memory by the number of threads.
+    static const size_t kNumShards = 16;
+
+    struct Shard {
+        mutable SimpleMutex lock;
+        OperationLatencyHistogram globalHistogramStats;
+        UsageMap usage;
+    };
+
+    Shard& _shardForCurrentThread();
+
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
@@ -141,9 +169,12 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
+    std::array<Shard, kNumShards> _shards;
+
+    // Set while '_lastDropped' names a namespace, so that record() only takes
+    // '_lastDroppedLock' after a collection drop.
+    AtomicWord<bool> _hasLastDropped{false};
+    SimpleMutex _lastDroppedLock;
     std::string _lastDropped;
 };
 
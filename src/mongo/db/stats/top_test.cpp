@@ -29,6 +29,12 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/stats/top.h"
+
+#include <vector>
+
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
@@ -39,4 +45,62 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+void recordInserts(ServiceContext* service, Top* top, StringData ns, int count) {
+    auto client = service->makeClient("top_test");
+    OperationContextNoop opCtx(client.get(), 0, boost::none);
+    for (int i = 0; i < count; i++) {
+        top->record(&opCtx,
+                    ns,
+                    LogicalOp::opInsert,
+                    Top::LockType::WriteLocked,
+                    2,
+                    false,
+                    Command::ReadWriteType::kWrite);
+    }
+}
+
+TEST(TopTest, MergesUsageRecordedOnManyThreads) {
+    const int kThreads = 40;
+    const int kInsertsPerThread = 100;
+
+    ServiceContextNoop service;
+    Top top;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back(
+            [&] { recordInserts(&service, &top, "test.coll", kInsertsPerThread); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(1U, usage.size());
+    const Top::CollectionData& coll = usage["test.coll"];
+    ASSERT_EQ(kThreads * kInsertsPerThread, coll.insert.count);
+    ASSERT_EQ(2 * kThreads * kInsertsPerThread, coll.insert.time);
+    ASSERT_EQ(kThreads * kInsertsPerThread, coll.writeLock.count);
+    ASSERT_EQ(kThreads * kInsertsPerThread, coll.total.count);
+    ASSERT_EQ(0, coll.queries.count);
+}
+
+TEST(TopTest, CollectionDroppedClearsEveryShard) {
+    ServiceContextNoop service;
+    Top top;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 40; i++) {
+        threads.emplace_back([&] { recordInserts(&service, &top, "test.coll", 1); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    top.collectionDropped("test.coll");
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(0U, usage.size());
+}
+
 }  // namespace
@@ -0,0 +1,226 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/bson/ordering.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/util/bufreader.h"
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+/**
+ * An index key held in KeyString form for the external sorter. Sorting and merging compare the
+ * binary-comparable KeyString bytes with memcmp instead of walking the BSON of both keys. The
+ * key's TypeBits travel with it, so toBson() recovers the original BSON key exactly.
+ *
+ * The key and its TypeBits are stored in a single buffer laid out as its serialized form:
+ *     int32 total size | int32 KeyString size | KeyString bytes | TypeBits bytes
+ *
+ * Like BSONObj, a key read back from a spill file is unowned and only valid until the next call
+ * to the iterator it came from; getOwned() copies it.
+ *
+ * TypeBits are only guaranteed to fit for keys smaller than KeyString::TypeBits::kMaxKeyBytes,
+ * see canEncode().
+ */
+class KeyStringSortKey {
+public:
+    struct SorterDeserializeSettings {};  // unused
+
+    KeyStringSortKey() = default;
+
+    KeyStringSortKey(KeyString::Version version, const BSONObj& key, Ordering ord) {
+        invariant(canEncode(key));
+        const KeyString ks(version, key, ord);
+        const size_t totalSize = kHeaderSize + ks.getSize() + ks.getTypeBits().getSize();
+
+        SharedBuffer buffer = SharedBuffer::allocate(totalSize);
+        _write(ks, buffer.get());
+        _data = buffer.get();
+        _ownedBuffer = std::move(buffer);
+    }
+
+    /**
+     * Encodes the keys in [begin, end) that canEncode() accepts and appends them to 'out', in
+     * order. Returns how many were appended. All keys of the batch are encoded with one scratch
+     * KeyString and share a single buffer, so a batch costs one allocation instead of one per key,
+     * which adds up for the many keys of a multikey document.
+     */
+    template <typename Iterator>
+    static size_t encodeBatch(KeyString::Version version,
+                              Iterator begin,
+                              Iterator end,
+                              Ordering ord,
+                              std::vector<KeyStringSortKey>* out) {
+        StackBufBuilder encoded;
+        KeyString ks(version);
+        size_t numEncoded = 0;
+        for (Iterator it = begin; it != end; ++it) {
+            if (!canEncode(*it)) {
+                continue;
+            }
+            ks.resetToKey(*it, ord);
+            _write(ks, encoded.skip(kHeaderSize + ks.getSize() + ks.getTypeBits().getSize()));
+            numEncoded++;
+        }
+
+        if (numEncoded == 0) {
+            return 0;
+        }
+
+        SharedBuffer buffer = SharedBuffer::allocate(encoded.len());
+        memcpy(buffer.get(), encoded.buf(), encoded.len());
+
+        const char* data = buffer.get();
+        for (size_t i = 0; i < numEncoded; i++) {
+            KeyStringSortKey key;
+            key._data = data;
+            key._ownedBuffer = buffer;
+            data += key.totalSize();
+            out->push_back(std::move(key));
+        }
+        return numEncoded;
+    }
+
+    /**
+     * Returns true if 'key' is small enough for its TypeBits to be encoded.
+     */
+    static bool canEncode(const BSONObj& key) {
+        return static_cast<uint32_t>(key.objsize()) < KeyString::TypeBits::kMaxKeyBytes;
+    }
+
+    /**
+     * Decodes the BSON key. 'ord' and 'version' must be those the key was built with.
+     */
+    BSONObj toBson(KeyString::Version version, Ordering ord) const {
+        BufReader reader(typeBitsData(), typeBitsSize());
+        return KeyString::toBson(keyStringData(),
+                                 keyStringSize(),
+                                 ord,
+                                 KeyString::TypeBits::fromBuffer(version, &reader));
+    }
+
+    /**
+     * Compares the KeyString bytes, which orders keys as BSONObj::woCompare() would with the
+     * Ordering the keys were built with.
+     */
+    int compare(const KeyStringSortKey& rhs) const {
+        const size_t lhsSize = keyStringSize();
+        const size_t rhsSize = rhs.keyStringSize();
+        const int result =
+            memcmp(keyStringData(), rhs.keyStringData(), std::min(lhsSize, rhsSize));
+        if (result) {
+            return result;
+        }
+        return lhsSize == rhsSize ? 0 : (lhsSize < rhsSize ? -1 : 1);
+    }
+
+    const char* keyStringData() const {
+        return _data + kHeaderSize;
+    }
+
+    size_t keyStringSize() const {
+        return ConstDataView(_data + sizeof(int32_t)).read<LittleEndian<int32_t>>();
+    }
+
+    //
+    // Members for Sorter.
+    //
+
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendBuf(_data, totalSize());
+    }
+
+    static KeyStringSortKey deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        const int32_t size = buf.peek<LittleEndian<int32_t>>();
+        KeyStringSortKey key;
+        key._data = static_cast<const char*>(buf.skip(size));
+        return key;
+    }
+
+    int memUsageForSorter() const {
+        return sizeof(KeyStringSortKey) + totalSize();
+    }
+
+    KeyStringSortKey getOwned() const {
+        if (_ownedBuffer) {
+            return *this;
+        }
+        SharedBuffer buffer = SharedBuffer::allocate(totalSize());
+        memcpy(buffer.get(), _data, totalSize());
+
+        KeyStringSortKey owned;
+        owned._data = buffer.get();
+        owned._ownedBuffer = std::move(buffer);
+        return owned;
+    }
+
+private:
+    static const size_t kHeaderSize = 2 * sizeof(int32_t);
+
+    /**
+     * Writes the serialized form of 'ks' and its TypeBits to 'dest', which must have room for it.
+     */
+    static void _write(const KeyString& ks, char* dest) {
+        const KeyString::TypeBits& typeBits = ks.getTypeBits();
+        const int32_t totalSize = kHeaderSize + ks.getSize() + typeBits.getSize();
+
+        DataView(dest).write<LittleEndian<int32_t>>(totalSize);
+        DataView(dest + sizeof(int32_t))
+            .write<LittleEndian<int32_t>>(static_cast<int32_t>(ks.getSize()));
+        memcpy(dest + kHeaderSize, ks.getBuffer(), ks.getSize());
+        memcpy(dest + kHeaderSize + ks.getSize(), typeBits.getBuffer(), typeBits.getSize());
+    }
+
+    size_t totalSize() const {
+        return ConstDataView(_data).read<LittleEndian<int32_t>>();
+    }
+
+    const char* typeBitsData() const {
+        return keyStringData() + keyStringSize();
+    }
+
+    size_t typeBitsSize() const {
+        return totalSize() - kHeaderSize - keyStringSize();
+    }
+
+    const char* _data = nullptr;
+
+    // Holds '_data' when the key is owned. Null for keys pointing into a spill file's buffer.
+    ConstSharedBuffer _ownedBuffer;
+};
+
+}  // namespace mongo
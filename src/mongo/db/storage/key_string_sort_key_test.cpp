@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/storage/key_string_sort_key.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const auto kVersion = KeyString::Version::V1;
+
+std::vector<BSONObj> sampleKeys() {
+    return {BSON("" << MINKEY << "" << 1),
+            BSON("" << BSONNULL << "" << 1),
+            BSON("" << 1 << "" << 1),
+            BSON("" << 1.5 << "" << 1),
+            BSON("" << 2LL << "" << 1),
+            BSON("" << 2 << "" << -3),
+            BSON("" << 2.0 << "" << "a"),
+            BSON("" << "abc"
+                    << ""
+                    << 1),
+            BSON("" << "abd"
+                    << ""
+                    << 1),
+            BSON("" << BSON("x" << 1) << "" << 1),
+            BSON("" << BSON_ARRAY(1 << 2) << "" << 1),
+            BSON("" << true << "" << 1),
+            BSON("" << MAXKEY << "" << 1)};
+}
+
+TEST(KeyStringSortKeyTest, RoundTripsKeysWithTypeInformation) {
+    for (auto ord : {Ordering::make(BSON("a" << 1 << "b" << 1)),
+                     Ordering::make(BSON("a" << -1 << "b" << 1))}) {
+        for (const auto& key : sampleKeys()) {
+            const KeyStringSortKey sortKey(kVersion, key, ord);
+            const BSONObj decoded = sortKey.toBson(kVersion, ord);
+            ASSERT_BSONOBJ_EQ(key, decoded);
+            ASSERT(key.binaryEqual(decoded)) << key << " decoded as " << decoded;
+        }
+    }
+}
+
+TEST(KeyStringSortKeyTest, CompareMatchesWoCompare) {
+    for (auto ord : {Ordering::make(BSON("a" << 1 << "b" << 1)),
+                     Ordering::make(BSON("a" << -1 << "b" << -1))}) {
+        const auto keys = sampleKeys();
+        for (const auto& lhs : keys) {
+            for (const auto& rhs : keys) {
+                const int expected = lhs.woCompare(rhs, ord, false);
+                const int actual = KeyStringSortKey(kVersion, lhs, ord)
+                                       .compare(KeyStringSortKey(kVersion, rhs, ord));
+                ASSERT_EQ(expected < 0, actual < 0) << lhs << " vs " << rhs;
+                ASSERT_EQ(expected == 0, actual == 0) << lhs << " vs " << rhs;
+            }
+        }
+    }
+}
+
+TEST(KeyStringSortKeyTest, SerializedKeyIsUnownedUntilGetOwned) {
+    const auto ord = Ordering::make(BSON("a" << 1));
+    const BSONObj key = BSON("" << "some string");
+    const KeyStringSortKey sortKey(kVersion, key, ord);
+
+    BufBuilder builder;
+    sortKey.serializeForSorter(builder);
+    sortKey.serializeForSorter(builder);
+
+    BufReader reader(builder.buf(), builder.len());
+    const KeyStringSortKey::SorterDeserializeSettings settings;
+    const KeyStringSortKey first = KeyStringSortKey::deserializeForSorter(reader, settings);
+    const KeyStringSortKey second = KeyStringSortKey::deserializeForSorter(reader, settings);
+    ASSERT(reader.atEof());
+    ASSERT_EQ(0, first.compare(second));
+
+    const KeyStringSortKey owned = first.getOwned();
+    ASSERT_NOT_EQUALS(first.keyStringData(), owned.keyStringData());
+    ASSERT_EQ(0, owned.compare(sortKey));
+    ASSERT_BSONOBJ_EQ(key, owned.toBson(kVersion, ord));
+}
+
+TEST(KeyStringSortKeyTest, EncodeBatchSkipsKeysTooLargeAndSharesOneBuffer) {
+    const auto ord = Ordering::make(BSON("a" << 1 << "b" << 1));
+    std::vector<BSONObj> keys = sampleKeys();
+    keys.insert(keys.begin() + 3, BSON("" << std::string(2048, 'a') << "" << 1));
+
+    std::vector<KeyStringSortKey> encoded;
+    ASSERT_EQ(keys.size() - 1,
+              KeyStringSortKey::encodeBatch(kVersion, keys.begin(), keys.end(), ord, &encoded));
+    ASSERT_EQ(keys.size() - 1, encoded.size());
+
+    keys.erase(keys.begin() + 3);
+    for (size_t i = 0; i < keys.size(); i++) {
+        ASSERT_EQ(0, encoded[i].compare(KeyStringSortKey(kVersion, keys[i], ord)));
+        ASSERT(keys[i].binaryEqual(encoded[i].toBson(kVersion, ord)));
+    }
+
+    // Owned keys of a batch are slices of the same buffer.
+    const KeyStringSortKey owned = encoded[1].getOwned();
+    ASSERT_EQ(encoded[1].keyStringData(), owned.keyStringData());
+
+    std::vector<BSONObj> tooLarge{BSON("" << std::string(2048, 'a'))};
+    ASSERT_EQ(0U,
+              KeyStringSortKey::encodeBatch(
+                  kVersion, tooLarge.begin(), tooLarge.end(), ord, &encoded));
+}
+
+TEST(KeyStringSortKeyTest, RejectsKeysTooLargeForTypeBits) {
+    ASSERT(KeyStringSortKey::canEncode(BSON("" << std::string(512, 'a'))));
+    ASSERT_FALSE(KeyStringSortKey::canEncode(BSON("" << std::string(2048, 'a'))));
+}
+
+}  // namespace
+}  // namespace mongo
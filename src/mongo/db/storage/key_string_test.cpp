@@ -1089,6 +1089,30 @@ TEST_F(KeyStringTest, RecordIds) {
     }
 }
 
+TEST_F(KeyStringTest, InvertedStringsOfManyLengths) {
+    // Descending strings are inverted a word at a time, with a byte-wise tail.
+    for (size_t len = 0; len < 40; len++) {
+        std::string str;
+        for (size_t i = 0; i < len; i++) {
+            str += static_cast<char>('a' + i % 26);
+        }
+        ROUNDTRIP(version, BSON("" << str));
+
+        if (len > 0) {
+            str[len / 2] = '\0';
+            ROUNDTRIP(version, BSON("" << str));
+        }
+
+        // Every byte but the key's end marker is inverted.
+        const KeyString ascending(version, BSON("" << str), ONE_ASCENDING);
+        const KeyString descending(version, BSON("" << str), ONE_DESCENDING);
+        ASSERT_EQ(ascending.getSize(), descending.getSize());
+        for (size_t i = 0; i + 1 < ascending.getSize(); i++) {
+            ASSERT_EQ(static_cast<char>(~ascending.getBuffer()[i]), descending.getBuffer()[i]);
+        }
+    }
+}
+
 namespace {
 const uint64_t kMinPerfMicros = 20 * 1000;
 const uint64_t kMinPerfSamples = 50 * 1000;
@@ -1251,3 +1275,149 @@ TEST_F(KeyStringTest, DecimalFromUniformDoublePerf) {
     }
     perfTest(version, numbers);
 }
+
+namespace {
+/**
+ * Measures how long encoding 'keys' with 'ord', and decoding them back, takes per key, repeating
+ * each over all keys a sufficient number of times to take at least kMinPerfMicros microseconds.
+ * Logs the time per key and the throughput in BSON bytes for both directions.
+ */
+void encodeDecodePerfTest(KeyString::Version version,
+                          StringData typeName,
+                          const std::vector<BSONObj>& keys,
+                          Ordering ord) {
+    std::vector<std::pair<std::string, std::string>> encoded;  // KeyString and TypeBits bytes.
+    size_t bsonBytes = 0;
+    for (auto&& key : keys) {
+        const KeyString ks(version, key, ord);
+        const KeyString::TypeBits& typeBits = ks.getTypeBits();
+        encoded.emplace_back(std::string(ks.getBuffer(), ks.getSize()),
+                             std::string(reinterpret_cast<const char*>(typeBits.getBuffer()),
+                                         typeBits.getSize()));
+        bsonBytes += key.objsize();
+    }
+
+    const auto measure = [&](const stdx::function<size_t()>& pass) {
+        uint64_t micros = 0;
+        uint64_t iters;
+        size_t checksum = 0;
+        for (iters = 16; iters < (1 << 30) && micros < kMinPerfMicros; iters *= 2) {
+            Timer t;
+            for (uint64_t i = 0; i < iters; i++) {
+                checksum += pass();
+            }
+            micros = t.micros();
+        }
+        // Using the result keeps the passes from being optimized away.
+        invariant(checksum > 0);
+        iters /= 2;
+        return std::make_pair(1E3 * micros / static_cast<double>(iters * keys.size()),
+                              (iters * bsonBytes) / static_cast<double>(micros));
+    };
+
+    const auto encode = measure([&] {
+        size_t bytes = 0;
+        for (auto&& key : keys) {
+            const KeyString ks(version, key, ord);
+            bytes += ks.getSize();
+        }
+        return bytes;
+    });
+
+    const auto decode = measure([&] {
+        size_t bytes = 0;
+        for (auto&& pair : encoded) {
+            BufReader reader(pair.second.data(), pair.second.size());
+            const auto typeBits = KeyString::TypeBits::fromBuffer(version, &reader);
+            const BSONObj obj =
+                KeyString::toBson(pair.first.data(), pair.first.size(), ord, typeBits);
+            bytes += obj.objsize();
+        }
+        return bytes;
+    });
+
+    log() << typeName << ": " << encode.first << " ns per "
+          << mongo::KeyString::versionToString(version) << " encode (" << encode.second
+          << " MB/s), " << decode.first << " ns per decode (" << decode.second << " MB/s)"
+          << (kDebugBuild ? " (DEBUG BUILD!)" : "");
+}
+
+std::string randomString(std::mt19937& gen, size_t maxLength, bool withNuls) {
+    std::uniform_int_distribution<size_t> lengthDist(0, maxLength);
+    std::uniform_int_distribution<int> charDist(withNuls ? 0 : 1, 127);
+    std::string str(lengthDist(gen), 'x');
+    for (auto&& c : str) {
+        c = static_cast<char>(charDist(gen));
+    }
+    return str;
+}
+}  // namespace
+
+TEST_F(KeyStringTest, StringEncodeDecodePerf) {
+    std::mt19937 gen(newSeed());
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++)
+        keys.push_back(BSON("" << randomString(gen, 64, false)));
+
+    encodeDecodePerfTest(version, "string", keys, ALL_ASCENDING);
+    encodeDecodePerfTest(version, "descending string", keys, ONE_DESCENDING);
+}
+
+TEST_F(KeyStringTest, StringWithNulsEncodeDecodePerf) {
+    std::mt19937 gen(newSeed());
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++)
+        keys.push_back(BSON("" << randomString(gen, 64, true)));
+
+    encodeDecodePerfTest(version, "string with NULs", keys, ALL_ASCENDING);
+    encodeDecodePerfTest(version, "descending string with NULs", keys, ONE_DESCENDING);
+}
+
+TEST_F(KeyStringTest, IntEncodeDecodePerf) {
+    std::mt19937 gen(newSeed());
+    std::uniform_int_distribution<int> uniformInt;
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++)
+        keys.push_back(BSON("" << uniformInt(gen)));
+
+    encodeDecodePerfTest(version, "int", keys, ALL_ASCENDING);
+    encodeDecodePerfTest(version, "descending int", keys, ONE_DESCENDING);
+}
+
+TEST_F(KeyStringTest, OIDAndDateEncodeDecodePerf) {
+    std::vector<BSONObj> oids;
+    std::vector<BSONObj> dates;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++) {
+        oids.push_back(BSON("" << OID::gen()));
+        dates.push_back(BSON("" << Date_t::fromMillisSinceEpoch(x * 1000)));
+    }
+
+    encodeDecodePerfTest(version, "ObjectId", oids, ALL_ASCENDING);
+    encodeDecodePerfTest(version, "date", dates, ALL_ASCENDING);
+}
+
+TEST_F(KeyStringTest, BinDataEncodeDecodePerf) {
+    std::mt19937 gen(newSeed());
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++) {
+        const std::string data = randomString(gen, 64, true);
+        keys.push_back(BSON("" << BSONBinData(data.data(), data.size(), BinDataGeneral)));
+    }
+
+    encodeDecodePerfTest(version, "BinData", keys, ALL_ASCENDING);
+    encodeDecodePerfTest(version, "descending BinData", keys, ONE_DESCENDING);
+}
+
+TEST_F(KeyStringTest, CompoundObjectEncodeDecodePerf) {
+    std::mt19937 gen(newSeed());
+    std::uniform_int_distribution<int> uniformInt;
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++) {
+        keys.push_back(BSON("" << BSON("name" << randomString(gen, 16, false) << "n"
+                                              << uniformInt(gen))
+                               << ""
+                               << uniformInt(gen)));
+    }
+
+    encodeDecodePerfTest(version, "compound with object", keys, ALL_ASCENDING);
+}
@@ -123,6 +123,41 @@ public:
         return {};
     }
 
+    /**
+     * Informs this RecoveryUnit that all future reads through it should be from the newest
+     * snapshot taken by a secondary at the end of an oplog batch (see
+     * SnapshotManager::createBatchBoundarySnapshot()), so that they need not wait for the batch
+     * being applied. Must be called before this RecoveryUnit opens a snapshot.
+     *
+     * Returns a non-OK status if there is no such snapshot, or if this RecoveryUnit already has a
+     * snapshot open. StorageEngines that don't support a SnapshotManager should use the default
+     * implementation.
+     */
+    virtual Status setReadFromBatchBoundarySnapshot() {
+        return {ErrorCodes::CommandNotSupported,
+                "Current storage engine does not support reading from batch boundary snapshots"};
+    }
+
+    /**
+     * Undoes setReadFromBatchBoundarySnapshot(). Must not be called with a snapshot open.
+     */
+    virtual void clearReadFromBatchBoundarySnapshot() {}
+
+    /**
+     * Returns true if setReadFromBatchBoundarySnapshot() has been called and not cleared.
+     */
+    virtual bool isReadingFromBatchBoundarySnapshot() const {
+        return false;
+    }
+
+    /**
+     * Returns the SnapshotName this recovery unit is reading from, or will read from if it has no
+     * snapshot open, or boost::none if not reading from a batch boundary snapshot.
+     */
+    virtual boost::optional<SnapshotName> getBatchBoundarySnapshot() const {
+        return {};
+    }
+
     /**
      * Gets the local SnapshotId.
      *
@@ -96,6 +96,20 @@ public:
      */
     virtual void dropAllSnapshots() = 0;
 
+    /**
+     * Creates a named snapshot of the current state of the data, which secondary reads are served
+     * from while the next batch of oplog entries is applied, and drops the previous such snapshot.
+     *
+     * Oplog application calls this at the end of each batch, while it still holds the
+     * ParallelBatchWriterMode lock, so the snapshot is consistent.
+     *
+     * If this fails, no snapshot is available for secondary reads until a later call succeeds, so
+     * they take the normal read path rather than read data older than the applied batches.
+     *
+     * Caller guarantees that this name must compare greater than all existing snapshots.
+     */
+    virtual Status createBatchBoundarySnapshot(const SnapshotName& name) = 0;
+
 protected:
     /**
      * SnapshotManagers are not intended to be deleted through pointers to base type.
@@ -69,6 +69,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/adaptive_ticket_sizer.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/exit.h"
@@ -177,11 +178,193 @@ TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// When enabled, the sizes of the two TicketHolders above are adjusted continuously by the
+// WiredTigerConcurrencyAdjuster, within [min, max]. Manual changes to
+// wiredTigerConcurrent{Read,Write}Transactions are then only starting points.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerAdaptiveConcurrency, bool, false);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyMinTickets, int, 16);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyMaxTickets, int, 512);
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
+
+stdx::function<bool(StringData)> requestCappedDeleteCallback = [](StringData) -> bool {
+    return false;
+};
 }  // namespace
 
+/**
+ * Resizes the read and write TicketHolders from observed saturation, throughput and cache
+ * pressure. See AdaptiveTicketSizer for the policy.
+ */
+class WiredTigerKVEngine::WiredTigerConcurrencyAdjuster : public BackgroundJob {
+public:
+    explicit WiredTigerConcurrencyAdjuster(WT_CONNECTION* conn)
+        : BackgroundJob(false /* deleteSelf */), _conn(conn) {}
+
+    virtual string name() const {
+        return "WTConcurrencyAdjuster";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        AdaptiveTicketSizer::Options options;
+        options.minTickets = wiredTigerAdaptiveConcurrencyMinTickets;
+        options.maxTickets = wiredTigerAdaptiveConcurrencyMaxTickets;
+        AdaptiveTicketSizer readSizer(options);
+        AdaptiveTicketSizer writeSizer(options);
+
+        WiredTigerSession session(_conn);
+        auto previous = _readStats(session.getSession());
+
+        int samples = 0;
+        int readSaturatedSamples = 0;
+        int writeSaturatedSamples = 0;
+
+        while (!_shuttingDown.load()) {
+            {
+                MONGO_IDLE_THREAD_BLOCK;
+                sleepmillis(kSampleIntervalMillis);
+            }
+
+            // TicketHolder::available() is cheap, so saturation is sampled much more often than
+            // the sizes are adjusted.
+            ++samples;
+            readSaturatedSamples += openReadTransaction.available() == 0;
+            writeSaturatedSamples += openWriteTransaction.available() == 0;
+            if (samples < kSamplesPerAdjustment) {
+                continue;
+            }
+
+            auto current = _readStats(session.getSession());
+            if (current && previous) {
+                const double seconds =
+                    durationCount<Milliseconds>(current->when - previous->when) / 1000.0;
+                const double cachePressure = _cachePressure(*previous, *current);
+
+                // Read-only WiredTiger transactions are rolled back rather than committed.
+                _adjust(&openReadTransaction,
+                        &readSizer,
+                        2 * readSaturatedSamples >= samples,
+                        (current->rollbacks - previous->rollbacks) / seconds,
+                        cachePressure,
+                        "read");
+                _adjust(&openWriteTransaction,
+                        &writeSizer,
+                        2 * writeSaturatedSamples >= samples,
+                        (current->commits - previous->commits) / seconds,
+                        cachePressure,
+                        "write");
+            }
+
+            previous = std::move(current);
+            samples = 0;
+            readSaturatedSamples = 0;
+            writeSaturatedSamples = 0;
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        wait();
+    }
+
+private:
+    static const int kSampleIntervalMillis = 100;
+    static const int kSamplesPerAdjustment = 10;
+
+    struct Stats {
+        Date_t when;
+        uint64_t bytesInUse;
+        uint64_t bytesDirty;
+        uint64_t bytesMax;
+        uint64_t appEvictions;
+        uint64_t commits;
+        uint64_t rollbacks;
+    };
+
+    static boost::optional<Stats> _readStats(WT_SESSION* session) {
+        Stats stats;
+        stats.when = Date_t::now();
+
+        const std::pair<int, uint64_t*> keys[] = {
+            {WT_STAT_CONN_CACHE_BYTES_INUSE, &stats.bytesInUse},
+            {WT_STAT_CONN_CACHE_BYTES_DIRTY, &stats.bytesDirty},
+            {WT_STAT_CONN_CACHE_BYTES_MAX, &stats.bytesMax},
+            {WT_STAT_CONN_CACHE_EVICTION_APP, &stats.appEvictions},
+            {WT_STAT_CONN_TXN_COMMIT, &stats.commits},
+            {WT_STAT_CONN_TXN_ROLLBACK, &stats.rollbacks},
+        };
+        for (auto&& key : keys) {
+            auto value = WiredTigerUtil::getStatisticsValue(
+                session, "statistics:", "statistics=(fast)", key.first);
+            if (!value.isOK()) {
+                LOG(1) << "unable to read WiredTiger statistics for concurrency adjustment: "
+                       << value.getStatus();
+                return boost::none;
+            }
+            *key.second = value.getValue();
+        }
+
+        return stats;
+    }
+
+    /**
+     * Normalizes cache usage against WiredTiger's default eviction triggers (95% used, 20% dirty),
+     * so that 1.0 means application threads are being drafted into eviction. Any application
+     * thread eviction during the interval counts as full pressure.
+     */
+    static double _cachePressure(const Stats& previous, const Stats& current) {
+        if (current.appEvictions > previous.appEvictions) {
+            return 1.0;
+        }
+
+        if (current.bytesMax == 0) {
+            return 0;
+        }
+
+        const double max = static_cast<double>(current.bytesMax);
+        return std::max(current.bytesInUse / (max * 0.95), current.bytesDirty / (max * 0.20));
+    }
+
+    static void _adjust(TicketHolder* holder,
+                        AdaptiveTicketSizer* sizer,
+                        bool saturated,
+                        double throughput,
+                        double cachePressure,
+                        StringData kind) {
+        AdaptiveTicketSizer::Sample sample;
+        sample.totalTickets = holder->outof();
+        sample.saturated = saturated;
+        sample.throughput = throughput;
+        sample.cachePressure = cachePressure;
+
+        const int newSize = sizer->nextSize(sample);
+        if (newSize == sample.totalTickets) {
+            return;
+        }
+
+        LOG(1) << "adjusting WiredTiger concurrent " << kind << " transactions from "
+               << sample.totalTickets << " to " << newSize << " (throughput: " << throughput
+               << "/s, cache pressure: " << cachePressure << ")";
+
+        // Shrinking doesn't wait: tickets in use beyond the new size are retired when released.
+        Status status = holder->resize(newSize);
+        if (!status.isOK()) {
+            warning() << "failed to resize WiredTiger concurrent " << kind
+                      << " transactions: " << status;
+        }
+    }
+
+    WT_CONNECTION* _conn;
+    AtomicBool _shuttingDown{false};
+};
+
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        const std::string& path,
                                        ClockSource* cs,
@@ -290,6 +473,19 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sizeStorer->fillCache();
 
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+
+    if (wiredTigerAdaptiveConcurrency && !_readOnly) {
+        // TicketHolder cannot be resized below 5 tickets.
+        if (wiredTigerAdaptiveConcurrencyMinTickets < 5 ||
+            wiredTigerAdaptiveConcurrencyMinTickets > wiredTigerAdaptiveConcurrencyMaxTickets) {
+            severe() << "wiredTigerAdaptiveConcurrencyMinTickets must be at least 5 and no larger "
+                     << "than wiredTigerAdaptiveConcurrencyMaxTickets";
+            fassertFailedNoTrace(40436);
+        }
+
+        _concurrencyAdjuster = stdx::make_unique<WiredTigerConcurrencyAdjuster>(_conn);
+        _concurrencyAdjuster->go();
+    }
 }
 
 
@@ -317,6 +513,7 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("totalTickets", openReadTransaction.outof());
         bbb.done();
     }
+    bb.append("adaptive", wiredTigerAdaptiveConcurrency);
     bb.done();
 }
 
@@ -328,6 +525,8 @@ void WiredTigerKVEngine::cleanShutdown() {
         // these must be the last things we do before _conn->close();
         if (_journalFlusher)
             _journalFlusher->shutdown();
+        if (_concurrencyAdjuster)
+            _concurrencyAdjuster->shutdown();
         _sizeStorer.reset();
         _sessionCache->shuttingDown();
 
@@ -738,4 +937,12 @@ void WiredTigerKVEngine::setInitRsOplogBackgroundThreadCallback(
 bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
     return initRsOplogBackgroundThreadCallback(ns);
 }
+
+void WiredTigerKVEngine::setRequestCappedDeleteCallback(stdx::function<bool(StringData)> cb) {
+    requestCappedDeleteCallback = std::move(cb);
+}
+
+bool WiredTigerKVEngine::requestCappedDelete(StringData ns) {
+    return requestCappedDeleteCallback(ns);
+}
 }
@@ -158,10 +158,24 @@ public:
      */
     static bool initRsOplogBackgroundThread(StringData ns);
 
+    /**
+     * Sets the implementation for `requestCappedDelete`. Like
+     * setInitRsOplogBackgroundThreadCallback(), intended to be called from a MONGO_INITIALIZER.
+     */
+    static void setRequestCappedDeleteCallback(stdx::function<bool(StringData)> cb);
+
+    /**
+     * Asks the background capped deleter to delete the excess documents of the size-capped
+     * collection 'ns'. Returns false if there is no background capped deleter, in which case
+     * inserts must delete the excess documents themselves.
+     */
+    static bool requestCappedDelete(StringData ns);
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
 private:
     class WiredTigerJournalFlusher;
+    class WiredTigerConcurrencyAdjuster;
 
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
@@ -185,6 +199,7 @@ private:
     bool _ephemeral;
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
+    std::unique_ptr<WiredTigerConcurrencyAdjuster> _concurrencyAdjuster;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -44,6 +44,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -79,6 +80,11 @@ static const int kMaximumRecordStoreVersion = 1;
 MONGO_STATIC_ASSERT(kCurrentRecordStoreVersion >= kMinimumRecordStoreVersion);
 MONGO_STATIC_ASSERT(kCurrentRecordStoreVersion <= kMaximumRecordStoreVersion);
 
+// How far, in bytes, a size-capped collection may grow past its cap before inserts start deleting
+// its oldest documents themselves instead of leaving that to the background capped deleter. The
+// margin is never more than a tenth of the collection's cap.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerCappedDeleteSlackBytes, long long, 16 * 1024 * 1024);
+
 bool shouldUseOplogHack(OperationContext* opCtx, const std::string& uri) {
     StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
     if (!appMetadata.isOK()) {
@@ -779,10 +785,10 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
       _isEphemeral(isEphemeral),
       _isOplog(NamespaceString::oplog(ns)),
       _cappedMaxSize(cappedMaxSize),
-      _cappedMaxSizeSlack(std::min(cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(cappedMaxDocs),
       _cappedSleep(0),
       _cappedSleepMS(0),
+      _cappedBackgroundDeletes(0),
       _cappedCallback(cappedCallback),
       _cappedDeleteCheckCount(0),
       _useOplogHack(shouldUseOplogHack(ctx, _uri)),
@@ -1006,6 +1012,10 @@ bool WiredTigerRecordStore::cappedAndNeedDelete() const {
     return false;
 }
 
+int64_t WiredTigerRecordStore::_cappedMaxSizeSlack() const {
+    return std::min(_cappedMaxSize / 10, int64_t(wiredTigerCappedDeleteSlackBytes.load()));
+}
+
 int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* opCtx,
                                                     const RecordId& justInserted) {
     invariant(!_oplogStones);
@@ -1017,6 +1027,15 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* opCtx,
     if (!cappedAndNeedDelete())
         return 0;
 
+    // Collections capped by size alone have their excess deleted by a background thread, when
+    // there is one. Inserts only apply back-pressure once the collection is too far over its cap
+    // for the background thread to be keeping up. A cap on the number of documents has to be
+    // exact, so it is always enforced here. Only the first insert over the cap queues a request.
+    if (_cappedMaxDocs == -1 && _requestCappedDelete()) {
+        if ((_dataSize.load() - _cappedMaxSize) < _cappedMaxSizeSlack())
+            return 0;
+    }
+
     // ensure only one thread at a time can do deletes, otherwise they'll conflict.
     boost::unique_lock<boost::timed_mutex> lock(_cappedDeleterMutex, boost::defer_lock);  // NOLINT
 
@@ -1026,7 +1045,7 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* opCtx,
         if (!lock.try_lock()) {
             // Someone else is deleting old records. Apply back-pressure if too far behind,
             // otherwise continue.
-            if ((_dataSize.load() - _cappedMaxSize) < _cappedMaxSizeSlack)
+            if ((_dataSize.load() - _cappedMaxSize) < _cappedMaxSizeSlack())
                 return 0;
 
             // Don't wait forever: we're in a transaction, we could block eviction.
@@ -1041,7 +1060,7 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* opCtx,
 
             // If we already waited, let someone else do cleanup unless we are significantly
             // over the limit.
-            if ((_dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack))
+            if ((_dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack()))
                 return 0;
         }
     }
@@ -1182,6 +1201,45 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded_inlock(OperationContext* opC
     return docsRemoved;
 }
 
+bool WiredTigerRecordStore::_requestCappedDelete() {
+    if (_cappedDeleteRequested.load()) {
+        return true;
+    }
+    if (_cappedDeleteRequested.swap(true)) {
+        return true;
+    }
+    if (!WiredTigerKVEngine::requestCappedDelete(ns())) {
+        // There is no background capped deleter, so inserts delete the excess themselves.
+        _cappedDeleteRequested.store(false);
+        return false;
+    }
+    return true;
+}
+
+int64_t WiredTigerRecordStore::cappedDeleteExcessInBackground(OperationContext* opCtx) {
+    invariant(!_oplogStones);
+
+    // Inserts from now on may have to request another pass.
+    _cappedDeleteRequested.store(false);
+
+    if (!cappedAndNeedDelete())
+        return 0;
+
+    stdx::lock_guard<boost::timed_mutex> lock(_cappedDeleterMutex);  // NOLINT
+    if (_shuttingDown)
+        return 0;
+
+    // Only delete records that are visible. Everything before the oldest uncommitted record is.
+    RecordId deleteBefore = lowestCappedHiddenRecord();
+    if (deleteBefore.isNull()) {
+        deleteBefore = RecordId::max();
+    }
+
+    int64_t docsRemoved = cappedDeleteAsNeeded_inlock(opCtx, deleteBefore);
+    _cappedBackgroundDeletes.fetchAndAdd(docsRemoved);
+    return docsRemoved;
+}
+
 bool WiredTigerRecordStore::yieldAndAwaitOplogDeletionRequest(OperationContext* opCtx) {
     // Create another reference to the oplog stones while holding a lock on the collection to
     // prevent it from being destructed.
@@ -1627,6 +1685,7 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* opCtx,
         result->appendIntOrLL("maxSize", static_cast<long long>(_cappedMaxSize / scale));
         result->appendIntOrLL("sleepCount", _cappedSleep.load());
         result->appendIntOrLL("sleepMS", _cappedSleepMS.load());
+        result->appendIntOrLL("backgroundDeletedRecords", _cappedBackgroundDeletes.load());
     }
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSession(opCtx);
     WT_SESSION* s = session->getSession();
@@ -242,6 +242,14 @@ public:
 
     int64_t cappedDeleteAsNeeded_inlock(OperationContext* opCtx, const RecordId& justInserted);
 
+    /**
+     * Deletes the oldest visible records of this size-capped collection until it fits its cap
+     * again, or a batch limit is reached. Called by the background capped deleter, with the
+     * collection locked. Returns the number of records deleted. Inserts which find the collection
+     * over its cap after this is called request another background delete.
+     */
+    int64_t cappedDeleteExcessInBackground(OperationContext* opCtx);
+
     boost::timed_mutex& cappedDeleterMutex() {  // NOLINT
         return _cappedDeleterMutex;
     }
@@ -277,6 +285,13 @@ private:
     RecordId _nextId();
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
+    int64_t _cappedMaxSizeSlack() const;  // when to start applying backpressure
+
+    /**
+     * Asks the background capped deleter to delete this collection's excess, unless that has
+     * already been asked. Returns false if there is no background capped deleter.
+     */
+    bool _requestCappedDelete();
     void _changeNumRecords(OperationContext* opCtx, int64_t diff);
     void _increaseDataSize(OperationContext* opCtx, int64_t amount);
     RecordData _getData(const WiredTigerCursor& cursor) const;
@@ -295,11 +310,14 @@ private:
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
     const int64_t _cappedMaxSize;
-    const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
     RecordId _cappedFirstRecord;
     AtomicInt64 _cappedSleep;
     AtomicInt64 _cappedSleepMS;
+    AtomicInt64 _cappedBackgroundDeletes;  // Records deleted by the background capped deleter.
+    // Set by the first insert which requests a background delete, so that later inserts don't
+    // queue the same request again. Cleared once the background capped deleter gets to it.
+    AtomicBool _cappedDeleteRequested{false};
     CappedCallback* _cappedCallback;
     stdx::mutex _cappedCallbackMutex;  // guards _cappedCallback.
 
@@ -45,8 +45,10 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 
@@ -151,8 +153,112 @@ bool initRsOplogBackgroundThread(StringData ns) {
     return true;
 }
 
+/**
+ * Deletes the excess documents of size-capped collections other than the oplog, so that inserts
+ * into them don't have to. Collections are queued by requestCappedDelete() and serviced in turn.
+ */
+class WiredTigerCappedDeleterThread : public BackgroundJob {
+public:
+    WiredTigerCappedDeleterThread() : BackgroundJob(false /* deleteSelf */) {}
+
+    virtual std::string name() const {
+        return "WTCappedDeleter";
+    }
+
+    void request(const NamespaceString& nss) {
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            if (!_requested.insert(nss).second) {
+                return;
+            }
+        }
+        _requestedCV.notify_one();
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        while (!globalInShutdownDeprecated()) {
+            NamespaceString nss;
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                if (_requested.empty()) {
+                    // Wake up periodically to notice shutdown.
+                    MONGO_IDLE_THREAD_BLOCK;
+                    _requestedCV.wait_for(lock, Seconds(1).toSystemDuration());
+                    continue;
+                }
+                nss = *_requested.begin();
+                _requested.erase(_requested.begin());
+            }
+
+            _deleteExcessDocuments(nss);
+        }
+    }
+
+private:
+    void _deleteExcessDocuments(const NamespaceString& nss) {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+
+        try {
+            AutoGetDb autoDb(&opCtx, nss.db(), MODE_IX);
+            Database* db = autoDb.getDb();
+            if (!db) {
+                return;
+            }
+
+            Lock::CollectionLock collectionLock(opCtx.lockState(), nss.ns(), MODE_IX);
+            Collection* collection = db->getCollection(&opCtx, nss);
+            if (!collection || !collection->isCapped()) {
+                return;
+            }
+
+            OldClientContext ctx(&opCtx, nss.ns(), false);
+            WiredTigerRecordStore* rs =
+                checked_cast<WiredTigerRecordStore*>(collection->getRecordStore());
+
+            // Each call deletes a bounded batch, so keep going until the collection fits its cap.
+            while (!globalInShutdownDeprecated() && rs->cappedDeleteExcessInBackground(&opCtx)) {
+            }
+        } catch (const std::exception& e) {
+            severe() << "error in WiredTigerCappedDeleterThread: " << e.what();
+            fassertFailedNoTrace(!"error in WiredTigerCappedDeleterThread");
+        } catch (...) {
+            fassertFailedNoTrace(!"unknown error in WiredTigerCappedDeleterThread");
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _requestedCV;
+    std::set<NamespaceString> _requested;
+};
+
+bool requestCappedDelete(StringData ns) {
+    if (storageGlobalParams.repair) {
+        return false;
+    }
+
+    // Once shutdown has started the thread stops servicing requests, so let the inserter delete.
+    if (globalInShutdownDeprecated()) {
+        return false;
+    }
+
+    // Started by the first request. Never freed, since inserts may still reach here while the
+    // thread is exiting.
+    static WiredTigerCappedDeleterThread* const cappedDeleterThread = [] {
+        log() << "Starting WiredTigerCappedDeleterThread";
+        auto thread = new WiredTigerCappedDeleterThread();
+        thread->go();
+        return thread;
+    }();
+    cappedDeleterThread->request(NamespaceString(ns));
+    return true;
+}
+
 MONGO_INITIALIZER(SetInitRsOplogBackgroundThreadCallback)(InitializerContext* context) {
     WiredTigerKVEngine::setInitRsOplogBackgroundThreadCallback(initRsOplogBackgroundThread);
+    WiredTigerKVEngine::setRequestCappedDeleteCallback(requestCappedDelete);
     return Status::OK();
 }
 
@@ -40,6 +40,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -1076,6 +1077,58 @@ TEST(WiredTigerRecordStoreTest, CappedCursorYieldFirst) {
     ASSERT(!cursor->next());
 }
 
+TEST(WiredTigerRecordStoreTest, CappedDeleteInBackground) {
+    // Pretend there is a background capped deleter, so that inserts leave the excess to it.
+    int deleteRequests = 0;
+    WiredTigerKVEngine::setRequestCappedDeleteCallback([&deleteRequests](StringData ns) {
+        ASSERT_EQ("a.b", ns);
+        deleteRequests++;
+        return true;
+    });
+    ON_BLOCK_EXIT([] {
+        WiredTigerKVEngine::setRequestCappedDeleteCallback([](StringData) { return false; });
+    });
+
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 10000, -1));
+    WiredTigerRecordStore* wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+
+    // Go 500 bytes over the cap, which is within the back-pressure margin of a tenth of the cap.
+    const std::string data(100, 'x');
+    for (int i = 0; i < 105; i++) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size(), false).getStatus());
+        uow.commit();
+    }
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    ASSERT_EQ(105, rs->numRecords(opCtx.get()));
+
+    // Only the first insert over the cap queued a request.
+    ASSERT_EQ(1, deleteRequests);
+
+    ASSERT_EQ(5, wtrs->cappedDeleteExcessInBackground(opCtx.get()));
+    ASSERT_EQ(100, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(10000, rs->dataSize(opCtx.get()));
+    ASSERT_EQ(0, wtrs->cappedDeleteExcessInBackground(opCtx.get()));
+
+    // Once the background deleter has run, the next insert over the cap requests it again.
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size(), false).getStatus());
+        uow.commit();
+    }
+    ASSERT_EQ(2, deleteRequests);
+    ASSERT_EQ(1, wtrs->cappedDeleteExcessInBackground(opCtx.get()));
+
+    // The oldest records were the ones deleted.
+    auto cursor = rs->getCursor(opCtx.get());
+    auto record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQ(RecordId(7), record->id);
+}
+
 BSONObj makeBSONObjWithSize(const Timestamp& opTime, int size, char fill = 'x') {
     BSONObj objTemplate = BSON("ts" << opTime << "str"
                                     << "");
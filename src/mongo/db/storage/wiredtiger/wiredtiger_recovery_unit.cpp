@@ -231,6 +231,37 @@ boost::optional<SnapshotName> WiredTigerRecoveryUnit::getMajorityCommittedSnapsh
     return _majorityCommittedSnapshot;
 }
 
+Status WiredTigerRecoveryUnit::setReadFromBatchBoundarySnapshot() {
+    if (_active) {
+        return {ErrorCodes::IllegalOperation,
+                "Cannot read from a batch boundary snapshot with a snapshot already open"};
+    }
+    if (_readFromMajorityCommittedSnapshot) {
+        return {ErrorCodes::IllegalOperation,
+                "Cannot read from a batch boundary snapshot when reading majority committed data"};
+    }
+    if (!_sessionCache->snapshotManager().getNewestBatchBoundarySnapshot()) {
+        return {ErrorCodes::OperationFailed, "No batch boundary snapshot is available."};
+    }
+
+    _readFromBatchBoundarySnapshot = true;
+    return Status::OK();
+}
+
+void WiredTigerRecoveryUnit::clearReadFromBatchBoundarySnapshot() {
+    invariant(!_active);
+    _readFromBatchBoundarySnapshot = false;
+}
+
+boost::optional<SnapshotName> WiredTigerRecoveryUnit::getBatchBoundarySnapshot() const {
+    if (!_readFromBatchBoundarySnapshot)
+        return {};
+    if (_active)
+        return _batchBoundarySnapshot;
+    // The next transaction starts on the newest snapshot, which is no older than this one.
+    return _sessionCache->snapshotManager().getNewestBatchBoundarySnapshot();
+}
+
 void WiredTigerRecoveryUnit::_txnOpen(OperationContext* opCtx) {
     invariant(!_active);
     _ensureSession();
@@ -244,6 +275,9 @@ void WiredTigerRecoveryUnit::_txnOpen(OperationContext* opCtx) {
     if (_readFromMajorityCommittedSnapshot) {
         _majorityCommittedSnapshot =
             _sessionCache->snapshotManager().beginTransactionOnCommittedSnapshot(s);
+    } else if (_readFromBatchBoundarySnapshot) {
+        _batchBoundarySnapshot =
+            _sessionCache->snapshotManager().beginTransactionOnBatchBoundarySnapshot(s);
     } else {
         invariantWTOK(s->begin_transaction(s, NULL));
     }
@@ -80,6 +80,14 @@ public:
 
     boost::optional<SnapshotName> getMajorityCommittedSnapshot() const final;
 
+    Status setReadFromBatchBoundarySnapshot() final;
+    void clearReadFromBatchBoundarySnapshot() final;
+    bool isReadingFromBatchBoundarySnapshot() const final {
+        return _readFromBatchBoundarySnapshot;
+    }
+
+    boost::optional<SnapshotName> getBatchBoundarySnapshot() const final;
+
     // ---- WT STUFF
 
     WiredTigerSession* getSession(OperationContext* opCtx);
@@ -135,6 +143,8 @@ private:
     RecordId _oplogReadTill;
     bool _readFromMajorityCommittedSnapshot = false;
     SnapshotName _majorityCommittedSnapshot = SnapshotName::min();
+    bool _readFromBatchBoundarySnapshot = false;
+    SnapshotName _batchBoundarySnapshot = SnapshotName::min();
     std::unique_ptr<Timer> _timer;
 
     typedef std::vector<std::unique_ptr<Change>> Changes;
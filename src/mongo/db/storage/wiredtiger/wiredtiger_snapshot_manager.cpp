@@ -74,9 +74,34 @@ void WiredTigerSnapshotManager::cleanupUnneededSnapshots() {
 void WiredTigerSnapshotManager::dropAllSnapshots() {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _committedSnapshot = boost::none;
+    _batchBoundarySnapshot = boost::none;
     invariantWTOK(_session->snapshot(_session, "drop=(all)"));
 }
 
+Status WiredTigerSnapshotManager::createBatchBoundarySnapshot(const SnapshotName& name) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    if (!_session)
+        return {ErrorCodes::ShutdownInProgress, "snapshot manager is shut down"};
+
+    // '_session' is never in a transaction, so WiredTiger names the current state of the data.
+    const std::string config = str::stream() << "name=" << name.asU64();
+    Status status = wtRCToStatus(_session->snapshot(_session, config.c_str()));
+
+    // A previous snapshot older than the committed snapshot may already have been dropped by
+    // cleanupUnneededSnapshots(), and will be if it hasn't, so only drop newer ones here.
+    if (_batchBoundarySnapshot &&
+        (!_committedSnapshot || *_committedSnapshot < *_batchBoundarySnapshot)) {
+        const std::string dropConfig = str::stream() << "drop=(names=["
+                                                     << _batchBoundarySnapshot->asU64() << "])";
+        invariantWTOK(_session->snapshot(_session, dropConfig.c_str()));
+    }
+
+    // Without a snapshot of this batch boundary, the previous ones are too old to read from.
+    _batchBoundarySnapshot = status.isOK() ? boost::make_optional(name) : boost::none;
+    _batchBoundarySnapshotAvailable = status.isOK();
+    return status;
+}
+
 void WiredTigerSnapshotManager::shutdown() {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     if (!_session)
@@ -106,4 +131,37 @@ SnapshotName WiredTigerSnapshotManager::beginTransactionOnCommittedSnapshot(
     return *_committedSnapshot;
 }
 
+boost::optional<SnapshotName>
+WiredTigerSnapshotManager::_getNewestBatchBoundarySnapshot_inlock() const {
+    // cleanupUnneededSnapshots() never drops the committed snapshot or anything newer, so under
+    // '_mutex' whichever of the two is newer still exists. Both are consistent.
+    if (!_batchBoundarySnapshotAvailable)
+        return boost::none;
+    if (_batchBoundarySnapshot &&
+        (!_committedSnapshot || *_committedSnapshot < *_batchBoundarySnapshot))
+        return _batchBoundarySnapshot;
+    return _committedSnapshot;
+}
+
+boost::optional<SnapshotName> WiredTigerSnapshotManager::getNewestBatchBoundarySnapshot() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _getNewestBatchBoundarySnapshot_inlock();
+}
+
+SnapshotName WiredTigerSnapshotManager::beginTransactionOnBatchBoundarySnapshot(
+    WT_SESSION* session) const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    auto name = _getNewestBatchBoundarySnapshot_inlock();
+    uassert(ErrorCodes::OperationFailed,
+            "Batch boundary snapshot disappeared while running operation",
+            name);
+
+    StringBuilder config;
+    config << "snapshot=" << name->asU64();
+    invariantWTOK(session->begin_transaction(session, config.str().c_str()));
+
+    return *name;
+}
+
 }  // namespace mongo
@@ -56,6 +56,7 @@ public:
     void setCommittedSnapshot(const SnapshotName& name) final;
     void cleanupUnneededSnapshots() final;
     void dropAllSnapshots() final;
+    Status createBatchBoundarySnapshot(const SnapshotName& name) final;
 
     //
     // WT-specific methods
@@ -83,9 +84,29 @@ public:
      */
     boost::optional<SnapshotName> getMinSnapshotForNextCommittedRead() const;
 
+    /**
+     * Starts a transaction on the newest snapshot taken at the end of an oplog batch, or on the
+     * committed snapshot if it is newer, and returns the SnapshotName used. Both are consistent.
+     *
+     * Throws if there is currently no such snapshot.
+     */
+    SnapshotName beginTransactionOnBatchBoundarySnapshot(WT_SESSION* session) const;
+
+    /**
+     * Returns the SnapshotName the next call to beginTransactionOnBatchBoundarySnapshot() would
+     * use, or boost::none if there is currently no such snapshot, or if the last snapshot of a
+     * batch boundary failed to be created.
+     */
+    boost::optional<SnapshotName> getNewestBatchBoundarySnapshot() const;
+
 private:
+    boost::optional<SnapshotName> _getNewestBatchBoundarySnapshot_inlock() const;
+
     mutable stdx::mutex _mutex;  // Guards all members.
     boost::optional<SnapshotName> _committedSnapshot;
+    boost::optional<SnapshotName> _batchBoundarySnapshot;
+    // False from a failed createBatchBoundarySnapshot() until the next successful one.
+    bool _batchBoundarySnapshotAvailable = true;
     WT_SESSION* _session;  // only used for dropping snapshots.
 };
 }
@@ -120,6 +120,10 @@ private:
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
+        // The TTL monitor is a single thread, so it must not be starved by user operations queued
+        // for storage engine tickets. It is still subject to admission control, but goes first.
+        opCtx.lockState()->setHighTicketPriority(true);
+
         // If part of replSet but not in a readable state (e.g. during initial sync), skip.
         if (repl::getGlobalReplicationCoordinator()->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
@@ -35,6 +35,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/catalog/index_create_impl.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
@@ -42,6 +43,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_d.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/scopeguard.h"
 
 namespace IndexUpdateTests {
 
@@ -266,6 +268,77 @@ public:
     }
 };
 
+/**
+ * A foreground build which generates keys on several threads, each feeding its own sorted run,
+ * produces a complete index in key order, tracks multikeyness from every run and reports
+ * duplicates found across runs.
+ */
+class InsertBuildParallelKeyGeneration : public IndexBuildBase {
+public:
+    void run() {
+        const int oldThreads = indexBuildKeyGenerationThreads.load();
+        ON_BLOCK_EXIT([&] { indexBuildKeyGenerationThreads.store(oldThreads); });
+        indexBuildKeyGenerationThreads.store(4);
+
+        // More documents than fit in one key generation batch, inserted out of key order.
+        const int numDocs = 10000;
+        Collection* coll = collection();
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < numDocs; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx, BSON("_id" << i << "a" << (i * 7919) % numDocs), nullOpDebug, true));
+            }
+            // The last document is an array, so only one run sees a multikey document. Its
+            // first element duplicates the key of the document with _id 0.
+            ASSERT_OK(coll->insertDocument(&_opCtx,
+                                           BSON("_id" << numDocs << "a" << BSON_ARRAY(0 << -1)),
+                                           nullOpDebug,
+                                           true));
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        const BSONObj spec = BSON("name"
+                                  << "a_1"
+                                  << "ns"
+                                  << _ns
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion)
+                                  << "unique"
+                                  << true);
+        ASSERT_OK(indexer.init(spec).getStatus());
+
+        std::set<RecordId> dups;
+        ASSERT_OK(indexer.insertAllDocumentsInCollection(&dups));
+        ASSERT_EQUALS(dups.size(), 1U);
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        IndexDescriptor* desc = coll->getIndexCatalog()->findIndexByName(&_opCtx, "a_1");
+        ASSERT(desc);
+        ASSERT_TRUE(desc->isMultikey(&_opCtx));
+
+        // Scanning the index returns every scalar key exactly once and in order.
+        auto cursor = _client.query(_ns, Query(BSON("a" << GTE << 0)).hint(BSON("a" << 1)));
+        int expected = 0;
+        while (cursor->more()) {
+            BSONObj doc = cursor->next();
+            if (doc["a"].isNumber()) {
+                ASSERT_EQUALS(doc["a"].numberInt(), expected);
+                ++expected;
+            }
+        }
+        ASSERT_EQUALS(expected, numDocs);
+    }
+};
+
 /** Index creation is killed if mayInterrupt is true. */
 class InsertBuildIndexInterrupt : public IndexBuildBase {
 public:
@@ -805,6 +878,7 @@ public:
         add<InsertBuildEnforceUnique<false>>();
         add<InsertBuildFillDups<true>>();
         add<InsertBuildFillDups<false>>();
+        add<InsertBuildParallelKeyGeneration>();
         add<InsertBuildIndexInterrupt>();
         add<InsertBuildIndexInterruptDisallowed>();
         add<InsertBuildIdIndexInterrupt>();
@@ -50,6 +50,7 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 
@@ -577,7 +578,8 @@ public:
         // There should be one cursor before timeout,
         // and zero cursors after timeout.
         ASSERT_EQUALS(1U, numCursors());
-        CursorManager::timeoutCursorsGlobal(&_opCtx, 600001);
+        CursorManager::timeoutCursorsGlobal(&_opCtx,
+                                            ClientCursor::idleClockNow() + Milliseconds(600001));
         ASSERT_EQUALS(0U, numCursors());
     }
 };
@@ -617,7 +619,8 @@ public:
         // There should be one cursor before timeout,
         // and zero cursors after timeout.
         ASSERT_EQUALS(1U, numCursors());
-        CursorManager::timeoutCursorsGlobal(&_opCtx, 600001);
+        CursorManager::timeoutCursorsGlobal(&_opCtx,
+                                            ClientCursor::idleClockNow() + Milliseconds(600001));
         ASSERT_EQUALS(0U, numCursors());
     }
 };
@@ -230,8 +230,8 @@ public:
         size_t memUsageAfter = ah->getMemUsage();
         ah->restoreState();
 
-        // Invalidating a read object should decrease memory usage.
-        ASSERT_LESS_THAN(memUsageAfter, memUsageBefore);
+        // Invalidating a read object should not increase memory usage.
+        ASSERT_LESS_THAN_OR_EQUALS(memUsageAfter, memUsageBefore);
 
         // And expect to find foo==15 it flagged for review.
         const unordered_set<WorkingSetID>& flagged = ws.getFlagged();
@@ -246,7 +246,8 @@ public:
         ASSERT_EQUALS(15, elt.numberInt());
 
         // Now, finish up the AND.  Since foo == bar, we would have 11 results, but we subtract
-        // one because of a mid-plan invalidation, so 10.
+        // one because of a mid-plan invalidation, so 10.  Only the RecordIds of the first child
+        // are kept, so results carry the index key data of the last child.
         int count = 0;
         while (!ah->isEOF()) {
             WorkingSetID id = WorkingSet::INVALID_ID;
@@ -258,10 +259,9 @@ public:
             ++count;
             member = ws.get(id);
 
-            ASSERT_TRUE(member->getFieldDotted("foo", &elt));
+            ASSERT_TRUE(member->getFieldDotted("bar", &elt));
             ASSERT_LESS_THAN_OR_EQUALS(elt.numberInt(), 20);
             ASSERT_NOT_EQUALS(15, elt.numberInt());
-            ASSERT_TRUE(member->getFieldDotted("bar", &elt));
             ASSERT_GREATER_THAN_OR_EQUALS(elt.numberInt(), 10);
         }
 
@@ -407,9 +407,9 @@ public:
 };
 
 // An AND with two children.
-// Add large keys (512 bytes) to index of first child to cause
-// internal buffer within hashed AND to exceed threshold (32MB)
-// before gathering all requested results.
+// Add large keys (512 bytes) to index of first child to verify that
+// only the RecordIds of the first child are buffered, so the large keys
+// do not count against the hashed AND's memory limit.
 class QueryStageAndHashTwoLeafFirstChildLargeKeys : public QueryStageAndBase {
 public:
     void run() {
@@ -431,9 +431,8 @@ public:
         addIndex(BSON("foo" << 1 << "big" << 1));
         addIndex(BSON("bar" << 1));
 
-        // Lower buffer limit to 20 * sizeof(big) to force memory error
-        // before hashed AND is done reading the first child (stage has to
-        // hold 21 keys in buffer for Foo <= 20).
+        // Lower buffer limit to 20 * sizeof(big). Buffering the 21 keys for
+        // Foo <= 20 would exceed it, but their RecordIds fit easily.
         WorkingSet ws;
         auto ah = make_unique<AndHashStage>(&_opCtx, &ws, coll, 20 * big.size());
 
@@ -455,8 +454,8 @@ public:
         params.direction = 1;
         ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
 
-        // Stage execution should fail.
-        ASSERT_EQUALS(-1, countResults(ah.get()));
+        // foo == bar == 10..20.
+        ASSERT_EQUALS(11, countResults(ah.get()));
     }
 };
 
@@ -571,12 +570,11 @@ public:
 };
 
 // An AND with three children.
-// Add large keys (512 bytes) to index of second child to cause
-// internal buffer within hashed AND to exceed threshold (32MB)
-// before gathering all requested results.
-// We need 3 children because the hashed AND stage buffered data for
-// N-1 of its children. If the second child is the last child, it will not
-// be buffered.
+// Add large keys (512 bytes) to index of second child to verify that
+// keys of the children other than the last are not buffered either.
+// We need 3 children because the hashed AND stage buffers RecordIds for
+// N-1 of its children. If the second child is the last child, it is
+// streamed rather than buffered.
 class QueryStageAndHashThreeLeafMiddleChildLargeKeys : public QueryStageAndBase {
 public:
     void run() {
@@ -599,9 +597,8 @@ public:
         addIndex(BSON("bar" << 1 << "big" << 1));
         addIndex(BSON("baz" << 1));
 
-        // Lower buffer limit to 10 * sizeof(big) to force memory error
-        // before hashed AND is done reading the second child (stage has to
-        // hold 11 keys in buffer for Foo <= 20 and Bar >= 10).
+        // Lower buffer limit to 10 * sizeof(big). Buffering the 11 keys for
+        // Foo <= 20 and Bar >= 10 would exceed it, but their RecordIds fit easily.
         WorkingSet ws;
         auto ah = make_unique<AndHashStage>(&_opCtx, &ws, coll, 10 * big.size());
 
@@ -631,8 +628,64 @@ public:
         params.direction = 1;
         ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
 
-        // Stage execution should fail.
-        ASSERT_EQUALS(-1, countResults(ah.get()));
+        // foo == bar == baz == 10..15.
+        ASSERT_EQUALS(6, countResults(ah.get()));
+    }
+};
+
+// An AND with three children, where the middle child matches every document.
+// Only the RecordIds of the middle child that are still in the intersection are buffered, so
+// the stage stays well within a limit that the middle child's full output would exceed.
+class QueryStageAndHashThreeLeafMiddleChildNotSelective : public QueryStageAndBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 2000; ++i) {
+            insert(BSON("foo" << i << "bar" << i << "baz" << i));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+        addIndex(BSON("baz" << 1));
+
+        // Buffering 2000 RecordIds takes at least 4000 bytes, buffering 5 takes far less.
+        WorkingSet ws;
+        auto ah = make_unique<AndHashStage>(&_opCtx, &ws, coll, 2000);
+
+        // Foo <= 4
+        IndexScanParams params;
+        params.descriptor = getIndex(BSON("foo" << 1), coll);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << 4);
+        params.bounds.endKey = BSONObj();
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Bar >= 0
+        params.descriptor = getIndex(BSON("bar" << 1), coll);
+        params.bounds.startKey = BSON("" << 0);
+        params.bounds.endKey = BSONObj();
+        params.direction = 1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Baz >= 2
+        params.descriptor = getIndex(BSON("baz" << 1), coll);
+        params.bounds.startKey = BSON("" << 2);
+        params.bounds.endKey = BSONObj();
+        params.direction = 1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // foo == bar == baz == 2..4.
+        ASSERT_EQUALS(3, countResults(ah.get()));
     }
 };
 
@@ -797,10 +850,14 @@ public:
         params.direction = 1;
         ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
 
+        // The AndHash stage outputs the index keys of its last child, so the results need to be
+        // fetched.
+        FetchStage fetchResults(&_opCtx, &ws, ah.release(), NULL, coll);
+
         // Check that the AndHash stage returns docs {foo: 10, bar: 10}
         // through {foo: 20, bar: 20}.
         for (int i = 10; i <= 20; i++) {
-            BSONObj obj = getNext(ah.get(), &ws);
+            BSONObj obj = getNext(&fetchResults, &ws);
             ASSERT_EQUALS(i, obj["foo"].numberInt());
             ASSERT_EQUALS(i, obj["bar"].numberInt());
         }
@@ -1458,6 +1515,7 @@ public:
         add<QueryStageAndHashTwoLeafLastChildLargeKeys>();
         add<QueryStageAndHashThreeLeaf>();
         add<QueryStageAndHashThreeLeafMiddleChildLargeKeys>();
+        add<QueryStageAndHashThreeLeafMiddleChildNotSelective>();
         add<QueryStageAndHashWithNothing>();
         add<QueryStageAndHashProducesNothing>();
         add<QueryStageAndHashInvalidateLookahead>();
@@ -218,6 +218,122 @@ public:
     }
 };
 
+//
+// Test that a batched fetch returns each batch in RecordId order.
+//
+class FetchStageBatchesSortedByRecordId : public QueryStageFetchBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        for (int i = 0; i < 5; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(5), recordIds.size());
+
+        // The child returns the RecordIds in descending order.
+        auto mockStage = make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            ws.get(id)->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        auto fetchStage =
+            make_unique<FetchStage>(&_opCtx, &ws, mockStage.release(), nullptr, coll, 3, true);
+
+        std::vector<RecordId> results;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (PlanStage::IS_EOF != state) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            state = fetchStage->work(&id);
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT_TRUE(member->hasObj());
+                results.push_back(member->recordId);
+            }
+        }
+
+        // The first batch holds the three largest RecordIds and the second the two smallest.
+        std::vector<RecordId> sorted(recordIds.begin(), recordIds.end());
+        std::vector<RecordId> expected{sorted[2], sorted[3], sorted[4], sorted[0], sorted[1]};
+        ASSERT(expected == results);
+
+        const FetchStats* stats = static_cast<const FetchStats*>(fetchStage->getSpecificStats());
+        ASSERT_EQUALS(size_t(2), stats->batches);
+    }
+};
+
+//
+// Test that invalidating a buffered RecordId forces it to be fetched.
+//
+class FetchStageBatchInvalidation : public QueryStageFetchBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        insert(BSON("foo" << 1));
+        insert(BSON("foo" << 2));
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(2), recordIds.size());
+
+        auto mockStage = make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (auto&& recordId : recordIds) {
+            WorkingSetID id = ws.allocate();
+            ws.get(id)->recordId = recordId;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        auto fetchStage =
+            make_unique<FetchStage>(&_opCtx, &ws, mockStage.release(), nullptr, coll, 10, true);
+
+        // Buffer the first RecordId, then invalidate it.
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        ASSERT_EQUALS(PlanStage::NEED_TIME, fetchStage->work(&id));
+        fetchStage->saveState();
+        fetchStage->invalidate(&_opCtx, *recordIds.begin(), INVALIDATION_DELETION);
+        fetchStage->restoreState();
+
+        // The rest of the batch is read before anything is returned. The invalidated member has
+        // no RecordId left and is returned first.
+        ASSERT_EQUALS(PlanStage::NEED_TIME, fetchStage->work(&id));
+        ASSERT_EQUALS(PlanStage::ADVANCED, fetchStage->work(&id));
+        WorkingSetMember* member = ws.get(id);
+        ASSERT_EQUALS(WorkingSetMember::OWNED_OBJ, member->getState());
+        ASSERT_EQUALS(1, member->obj.value()["foo"].numberInt());
+
+        ASSERT_EQUALS(PlanStage::ADVANCED, fetchStage->work(&id));
+        member = ws.get(id);
+        ASSERT_EQUALS(*recordIds.rbegin(), member->recordId);
+        ASSERT_EQUALS(2, member->obj.value()["foo"].numberInt());
+
+        ASSERT_EQUALS(PlanStage::IS_EOF, fetchStage->work(&id));
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -225,6 +341,8 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageBatchesSortedByRecordId>();
+        add<FetchStageBatchInvalidation>();
     }
 };
 
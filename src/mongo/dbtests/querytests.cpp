@@ -1651,9 +1651,22 @@ public:
             auto clientCursorPin = unittest::assertGet(
                 ctx.getCollection()->getCursorManager()->pinCursor(&_opCtx, cursorId));
             clientCursor = clientCursorPin.getCursor();
+
+            // A pinned cursor never times out.
+            ASSERT(
+                !clientCursor->shouldTimeout(ClientCursor::idleClockNow() + Milliseconds(600001)));
             // clientCursorPointer destructor unpins the cursor.
         }
-        ASSERT(clientCursor->shouldTimeout(600001));
+        const Milliseconds lastUse = clientCursor->getLastUseTime();
+        ASSERT(!clientCursor->shouldTimeout(lastUse));
+        ASSERT(clientCursor->shouldTimeout(lastUse + Milliseconds(600001)));
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, NamespaceString(ns()));
+        CursorManager* cursorManager = ctx.getCollection()->getCursorManager();
+        ASSERT_EQUALS(0U, cursorManager->timeoutCursors(&_opCtx, lastUse));
+        ASSERT_EQUALS(1U, cursorManager->timeoutCursors(&_opCtx, lastUse + Milliseconds(600001)));
+        ASSERT_EQUALS(ErrorCodes::CursorNotFound,
+                      cursorManager->pinCursor(&_opCtx, cursorId).getStatus());
     }
 };
 
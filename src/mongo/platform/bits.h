@@ -56,6 +56,11 @@ inline int countLeadingZeros64(unsigned long long num);
  */
 inline int countTrailingZeros64(unsigned long long num);
 
+/**
+ * Returns the number of 1-bits in num.
+ */
+inline int countBits64(unsigned long long num);
+
 
 #if defined(__GNUC__)
 int countLeadingZeros64(unsigned long long num) {
@@ -69,6 +74,10 @@ int countTrailingZeros64(unsigned long long num) {
         return 64;
     return __builtin_ctzll(num);
 }
+
+int countBits64(unsigned long long num) {
+    return __builtin_popcountll(num);
+}
 #elif defined(_MSC_VER) && defined(_WIN64)
 int countLeadingZeros64(unsigned long long num) {
     unsigned long out;
@@ -104,4 +113,14 @@ int countTrailingZeros64(unsigned long long num) {
 #else
 #error "No bit-ops definitions for your platform"
 #endif
+
+#if defined(_MSC_VER)
+// The popcnt instruction is not available on every CPU MSVC targets, so count bits in parallel.
+int countBits64(unsigned long long num) {
+    num = num - ((num >> 1) & 0x5555555555555555ULL);
+    num = (num & 0x3333333333333333ULL) + ((num >> 2) & 0x3333333333333333ULL);
+    num = (num + (num >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((num * 0x0101010101010101ULL) >> 56);
+}
+#endif
 }
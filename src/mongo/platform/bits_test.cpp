@@ -64,4 +64,19 @@ TEST(BitsTest_CountZeros, EachBit) {
         ASSERT_EQUALS(countTrailingZeros64(x), i);
     }
 }
+
+TEST(BitsTest_CountBits, Constants) {
+    ASSERT_EQUALS(countBits64(0ull), 0);
+    ASSERT_EQUALS(countBits64(~0ull), 64);
+    ASSERT_EQUALS(countBits64(0x1234ull), 5);
+    ASSERT_EQUALS(countBits64((0x1234ull << 32) | 0x1234ull), 10);
+    ASSERT_EQUALS(countBits64(0x8000000000000001ull), 2);
+}
+
+TEST(BitsTest_CountBits, EachBit) {
+    for (int i = 0; i < 64; i++) {
+        ASSERT_EQUALS(countBits64(1ULL << i), 1);
+        ASSERT_EQUALS(countBits64(~(1ULL << i)), 63);
+    }
+}
 }
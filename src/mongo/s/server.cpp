@@ -85,6 +85,7 @@
 #include "mongo/s/version_mongos.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor_startup_param.h"
 #include "mongo/transport/transport_layer_legacy.h"
 #include "mongo/util/admin_access.h"
 #include "mongo/util/cmdline_utils/censor_cmdline.h"
@@ -244,6 +245,9 @@ static ExitCode runMongosServer() {
     transport::TransportLayerLegacy::Options opts;
     opts.port = serverGlobalParams.port;
     opts.ipList = serverGlobalParams.bind_ip;
+    if (transport::isServiceExecutorFixedThreadPool()) {
+        opts.asyncWaitThreads = transport::getServiceExecutorThreadCount();
+    }
 
     auto sep =
         stdx::make_unique<ServiceEntryPointMongos>(getGlobalServiceContext()->getTransportLayer());
@@ -39,20 +39,33 @@ namespace mongo {
 enum class MessageCompressor : uint8_t {
     kNoop = 0,
     kSnappy = 1,
+    kZlib = 2,
     kExtended = 255,
 };
 
+/*
+ * How a compressor with tunable levels should trade speed for compression ratio.
+ */
+enum class MessageCompressionLevel {
+    kFast,
+    kDefault,
+    kBest,
+};
+
 StringData getMessageCompressorName(MessageCompressor id);
 using MessageCompressorId = std::underlying_type<MessageCompressor>::type;
 
 class MessageCompressorBase {
     MONGO_DISALLOW_COPYING(MessageCompressorBase);
 
+    // Counts compressed bytes, since only it knows whether compressed output is actually sent.
+    friend class MessageCompressorManager;
+
 public:
     virtual ~MessageCompressorBase() = default;
 
     /*
-     * Returns the name for subclass compressors (e.g. "snappy" or "noop")
+     * Returns the name for subclass compressors (e.g. "snappy", "zlib" or "noop")
      */
     const std::string& getName() const {
         return _name;
@@ -78,6 +91,17 @@ public:
      */
     virtual StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) = 0;
 
+    /*
+     * Like compressData, but trades speed for compression ratio according to level. Compressors
+     * without tunable levels ignore it. The output can be decompressed by decompressData whatever
+     * the level.
+     */
+    virtual StatusWith<std::size_t> compressDataAtLevel(ConstDataRange input,
+                                                        DataRange output,
+                                                        MessageCompressionLevel level) {
+        return compressData(input, output);
+    }
+
     /*
      * This method decompresses the data in the input ConstDataRange into the output DataRange.
      * It returns the number of bytes actually decompressed into the output range, or an error
@@ -123,7 +147,8 @@ protected:
           _name{getMessageCompressorName(id).toString()} {}
 
     /*
-     * Called by sub-classes to bump their bytesIn/bytesOut counters for compression
+     * Called by the MessageCompressorManager to bump the bytesIn/bytesOut counters for compression
+     * when it sends a message compressed
      */
     void counterHitCompress(int64_t bytesIn, int64_t bytesOut) {
         _compressBytesIn.addAndFetch(bytesIn);
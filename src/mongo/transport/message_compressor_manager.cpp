@@ -36,14 +36,39 @@
 #include "mongo/base/data_type_endian.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(networkMessageCompressorAdaptive, bool, false);
+
 namespace {
 
+// Adaptive mode sends messages with less data than this uncompressed; the compression header and
+// codec framing would eat most of the savings.
+const int kAdaptiveMinCompressibleBytes = 512;
+
+// Messages below this size are compressed at the fastest level.
+const int kAdaptiveFastLevelMaxBytes = 16 * 1024;
+
+// Messages of at least this size on connections whose recent messages compressed to less than
+// kAdaptiveGoodRatio of their size are compressed at the best level. These are typically bulk
+// transfers such as oplog batches and query results, where bandwidth matters more than CPU.
+const int kAdaptiveBestLevelMinBytes = 256 * 1024;
+const double kAdaptiveGoodRatio = 0.5;
+
+// While recent messages compressed to more than kAdaptivePoorRatio of their size, only one in
+// kAdaptiveProbeInterval messages is compressed, to detect when the traffic becomes compressible.
+const double kAdaptivePoorRatio = 0.95;
+const int kAdaptiveProbeInterval = 16;
+
+// Weight of the latest message in the moving average of compression ratios.
+const double kAdaptiveRatioWeight = 0.25;
+
 // TODO(JBR): This should be changed so it 's closer to the MSGHEADER View/ConstView classes
 // than this little struct.
 struct CompressionHeader {
@@ -87,6 +112,27 @@ StatusWith<Message> MessageCompressorManager::compressMessage(const Message& msg
     }
     auto compressor = _negotiated[0];
 
+    const bool adaptive = networkMessageCompressorAdaptive.load();
+    auto level = MessageCompressionLevel::kDefault;
+    if (adaptive) {
+        if (msg.dataSize() < kAdaptiveMinCompressibleBytes) {
+            return {msg};
+        }
+
+        if (_recentCompressionRatio > kAdaptivePoorRatio &&
+            ++_skippedSinceProbe < kAdaptiveProbeInterval) {
+            return {msg};
+        }
+        _skippedSinceProbe = 0;
+
+        if (msg.dataSize() < kAdaptiveFastLevelMaxBytes) {
+            level = MessageCompressionLevel::kFast;
+        } else if (msg.dataSize() >= kAdaptiveBestLevelMinBytes && _recentCompressionRatio > 0 &&
+                   _recentCompressionRatio < kAdaptiveGoodRatio) {
+            level = MessageCompressionLevel::kBest;
+        }
+    }
+
     LOG(3) << "Compressing message with " << compressor->getName();
 
     auto inputHeader = msg.header();
@@ -114,12 +160,26 @@ StatusWith<Message> MessageCompressorManager::compressMessage(const Message& msg
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
-    auto sws = compressor->compressData(input, output);
+    auto sws = compressor->compressDataAtLevel(input, output, level);
 
     if (!sws.isOK())
         return sws.getStatus();
 
     auto realCompressedSize = sws.getValue();
+    if (adaptive) {
+        const double ratio = static_cast<double>(realCompressedSize) / msg.dataSize();
+        _recentCompressionRatio = _recentCompressionRatio == 0
+            ? ratio
+            : (1 - kAdaptiveRatioWeight) * _recentCompressionRatio + kAdaptiveRatioWeight * ratio;
+
+        if (realCompressedSize + CompressionHeader::size() >= static_cast<size_t>(msg.dataSize())) {
+            LOG(3) << "Compressed message is no smaller than the original, "
+                   << "returning original uncompressed message";
+            return {msg};
+        }
+    }
+
+    compressor->counterHitCompress(input.length(), realCompressedSize);
     outMessage.setLen(realCompressedSize + CompressionHeader::size() + MsgData::MsgDataHeaderSize);
 
     return {Message(outputMessageBuffer)};
@@ -30,6 +30,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/transport/message_compressor_base.h"
 #include "mongo/transport/session.h"
 
@@ -42,6 +43,9 @@ class BSONObjBuilder;
 class Message;
 class MessageCompressorRegistry;
 
+// When true, compressMessage() decides per message whether and how hard to compress.
+extern AtomicBool networkMessageCompressorAdaptive;
+
 class MessageCompressorManager {
     MONGO_DISALLOW_COPYING(MessageCompressorManager);
 
@@ -96,6 +100,11 @@ public:
      * it will return a ref-count bumped copy of the input message.
      *
      * If an error occurs in the compressor, it will return a Status error.
+     *
+     * When networkMessageCompressorAdaptive is set, messages too small to benefit are sent
+     * uncompressed. So are most messages while recent messages on this connection have compressed
+     * poorly, and any message that did not shrink. The compression level is chosen from the size
+     * of the message and how well recent messages compressed.
      */
     StatusWith<Message> compressMessage(const Message& msg);
 
@@ -119,6 +128,13 @@ public:
 private:
     std::vector<MessageCompressorBase*> _negotiated;
     MessageCompressorRegistry* _registry;
+
+    // Moving average of compressed size over uncompressed size for recent messages, or 0 if no
+    // message has been compressed yet. Only maintained in adaptive mode.
+    double _recentCompressionRatio = 0;
+
+    // Messages skipped because recent messages compressed poorly, since the last one compressed.
+    int _skippedSinceProbe = 0;
 };
 
 }  // namespace mongo
@@ -33,9 +33,11 @@
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
 #include "mongo/transport/message_compressor_registry.h"
+#include "mongo/transport/message_compressor_zlib.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/net/message.h"
 
+#include <random>
 #include <string>
 #include <vector>
 
@@ -120,8 +122,7 @@ void checkFidelity(const Message& msg, std::unique_ptr<MessageCompressorBase> co
     ASSERT_EQ(memcmp(decompressedMsgView.data(), originalView.data(), originalView.dataLen()), 0);
 }
 
-Message buildMessage() {
-    const auto data = std::string{"Hello, world!"};
+Message buildMessage(const std::string& data = "Hello, world!") {
     const auto bufferSize = MsgData::MsgDataHeaderSize + data.size();
     auto buf = SharedBuffer::allocate(bufferSize);
     MsgData::View testView(buf.get());
@@ -182,5 +183,135 @@ TEST(SnappyMessageCompressor, Fidelity) {
     checkFidelity(testMessage, stdx::make_unique<NoopMessageCompressor>());
 }
 
+TEST(ZlibMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZlibMessageCompressor>());
+}
+
+TEST(ZlibMessageCompressor, FidelityAtEveryLevel) {
+    ZlibMessageCompressor compressor;
+    const std::string data(64 * 1024, 'z');
+    ConstDataRange input(data.data(), data.size());
+    std::vector<char> compressed(compressor.getMaxCompressedSize(data.size()));
+    std::vector<char> decompressed(data.size());
+
+    for (auto level : {MessageCompressionLevel::kFast,
+                       MessageCompressionLevel::kDefault,
+                       MessageCompressionLevel::kBest}) {
+        auto swCompressed = compressor.compressDataAtLevel(
+            input, DataRange(compressed.data(), compressed.size()), level);
+        ASSERT_OK(swCompressed.getStatus());
+        ASSERT_LT(swCompressed.getValue(), data.size());
+
+        auto swDecompressed =
+            compressor.decompressData(ConstDataRange(compressed.data(), swCompressed.getValue()),
+                                      DataRange(decompressed.data(), decompressed.size()));
+        ASSERT_OK(swDecompressed.getStatus());
+        ASSERT_EQ(data.size(), swDecompressed.getValue());
+        ASSERT_EQ(0, memcmp(data.data(), decompressed.data(), data.size()));
+    }
+}
+
+class AdaptiveCompressionTest : public unittest::Test {
+public:
+    AdaptiveCompressionTest() : _manager(&_registry) {
+        networkMessageCompressorAdaptive.store(true);
+
+        auto compressor = stdx::make_unique<ZlibMessageCompressor>();
+        const auto compressorName = compressor->getName();
+        _registry.setSupportedCompressors({compressorName});
+        _registry.registerImplementation(std::move(compressor));
+        _registry.finalizeSupportedCompressors();
+
+        BSONObjBuilder negotiatorOut;
+        _manager.serverNegotiate(
+            BSON("isMaster" << 1 << "compression" << BSON_ARRAY(compressorName)), &negotiatorOut);
+    }
+
+    bool sendsCompressed(const Message& msg) {
+        auto swm = _manager.compressMessage(msg);
+        ASSERT_OK(swm.getStatus());
+        if (swm.getValue().operation() != dbCompressed) {
+            return false;
+        }
+
+        auto decompressed = _manager.decompressMessage(swm.getValue());
+        ASSERT_OK(decompressed.getStatus());
+        ASSERT_EQ(msg.size(), decompressed.getValue().size());
+        ASSERT_EQ(0, memcmp(msg.buf(), decompressed.getValue().buf(), msg.size()));
+        return true;
+    }
+
+    ~AdaptiveCompressionTest() {
+        networkMessageCompressorAdaptive.store(_originalAdaptive);
+    }
+
+    const MessageCompressorBase* compressor() const {
+        return _registry.getCompressor(static_cast<MessageCompressorId>(MessageCompressor::kZlib));
+    }
+
+private:
+    const bool _originalAdaptive = networkMessageCompressorAdaptive.load();
+    MessageCompressorRegistry _registry;
+    MessageCompressorManager _manager;
+};
+
+std::string randomBytes(size_t size) {
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::string data(size, '\0');
+    for (auto&& c : data) {
+        c = static_cast<char>(dist(gen));
+    }
+    return data;
+}
+
+TEST_F(AdaptiveCompressionTest, SendsSmallMessagesUncompressed) {
+    ASSERT_FALSE(sendsCompressed(buildMessage()));
+    ASSERT_TRUE(sendsCompressed(buildMessage(std::string(4096, 'a'))));
+}
+
+TEST_F(AdaptiveCompressionTest, CountsOnlyMessagesSentCompressed) {
+    // Random data is compressed once to measure it, but sent uncompressed.
+    ASSERT_FALSE(sendsCompressed(buildMessage(randomBytes(4096))));
+    ASSERT_EQ(0, compressor()->getCompressedBytesIn());
+    ASSERT_EQ(0, compressor()->getCompressedBytesOut());
+
+    const auto msg = buildMessage(std::string(4096, 'a'));
+    ASSERT_TRUE(sendsCompressed(msg));
+    ASSERT_EQ(msg.dataSize(), compressor()->getCompressedBytesIn());
+    ASSERT_GT(compressor()->getCompressedBytesOut(), 0);
+    ASSERT_LT(compressor()->getCompressedBytesOut(), msg.dataSize());
+}
+
+TEST_F(AdaptiveCompressionTest, CompressesLargeMessagesAtEveryLevel) {
+    // Small enough for the fast level.
+    ASSERT_TRUE(sendsCompressed(buildMessage(std::string(4096, 'a'))));
+    // The default level.
+    ASSERT_TRUE(sendsCompressed(buildMessage(std::string(64 * 1024, 'b'))));
+    // Recent messages compressed well, so the best level.
+    ASSERT_TRUE(sendsCompressed(buildMessage(std::string(512 * 1024, 'c'))));
+}
+
+TEST_F(AdaptiveCompressionTest, ProbesWhileMessagesAreIncompressible) {
+    const auto incompressible = buildMessage(randomBytes(4096));
+
+    // Random data does not shrink, so the first message goes out uncompressed after being measured,
+    // and only every 16th message is compressed again to measure the ratio.
+    int compressedCount = 0;
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_FALSE(sendsCompressed(incompressible));
+    }
+
+    // Once the data becomes compressible again, a probe notices and compression resumes.
+    const auto compressible = buildMessage(std::string(4096, 'a'));
+    for (int i = 0; i < 64; ++i) {
+        if (sendsCompressed(compressible)) {
+            ++compressedCount;
+        }
+    }
+    ASSERT_GT(compressedCount, 48);
+}
+
 }  // namespace mongo
 }  // namespace
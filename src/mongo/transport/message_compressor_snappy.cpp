@@ -51,7 +51,6 @@ StatusWith<std::size_t> SnappyMessageCompressor::compressData(ConstDataRange inp
     size_t outLength;
     snappy::RawCompress(input.data(), input.length(), const_cast<char*>(output.data()), &outLength);
 
-    counterHitCompress(input.length(), outLength);
     return {outLength};
 }
 
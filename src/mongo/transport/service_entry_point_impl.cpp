@@ -39,12 +39,15 @@
 #include "mongo/db/dbmessage.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/transport/service_executor_startup_param.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/ticket.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/net/thread_idle_callback.h"
@@ -91,7 +94,27 @@ bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
 using transport::Session;
 using transport::TransportLayer;
 
+/**
+ * Everything a session driven by asyncWait() callbacks carries between requests. The Client is
+ * attached to whichever worker thread is currently servicing the session.
+ */
+struct ServiceEntryPointImpl::AsyncSessionState {
+    transport::SessionHandle session;
+    ServiceContext::UniqueClient client;
+    Message inMessage;
+
+    // The response being sunk, and whether 'inMessage' then holds the next getMore of an exhaust
+    // cursor instead of a request to source from the client.
+    Message outMessage;
+    bool inExhaust = false;
+};
+
 void ServiceEntryPointImpl::startSession(transport::SessionHandle session) {
+    if (transport::isServiceExecutorFixedThreadPool()) {
+        _startAsyncSession(std::move(session));
+        return;
+    }
+
     // Pass ownership of the transport::SessionHandle into our worker thread. When this
     // thread exits, the session will end.
     launchWrappedServiceEntryWorkerThread(
@@ -130,40 +153,133 @@ void ServiceEntryPointImpl::_sessionLoop(const transport::SessionHandle& session
             uassertStatusOK(status);
         }
 
-        // 2. Pass sourced Message to handler to generate response.
-        auto opCtx = cc().makeOperationContext();
+        // 2. Handle the request and sink the response
+        inExhaust = _processMessage(session, &inMessage);
 
-        // The handleRequest is implemented in a subclass for mongod/mongos and actually all the
-        // database work for this request.
-        DbResponse dbresponse = this->handleRequest(opCtx.get(), inMessage, session->remote());
+        if ((counter++ & 0xf) == 0) {
+            markThreadIdle();
+        }
+    }
+}
 
-        // opCtx must be destroyed here so that the operation cannot show
-        // up in currentOp results after the response reaches the client
-        opCtx.reset();
+bool ServiceEntryPointImpl::_processMessage(const transport::SessionHandle& session,
+                                            Message* inMessage) {
+    bool inExhaust = false;
+    Message toSink = _runRequest(session, inMessage, &inExhaust);
+    if (toSink.empty()) {
+        return false;
+    }
 
-        // 3. Format our response, if we have one
-        Message& toSink = dbresponse.response;
-        if (!toSink.empty()) {
-            toSink.header().setId(nextMessageId());
-            toSink.header().setResponseToMsgId(inMessage.header().getId());
+    // Sink our response to the client
+    uassertStatusOK(session->sinkMessage(toSink).wait());
 
-            // If this is an exhaust cursor, don't source more Messages
-            if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&inMessage, dbresponse)) {
-                inExhaust = true;
-            } else {
-                inExhaust = false;
-            }
+    return inExhaust;
+}
 
-            // 4. Sink our response to the client
-            uassertStatusOK(session->sinkMessage(toSink).wait());
-        } else {
-            inExhaust = false;
-        }
+Message ServiceEntryPointImpl::_runRequest(const transport::SessionHandle& session,
+                                           Message* inMessage,
+                                           bool* inExhaust) {
+    *inExhaust = false;
+    auto opCtx = cc().makeOperationContext();
 
-        if ((counter++ & 0xf) == 0) {
-            markThreadIdle();
-        }
+    // The handleRequest is implemented in a subclass for mongod/mongos and actually all the
+    // database work for this request.
+    DbResponse dbresponse = this->handleRequest(opCtx.get(), *inMessage, session->remote());
+
+    // opCtx must be destroyed here so that the operation cannot show
+    // up in currentOp results after the response reaches the client
+    opCtx.reset();
+
+    // Format our response, if we have one
+    Message& toSink = dbresponse.response;
+    if (toSink.empty()) {
+        return toSink;
+    }
+
+    toSink.header().setId(nextMessageId());
+    toSink.header().setResponseToMsgId(inMessage->header().getId());
+
+    // If this is an exhaust cursor, don't source more Messages
+    *inExhaust = dbresponse.exhaustNS.size() > 0 && setExhaustMessage(inMessage, dbresponse);
+
+    return toSink;
+}
+
+void ServiceEntryPointImpl::_startAsyncSession(transport::SessionHandle session) {
+    auto state = std::make_shared<AsyncSessionState>();
+    state->client = getGlobalServiceContext()->makeClient("conn", session);
+    state->session = std::move(session);
+
+    _nWorkers.fetchAndAdd(1);
+    _asyncSourceMessage(std::move(state));
+}
+
+void ServiceEntryPointImpl::_asyncSourceMessage(std::shared_ptr<AsyncSessionState> state) {
+    state->inMessage.reset();
+
+    // The callback keeps the session alive while the TransportLayer waits for it to be readable.
+    auto ticket = state->session->sourceMessage(&state->inMessage);
+    std::move(ticket).asyncWait(
+        [this, state](Status status) { _asyncProcessMessage(state, status); });
+}
+
+void ServiceEntryPointImpl::_asyncProcessMessage(std::shared_ptr<AsyncSessionState> state,
+                                                 Status sourceStatus) {
+    if (ErrorCodes::isInterruption(sourceStatus.code()) ||
+        ErrorCodes::isNetworkError(sourceStatus.code()) ||
+        sourceStatus == TransportLayer::TicketSessionClosedStatus) {
+        _asyncEndSession(std::move(state));
+        return;
     }
+
+    const std::string workerThreadName = getThreadName().toString();
+    setThreadName(str::stream() << "conn" << state->session->id());
+    Client::setCurrent(std::move(state->client));
+
+    const bool keepGoing = runServiceEntryTask([&] {
+        uassertStatusOK(sourceStatus);
+        state->outMessage = _runRequest(state->session, &state->inMessage, &state->inExhaust);
+    });
+
+    state->client = Client::releaseCurrent();
+    setThreadName(workerThreadName);
+
+    if (!keepGoing) {
+        _asyncEndSession(std::move(state));
+    } else if (state->outMessage.empty()) {
+        _asyncSourceMessage(std::move(state));
+    } else {
+        _asyncSinkMessage(std::move(state));
+    }
+}
+
+void ServiceEntryPointImpl::_asyncSinkMessage(std::shared_ptr<AsyncSessionState> state) {
+    // The Ticket refers to 'state->outMessage', which the callback keeps alive until it is sunk.
+    auto ticket = state->session->sinkMessage(state->outMessage);
+    std::move(ticket).asyncWait(
+        [this, state](Status status) { _asyncMessageSunk(state, status); });
+}
+
+void ServiceEntryPointImpl::_asyncMessageSunk(std::shared_ptr<AsyncSessionState> state,
+                                              Status sinkStatus) {
+    state->outMessage.reset();
+
+    if (!runServiceEntryTask([&] { uassertStatusOK(sinkStatus); })) {
+        _asyncEndSession(std::move(state));
+    } else if (state->inExhaust) {
+        // Run the next getMore of the exhaust cursor without sourcing a request from the client.
+        _asyncProcessMessage(std::move(state), Status::OK());
+    } else {
+        _asyncSourceMessage(std::move(state));
+    }
+}
+
+void ServiceEntryPointImpl::_asyncEndSession(std::shared_ptr<AsyncSessionState> state) {
+    endServiceEntrySession(state->session);
+
+    // Destroy the Client before the session is no longer counted as active.
+    state->client.reset();
+    _nWorkers.fetchAndSubtract(1);
 }
 
 }  // namespace mongo
@@ -28,15 +28,18 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/transport/service_entry_point.h"
 
 namespace mongo {
 
 struct DbResponse;
+class Message;
 class OperationContext;
 
 namespace transport {
@@ -48,8 +51,10 @@ class TransportLayer;
  * A basic entry point from the TransportLayer into a server.
  *
  * The server logic is implemented inside of handleRequest() by a subclass.
- * startSession() spawns and detaches a new thread for each incoming connection
- * (transport::Session).
+ * By default, startSession() spawns and detaches a new thread for each incoming connection
+ * (transport::Session). When the fixedThreadPool service executor is selected, sessions are
+ * instead driven by TransportLayer::asyncWait() callbacks, so an idle session does not occupy a
+ * thread and requests from all sessions are multiplexed over the TransportLayer's worker pool.
  */
 class ServiceEntryPointImpl : public ServiceEntryPoint {
     MONGO_DISALLOW_COPYING(ServiceEntryPointImpl);
@@ -59,13 +64,41 @@ public:
 
     void startSession(transport::SessionHandle session) final;
 
+    /**
+     * Returns the number of sessions still being serviced: one per worker thread for the
+     * synchronous executor, or the number of live asynchronous sessions otherwise.
+     */
     std::size_t getNumberOfActiveWorkerThreads() const {
         return _nWorkers.load();
     }
 
 private:
+    struct AsyncSessionState;
+
     void _sessionLoop(const transport::SessionHandle& session);
 
+    /**
+     * Runs the request in 'inMessage' and sinks the response, if there is one. Returns true if the
+     * session is now exhausting a cursor, in which case 'inMessage' has been replaced with the
+     * next getMore to run and no new Message should be sourced from the client.
+     */
+    bool _processMessage(const transport::SessionHandle& session, Message* inMessage);
+
+    /**
+     * Runs the request in 'inMessage' and returns the response to sink, which is empty if there
+     * is none. Sets '*inExhaust' as _processMessage() returns it.
+     */
+    Message _runRequest(const transport::SessionHandle& session,
+                        Message* inMessage,
+                        bool* inExhaust);
+
+    void _startAsyncSession(transport::SessionHandle session);
+    void _asyncSourceMessage(std::shared_ptr<AsyncSessionState> state);
+    void _asyncProcessMessage(std::shared_ptr<AsyncSessionState> state, Status sourceStatus);
+    void _asyncSinkMessage(std::shared_ptr<AsyncSessionState> state);
+    void _asyncMessageSunk(std::shared_ptr<AsyncSessionState> state, Status sinkStatus);
+    void _asyncEndSession(std::shared_ptr<AsyncSessionState> state);
+
     transport::TransportLayer* _tl;
     AtomicWord<std::size_t> _nWorkers;
 };
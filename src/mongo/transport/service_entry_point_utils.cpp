@@ -75,10 +75,17 @@ void* runFunc(void* ptr) {
 
     Client::setCurrent(std::move(client));
 
-    auto tl = ctx->session->getTransportLayer();
+    runServiceEntryTask([&ctx] { ctx->task(ctx->session); });
+    endServiceEntrySession(ctx->session);
 
+    return nullptr;
+}
+}  // namespace
+
+bool runServiceEntryTask(const stdx::function<void()>& task) {
     try {
-        ctx->task(ctx->session);
+        task();
+        return true;
     } catch (const AssertionException& e) {
         log() << "AssertionException handling request, closing client connection: " << e;
     } catch (const SocketException& e) {
@@ -90,19 +97,19 @@ void* runFunc(void* ptr) {
         error() << "Uncaught std::exception: " << e.what() << ", terminating";
         quickExit(EXIT_UNCAUGHT);
     }
+    return false;
+}
 
-    tl->end(ctx->session);
+void endServiceEntrySession(const transport::SessionHandle& session) {
+    auto tl = session->getTransportLayer();
+    tl->end(session);
 
     if (!serverGlobalParams.quiet.load()) {
         auto conns = tl->sessionStats().numOpenSessions;
         const char* word = (conns == 1 ? " connection" : " connections");
-        log() << "end connection " << ctx->session->remote() << " (" << conns << word
-              << " now open)";
+        log() << "end connection " << session->remote() << " (" << conns << word << " now open)";
     }
-
-    return nullptr;
 }
-}  // namespace
 
 void launchWrappedServiceEntryWorkerThread(
     transport::SessionHandle session, stdx::function<void(const transport::SessionHandle&)> task) {
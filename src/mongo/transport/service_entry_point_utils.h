@@ -33,6 +33,18 @@
 
 namespace mongo {
 
+/**
+ * Runs 'task', which handles requests of a client connection. Returns false if 'task' threw an
+ * exception which should close the connection, after logging it. Any other exception terminates
+ * the process.
+ */
+bool runServiceEntryTask(const stdx::function<void()>& task);
+
+/**
+ * Ends 'session' and logs how many connections remain open.
+ */
+void endServiceEntrySession(const transport::SessionHandle& session);
+
 void launchWrappedServiceEntryWorkerThread(
     transport::SessionHandle session, stdx::function<void(const transport::SessionHandle&)> task);
 
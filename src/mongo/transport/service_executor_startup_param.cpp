@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_startup_param.h"
+
+#include <algorithm>
+
+#include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace transport {
+
+namespace {
+
+const char kServiceExecutorSynchronous[] = "synchronous";
+const char kServiceExecutorFixedThreadPool[] = "fixedThreadPool";
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(serviceExecutor, std::string, kServiceExecutorSynchronous);
+
+// Zero means "size the pool from the number of available cores".
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(serviceExecutorThreadCount, int, 0);
+
+MONGO_INITIALIZER(serviceExecutor)(InitializerContext*) {
+    if ((serviceExecutor != kServiceExecutorSynchronous) &&
+        (serviceExecutor != kServiceExecutorFixedThreadPool)) {
+        return Status(ErrorCodes::BadValue, "unsupported service executor: " + serviceExecutor);
+    }
+
+    if (serviceExecutorThreadCount < 0) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "serviceExecutorThreadCount must be non-negative, not "
+                                    << serviceExecutorThreadCount);
+    }
+
+#ifdef _WIN32
+    if (serviceExecutor == kServiceExecutorFixedThreadPool) {
+        return Status(ErrorCodes::BadValue,
+                      "the fixedThreadPool service executor is not supported on Windows");
+    }
+#endif
+
+    return Status::OK();
+}
+
+}  // namespace
+
+bool isServiceExecutorFixedThreadPool() {
+    return serviceExecutor == kServiceExecutorFixedThreadPool;
+}
+
+std::size_t getServiceExecutorThreadCount() {
+    if (serviceExecutorThreadCount > 0) {
+        return static_cast<std::size_t>(serviceExecutorThreadCount);
+    }
+
+    // Leave headroom for sinks that block on slow clients while other sessions are runnable.
+    return std::max<std::size_t>(4, 2 * stdx::thread::hardware_concurrency());
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -34,6 +34,12 @@
 #include <iterator>
 #include <memory>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 #include "mongo/transport/transport_layer_legacy.h"
 
 #include "mongo/base/checked_cast.h"
@@ -44,9 +50,13 @@
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/abstract_message_port.h"
 #include "mongo/util/net/socket_exception.h"
+#include "mongo/util/net/socket_poll.h"
+#include "mongo/util/net/ssl_options.h"
 #include "mongo/util/net/ssl_types.h"
 
 namespace mongo {
@@ -58,6 +68,30 @@ struct lock_weak {
         return p.lock();
     }
 };
+
+// Upper bound on how long the poller sleeps, so that expired Tickets are noticed promptly.
+const int kPollerTimeoutMillis = 1000;
+
+#ifdef MSG_NOSIGNAL
+const int kTrySendFlags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#elif !defined(_WIN32)
+const int kTrySendFlags = MSG_DONTWAIT;
+#endif
+
+/**
+ * Accounts for a Message read from a session, and decompresses it if it is compressed.
+ */
+Status finishSourcedMessage(Message* message, MessageCompressorManager& compressorMgr) {
+    networkCounter.hitPhysical(message->size(), 0);
+    if (message->operation() == dbCompressed) {
+        auto swm = compressorMgr.decompressMessage(*message);
+        if (!swm.isOK())
+            return swm.getStatus();
+        *message = swm.getValue();
+    }
+    networkCounter.hitLogical(message->size(), 0);
+    return Status::OK();
+}
 }  // namespace
 
 TransportLayerLegacy::ListenerLegacy::ListenerLegacy(const TransportLayerLegacy::Options& opts,
@@ -98,11 +132,15 @@ TransportLayerLegacy::LegacySession::~LegacySession() {
 
 TransportLayerLegacy::LegacyTicket::LegacyTicket(const LegacySessionHandle& session,
                                                  Date_t expiration,
-                                                 WorkHandle work)
+                                                 WorkHandle work,
+                                                 TryWorkHandle tryWork,
+                                                 bool isSource)
     : _session(session),
       _sessionId(session->id()),
       _expiration(expiration),
-      _fill(std::move(work)) {}
+      _fill(std::move(work)),
+      _tryFill(std::move(tryWork)),
+      _isSource(isSource) {}
 
 TransportLayerLegacy::LegacySessionHandle TransportLayerLegacy::LegacyTicket::getSession() {
     return _session.lock();
@@ -120,13 +158,43 @@ Status TransportLayerLegacy::LegacyTicket::fill(AbstractMessagingPort* amp) {
     return _fill(amp);
 }
 
+Status TransportLayerLegacy::LegacyTicket::tryFill(Connection* conn, bool* done) {
+    return _tryFill(conn, done);
+}
+
 Status TransportLayerLegacy::setup() {
     if (!_listener->setupSockets()) {
         error() << "Failed to set up sockets during startup.";
         return {ErrorCodes::InternalError, "Failed to set up sockets"};
     }
 
+    if (_options.asyncWaitThreads == 0) {
+        return Status::OK();
+    }
+
+#ifdef MONGO_CONFIG_SSL
+    // Readiness is detected by polling the raw socket, which cannot see bytes that an SSL layer has
+    // already buffered in user space.
+    if (sslGlobalParams.sslMode.load() != SSLParams::SSLMode_disabled) {
+        return {ErrorCodes::InvalidOptions,
+                "The fixedThreadPool service executor cannot be used with SSL"};
+    }
+#endif
+
+#ifndef _WIN32
+    if (::pipe(_pollerWakeupPipe) != 0) {
+        return {ErrorCodes::InternalError,
+                str::stream() << "Failed to create poller wakeup pipe: " << errnoWithDescription()};
+    }
+
+    for (auto fd : _pollerWakeupPipe) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
     return Status::OK();
+#else
+    return {ErrorCodes::InvalidOptions, "asyncWait() is not supported on Windows"};
+#endif
 }
 
 Status TransportLayerLegacy::start() {
@@ -134,12 +202,36 @@ Status TransportLayerLegacy::start() {
         return {ErrorCodes::InternalError, "TransportLayer is already running"};
     }
 
+    if (_options.asyncWaitThreads > 0) {
+        ThreadPool::Options poolOptions;
+        poolOptions.poolName = "legacyTransportAsyncWait";
+        poolOptions.threadNamePrefix = "serviceExecutor-";
+        poolOptions.minThreads = _options.asyncWaitThreads;
+        // Each session runs one Ticket at a time, so this only bounds the workers started when all
+        // of them are busy.
+        poolOptions.maxThreads = std::max(
+            _options.asyncWaitThreads,
+            static_cast<size_t>(std::max(Listener::globalTicketHolder.outof(), 1)));
+        _asyncWaitPool = stdx::make_unique<ThreadPool>(std::move(poolOptions));
+        _asyncWaitPool->startup();
+
+        _pollerThread = stdx::thread([this]() { _runPoller(); });
+    }
+
     _listenerThread = stdx::thread([this]() { _listener->initAndListen(); });
 
     return Status::OK();
 }
 
-TransportLayerLegacy::~TransportLayerLegacy() = default;
+TransportLayerLegacy::~TransportLayerLegacy() {
+#ifndef _WIN32
+    for (auto fd : _pollerWakeupPipe) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+}
 
 Ticket TransportLayerLegacy::sourceMessage(const SessionHandle& session,
                                            Message* message,
@@ -150,21 +242,25 @@ Ticket TransportLayerLegacy::sourceMessage(const SessionHandle& session,
             return {ErrorCodes::HostUnreachable, "Recv failed"};
         }
 
-        networkCounter.hitPhysical(message->size(), 0);
-        if (message->operation() == dbCompressed) {
-            auto swm = compressorMgr.decompressMessage(*message);
-            if (!swm.isOK())
-                return swm.getStatus();
-            *message = swm.getValue();
+        return finishSourcedMessage(message, compressorMgr);
+    };
+
+    auto trySourceCb = [message, &compressorMgr](Connection* conn, bool* done) -> Status {
+        auto status = _tryRecv(conn, message, done);
+        if (!status.isOK() || !*done) {
+            return status;
         }
-        networkCounter.hitLogical(message->size(), 0);
-        return Status::OK();
+
+        return finishSourcedMessage(message, compressorMgr);
     };
 
     auto legacySession = checked_pointer_cast<LegacySession>(session);
-    return Ticket(
-        this,
-        stdx::make_unique<LegacyTicket>(std::move(legacySession), expiration, std::move(sourceCb)));
+    return Ticket(this,
+                  stdx::make_unique<LegacyTicket>(std::move(legacySession),
+                                                  expiration,
+                                                  std::move(sourceCb),
+                                                  std::move(trySourceCb),
+                                                  true));
 }
 
 TransportLayer::Stats TransportLayerLegacy::sessionStats() {
@@ -200,10 +296,32 @@ Ticket TransportLayerLegacy::sinkMessage(const SessionHandle& session,
         }
     };
 
+    auto trySinkCb = [&message, &compressorMgr](Connection* conn, bool* done) -> Status {
+        // The message is compressed on the first attempt to send it, and kept until it is sent.
+        if (conn->outMessage.empty()) {
+            networkCounter.hitLogical(0, message.size());
+            auto swm = compressorMgr.compressMessage(message);
+            if (!swm.isOK())
+                return swm.getStatus();
+            conn->outMessage = swm.getValue();
+            conn->outBytes = 0;
+        }
+
+        auto status = _trySend(conn, done);
+        if (status.isOK() && *done) {
+            networkCounter.hitPhysical(0, conn->outMessage.size());
+            conn->outMessage.reset();
+        }
+        return status;
+    };
+
     auto legacySession = checked_pointer_cast<LegacySession>(session);
-    return Ticket(
-        this,
-        stdx::make_unique<LegacyTicket>(std::move(legacySession), expiration, std::move(sinkCb)));
+    return Ticket(this,
+                  stdx::make_unique<LegacyTicket>(std::move(legacySession),
+                                                  expiration,
+                                                  std::move(sinkCb),
+                                                  std::move(trySinkCb),
+                                                  false));
 }
 
 Status TransportLayerLegacy::wait(Ticket&& ticket) {
@@ -211,10 +329,200 @@ Status TransportLayerLegacy::wait(Ticket&& ticket) {
 }
 
 void TransportLayerLegacy::asyncWait(Ticket&& ticket, TicketCallback callback) {
-    // Left unimplemented because there is no reasonable way to offer general async waiting besides
-    // offering a background thread that can handle waits for multiple tickets. We may never
-    // implement this for the legacy TL.
-    MONGO_UNREACHABLE;
+    // Without a poller and worker pool there is no way to wait on a legacy socket without
+    // dedicating a thread to it, so asyncWait() must be requested up front via the Options.
+    invariant(_asyncWaitPool);
+
+    // A source Ticket usually waits for the client's next request, so there is no point in
+    // trying to read before the socket is readable. Responses can usually be written at once.
+    auto legacyTicket = checked_cast<LegacyTicket*>(getTicketImpl(ticket));
+    if (legacyTicket->isSource()) {
+        _parkTicket(std::move(ticket), std::move(callback));
+    } else {
+        _scheduleTicket(std::move(ticket), std::move(callback));
+    }
+}
+
+void TransportLayerLegacy::_parkTicket(Ticket ticket, TicketCallback callback) {
+    bool parked = false;
+    bool wakePoller = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_pollerMutex);
+        // The poller drains _parkedTickets under this mutex once _running is false, so anything
+        // parked here is guaranteed to be completed.
+        if (_running.load()) {
+            // The poller empties the pipe before it picks up _parkedTickets, so only the first
+            // Ticket parked since then needs to wake it.
+            wakePoller = _parkedTickets.empty();
+            _parkedTickets.push_back(PendingTicket{std::move(ticket), std::move(callback)});
+            parked = true;
+        }
+    }
+
+    if (!parked) {
+        // We are shutting down; _tryRunTicket() will fail the ticket with ShutdownStatus.
+        _scheduleTicket(std::move(ticket), std::move(callback));
+        return;
+    }
+
+    if (wakePoller) {
+        _wakePoller();
+    }
+}
+
+void TransportLayerLegacy::_scheduleTicket(Ticket ticket, TicketCallback callback) {
+    auto sharedTicket = std::make_shared<Ticket>(std::move(ticket));
+    auto status = _asyncWaitPool->schedule([this, sharedTicket, callback] {
+        bool done = true;
+        auto status = _tryRunTicket(*sharedTicket, &done);
+        if (!done) {
+            // The socket is not ready, so give this worker back until it is.
+            _parkTicket(std::move(*sharedTicket), callback);
+            return;
+        }
+
+        callback(status);
+    });
+
+    if (!status.isOK()) {
+        callback(status);
+    }
+}
+
+void TransportLayerLegacy::_wakePoller() {
+#ifndef _WIN32
+    if (_pollerWakeupPipe[1] < 0) {
+        return;
+    }
+
+    // If the pipe is full a wakeup is already pending, so a failed write can safely be ignored.
+    const char byte = 0;
+    auto written = ::write(_pollerWakeupPipe[1], &byte, 1);
+    static_cast<void>(written);
+#endif
+}
+
+void TransportLayerLegacy::_runPoller() {
+#ifndef _WIN32
+    setThreadName("legacyTransportPoller");
+
+    // The wakeup pipe followed by the sockets of the polled Tickets, in the same order as
+    // 'polled'. Tickets are added and removed one at a time, so the work done under _pollerMutex
+    // and on each session only depends on the Tickets that changed.
+    std::vector<pollfd> pollFds{{_pollerWakeupPipe[0], POLLIN, 0}};
+    std::vector<PendingTicket> polled;
+    std::vector<PendingTicket> parked;
+    std::vector<PendingTicket> ready;
+    auto nextSweep = Date_t::now() + Milliseconds(kPollerTimeoutMillis);
+
+    // Returns the socket 'pending' waits on, or -1 if its session is gone or closed.
+    auto socketFor = [this](PendingTicket& pending) {
+        auto legacyTicket = checked_cast<LegacyTicket*>(getTicketImpl(pending.ticket));
+        if (auto session = legacyTicket->getSession()) {
+            auto conn = session->conn();
+            stdx::lock_guard<stdx::mutex> closeLk(conn->closeMutex);
+            if (!conn->closed) {
+                return conn->amp->rawFD();
+            }
+        }
+        return -1;
+    };
+
+    // Stops polling the i'th Ticket in 'polled' and makes it ready to run.
+    auto unpoll = [&](size_t i) {
+        ready.push_back(std::move(polled[i]));
+        if (i + 1 != polled.size()) {
+            polled[i] = std::move(polled.back());
+            pollFds[i + 1] = pollFds.back();
+        }
+        polled.pop_back();
+        pollFds.pop_back();
+    };
+
+    auto scheduleReady = [&] {
+        for (auto&& pending : ready) {
+            _scheduleTicket(std::move(pending.ticket), std::move(pending.callback));
+        }
+        ready.clear();
+    };
+
+    while (_running.load()) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_pollerMutex);
+            parked.swap(_parkedTickets);
+        }
+
+        // Closed sessions and expired tickets are reported by _tryRunTicket().
+        const auto now = Date_t::now();
+        for (auto&& pending : parked) {
+            const int fd = socketFor(pending);
+            if (fd < 0 || pending.ticket.expiration() <= now) {
+                ready.push_back(std::move(pending));
+                continue;
+            }
+
+            auto legacyTicket = checked_cast<LegacyTicket*>(getTicketImpl(pending.ticket));
+            const short events = legacyTicket->isSource() ? POLLIN : POLLOUT;
+            pollFds.push_back({fd, events, 0});
+            polled.push_back(std::move(pending));
+        }
+        parked.clear();
+
+        // A closed session's socket does not always become ready, and a Ticket may expire while
+        // its socket stays idle, so look for both after a close and at least once per timeout.
+        if (_pollerSweepNeeded.swap(false) || now >= nextSweep) {
+            // Walk backwards so that unpoll() only moves Tickets which were already checked.
+            for (size_t i = polled.size(); i-- > 0;) {
+                if (polled[i].ticket.expiration() <= now || socketFor(polled[i]) < 0) {
+                    unpoll(i);
+                }
+            }
+            nextSweep = now + Milliseconds(kPollerTimeoutMillis);
+        }
+
+        scheduleReady();
+
+        int res = socketPoll(pollFds.data(), pollFds.size(), kPollerTimeoutMillis);
+        if (res < 0) {
+            const int err = errno;
+            if (err != EINTR) {
+                severe() << "legacy transport poller failed: " << errnoWithDescription(err);
+                fassertFailed(40435);
+            }
+            continue;
+        }
+
+        // This must happen before _parkedTickets is picked up again; see _parkTicket().
+        if (pollFds[0].revents) {
+            char buf[64];
+            while (::read(_pollerWakeupPipe[0], buf, sizeof(buf)) > 0) {
+            }
+            --res;
+        }
+
+        for (size_t i = polled.size(); res > 0 && i-- > 0;) {
+            if (pollFds[i + 1].revents) {
+                unpoll(i);
+                --res;
+            }
+        }
+
+        scheduleReady();
+    }
+
+    for (auto&& pending : polled) {
+        ready.push_back(std::move(pending));
+    }
+    polled.clear();
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_pollerMutex);
+        std::move(_parkedTickets.begin(), _parkedTickets.end(), std::back_inserter(ready));
+        _parkedTickets.clear();
+    }
+
+    scheduleReady();
+#endif
 }
 
 void TransportLayerLegacy::end(const SessionHandle& session) {
@@ -232,6 +540,10 @@ void TransportLayerLegacy::_closeConnection(Connection* conn) {
     conn->closed = true;
     conn->amp->shutdown();
     Listener::globalTicketHolder.release();
+
+    // Not every AbstractMessagingPort interrupts a poll() on its socket when shut down.
+    _pollerSweepNeeded.store(true);
+    _wakePoller();
 }
 
 // Capture all of the weak pointers behind the lock, to delay their expiry until we leave the
@@ -275,7 +587,18 @@ void TransportLayerLegacy::shutdown() {
     _running.store(false);
     _listener->shutdown();
     _listenerThread.join();
+
+    if (_pollerThread.joinable()) {
+        _wakePoller();
+        _pollerThread.join();
+    }
+
     endAllSessions(Session::kEmptyTagMask);
+
+    if (_asyncWaitPool) {
+        _asyncWaitPool->shutdown();
+        _asyncWaitPool->join();
+    }
 }
 
 void TransportLayerLegacy::_destroy(LegacySession& session) {
@@ -287,7 +610,8 @@ void TransportLayerLegacy::_destroy(LegacySession& session) {
     _sessions.erase(session.getIter());
 }
 
-Status TransportLayerLegacy::_runTicket(Ticket ticket) {
+StatusWith<TransportLayerLegacy::LegacySessionHandle> TransportLayerLegacy::_sessionForTicket(
+    Ticket& ticket) {
     if (!_running.load()) {
         return TransportLayer::ShutdownStatus;
     }
@@ -304,11 +628,129 @@ Status TransportLayerLegacy::_runTicket(Ticket ticket) {
         return TransportLayer::TicketSessionClosedStatus;
     }
 
-    auto conn = session->conn();
-    if (conn->closed) {
+    if (session->conn()->closed) {
         return TransportLayer::TicketSessionClosedStatus;
     }
 
+    return std::move(session);
+}
+
+Status TransportLayerLegacy::_tryRunTicket(Ticket& ticket, bool* done) {
+    *done = true;
+
+    auto swSession = _sessionForTicket(ticket);
+    if (!swSession.isOK()) {
+        return swSession.getStatus();
+    }
+
+    auto legacyTicket = checked_cast<LegacyTicket*>(getTicketImpl(ticket));
+    try {
+        return legacyTicket->tryFill(swSession.getValue()->conn(), done);
+    } catch (...) {
+        *done = true;
+        return exceptionToStatus();
+    }
+}
+
+Status TransportLayerLegacy::_tryRecv(Connection* conn, Message* message, bool* done) {
+#ifndef _WIN32
+    auto header = reinterpret_cast<char*>(&conn->inHeader);
+    const size_t headerSize = sizeof(conn->inHeader);
+
+    // 'inBuffer' is allocated once the header, and so the message length, has been read.
+    auto bytesLeft = [&]() -> size_t {
+        if (!conn->inBuffer) {
+            return headerSize - conn->inBytes;
+        }
+        return MsgData::ConstView(conn->inBuffer.get()).getLen() - conn->inBytes;
+    };
+
+    while (bytesLeft() > 0) {
+        char* dest = conn->inBuffer ? conn->inBuffer.get() : header;
+        auto received = ::recv(conn->amp->rawFD(), dest + conn->inBytes, bytesLeft(), MSG_DONTWAIT);
+        if (received == 0) {
+            return {ErrorCodes::HostUnreachable, "Recv failed: connection closed"};
+        }
+
+        if (received < 0) {
+            const int err = errno;
+            if (err == EINTR) {
+                continue;
+            }
+            if (err == EAGAIN || err == EWOULDBLOCK) {
+                *done = false;
+                return Status::OK();
+            }
+            return {ErrorCodes::HostUnreachable,
+                    str::stream() << "Recv failed: " << errnoWithDescription(err)};
+        }
+
+        conn->inBytes += received;
+        if (!conn->inBuffer && conn->inBytes == headerSize) {
+            const int len = conn->inHeader.constView().getMessageLength();
+            if (static_cast<size_t>(len) < headerSize ||
+                static_cast<size_t>(len) > MaxMessageSizeBytes) {
+                LOG(0) << "recv(): message len " << len << " is invalid. "
+                       << "Min " << headerSize << " Max: " << MaxMessageSizeBytes;
+                return {ErrorCodes::HostUnreachable, "Recv failed: invalid message length"};
+            }
+
+            conn->inBuffer = SharedBuffer::allocate(len);
+            memcpy(conn->inBuffer.get(), header, headerSize);
+        }
+    }
+
+    message->setData(std::move(conn->inBuffer));
+    conn->inBuffer = {};
+    conn->inBytes = 0;
+    *done = true;
+    return Status::OK();
+#else
+    MONGO_UNREACHABLE;
+#endif
+}
+
+Status TransportLayerLegacy::_trySend(Connection* conn, bool* done) {
+#ifndef _WIN32
+    const char* data = conn->outMessage.buf();
+    const size_t size = conn->outMessage.size();
+
+    while (conn->outBytes < size) {
+        auto sent = ::send(
+            conn->amp->rawFD(), data + conn->outBytes, size - conn->outBytes, kTrySendFlags);
+        if (sent < 0) {
+            const int err = errno;
+            if (err == EINTR) {
+                continue;
+            }
+            if (err == EAGAIN || err == EWOULDBLOCK) {
+                *done = false;
+                return Status::OK();
+            }
+            return {ErrorCodes::HostUnreachable,
+                    str::stream() << "Send failed: " << errnoWithDescription(err)};
+        }
+
+        conn->outBytes += sent;
+    }
+
+    conn->outBytes = 0;
+    *done = true;
+    return Status::OK();
+#else
+    MONGO_UNREACHABLE;
+#endif
+}
+
+Status TransportLayerLegacy::_runTicket(Ticket ticket) {
+    auto swSession = _sessionForTicket(ticket);
+    if (!swSession.isOK()) {
+        return swSession.getStatus();
+    }
+
+    auto legacyTicket = checked_cast<LegacyTicket*>(getTicketImpl(ticket));
+    auto conn = swSession.getValue()->conn();
+
     Status res = Status::OK();
     try {
         res = legacyTicket->fill(conn->amp.get());
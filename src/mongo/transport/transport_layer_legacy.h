@@ -30,6 +30,7 @@
 
 #include <vector>
 
+#include "mongo/base/status_with.h"
 #include "mongo/stdx/list.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
@@ -37,28 +38,43 @@
 #include "mongo/transport/ticket_impl.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/net/listen.h"
+#include "mongo/util/net/message.h"
 #include "mongo/util/net/sock.h"
 
 namespace mongo {
 
 class AbstractMessagingPort;
 class ServiceEntryPoint;
+class ThreadPool;
 
 namespace transport {
 
 /**
  * A TransportLayer implementation based on legacy networking primitives (the Listener,
  * AbstractMessagingPort).
+ *
+ * asyncWait() is only available when Options::asyncWaitThreads is non-zero. In that case Tickets
+ * are run, along with their callback, on a pool of worker threads, which read and write their
+ * sockets without blocking. Whenever a Ticket cannot make progress, including a source Ticket
+ * waiting for its first byte, it is parked with a single poller thread until its socket becomes
+ * readable or writable again. A slow or stalled client therefore never holds a worker.
+ *
+ * The pool keeps Options::asyncWaitThreads workers, but starts another one whenever a Ticket is
+ * ready and every worker is busy, for instance because they all wait on a lock held by fsyncLock.
+ * Otherwise the command that would release them could never run. A session runs at most one
+ * Ticket at a time, so the pool never holds more workers than there are sessions, and the extra
+ * workers exit once they have been idle for a while.
  */
 class TransportLayerLegacy final : public TransportLayer {
     MONGO_DISALLOW_COPYING(TransportLayerLegacy);
 
 public:
     struct Options {
-        int port;            // port to bind to
-        std::string ipList;  // addresses to bind to
+        int port;                 // port to bind to
+        std::string ipList;       // addresses to bind to
+        size_t asyncWaitThreads;  // worker threads for asyncWait(), 0 disables asyncWait()
 
-        Options() : port(0), ipList("") {}
+        Options() : port(0), ipList(""), asyncWaitThreads(0) {}
     };
 
     TransportLayerLegacy(const Options& opts, ServiceEntryPoint* sep);
@@ -86,6 +102,47 @@ public:
 
     void shutdown() override;
 
+    // Below exposed solely for testing. Treat as private.
+
+    /**
+     * Connection object, to associate Sessions with AbstractMessagingPorts.
+     */
+    struct Connection {
+        MONGO_DISALLOW_COPYING(Connection);
+
+        Connection(std::unique_ptr<AbstractMessagingPort> port)
+            : amp(std::move(port)), connectionId(amp->connectionId()) {}
+
+        stdx::mutex closeMutex;
+
+        std::unique_ptr<AbstractMessagingPort> amp;
+
+        const long long connectionId;
+
+        boost::optional<SSLPeerInfo> sslPeerInfo;
+        bool closed = false;
+
+        // Progress of the message read or written without blocking by an asyncWait() Ticket. It
+        // may take several rounds through the poller, but a session has one Ticket at a time.
+        MSGHEADER::Value inHeader;
+        SharedBuffer inBuffer;
+        size_t inBytes = 0;
+        Message outMessage;
+        size_t outBytes = 0;
+    };
+
+    /**
+     * Reads the next message from 'conn' into 'message' without blocking. Sets '*done' to false
+     * if the socket has no more data before the message is complete.
+     */
+    static Status _tryRecv(Connection* conn, Message* message, bool* done);
+
+    /**
+     * Writes the rest of 'conn->outMessage' without blocking. Sets '*done' to false if the socket
+     * cannot take more data before the message is written.
+     */
+    static Status _trySend(Connection* conn, bool* done);
+
 private:
     class LegacySession;
     using LegacySessionHandle = std::shared_ptr<LegacySession>;
@@ -98,29 +155,47 @@ private:
 
     Status _runTicket(Ticket ticket);
 
-    using NewConnectionCb = stdx::function<void(std::unique_ptr<AbstractMessagingPort>)>;
-    using WorkHandle = stdx::function<Status(AbstractMessagingPort*)>;
+    /**
+     * Runs 'ticket' without blocking on its session's socket. Sets '*done' to false if the ticket
+     * must be run again once the socket is ready, in which case the returned Status is meaningless.
+     */
+    Status _tryRunTicket(Ticket& ticket, bool* done);
 
-    std::vector<LegacySessionHandle> lockAllSessions(const stdx::unique_lock<stdx::mutex>&) const;
+    /**
+     * Returns the session 'ticket' should run on, or the Status to complete 'ticket' with if it
+     * cannot run.
+     */
+    StatusWith<LegacySessionHandle> _sessionForTicket(Ticket& ticket);
 
     /**
-     * Connection object, to associate Sessions with AbstractMessagingPorts.
+     * Runs 'ticket' on the async wait pool and passes its Status to 'callback' once it is done.
      */
-    struct Connection {
-        MONGO_DISALLOW_COPYING(Connection);
+    void _scheduleTicket(Ticket ticket, TicketCallback callback);
 
-        Connection(std::unique_ptr<AbstractMessagingPort> port)
-            : amp(std::move(port)), connectionId(amp->connectionId()) {}
+    /**
+     * Parks 'ticket' with the poller thread until its session's socket becomes readable, for a
+     * source Ticket, or writable, for a sink Ticket.
+     */
+    void _parkTicket(Ticket ticket, TicketCallback callback);
 
-        stdx::mutex closeMutex;
+    /**
+     * Body of the poller thread: waits for parked Tickets' sockets to become ready and hands them
+     * off to the async wait pool.
+     */
+    void _runPoller();
 
-        std::unique_ptr<AbstractMessagingPort> amp;
+    /**
+     * Interrupts the poller thread's current poll so it picks up newly parked Tickets or closed
+     * sessions.
+     */
+    void _wakePoller();
 
-        const long long connectionId;
+    using NewConnectionCb = stdx::function<void(std::unique_ptr<AbstractMessagingPort>)>;
+    using WorkHandle = stdx::function<Status(AbstractMessagingPort*)>;
 
-        boost::optional<SSLPeerInfo> sslPeerInfo;
-        bool closed = false;
-    };
+    std::vector<LegacySessionHandle> lockAllSessions(const stdx::unique_lock<stdx::mutex>&) const;
+
+    using TryWorkHandle = stdx::function<Status(Connection*, bool*)>;
 
     /**
      * An implementation of the Session interface for this TransportLayer.
@@ -183,7 +258,11 @@ private:
         MONGO_DISALLOW_COPYING(LegacyTicket);
 
     public:
-        LegacyTicket(const LegacySessionHandle& session, Date_t expiration, WorkHandle work);
+        LegacyTicket(const LegacySessionHandle& session,
+                     Date_t expiration,
+                     WorkHandle work,
+                     TryWorkHandle tryWork,
+                     bool isSource);
 
         SessionId sessionId() const override;
         Date_t expiration() const override;
@@ -199,6 +278,20 @@ private:
          */
         Status fill(AbstractMessagingPort* amp);
 
+        /**
+         * Run this ticket's work item without blocking. Sets '*done' to false if the work item
+         * must be run again once the connection's socket is ready.
+         */
+        Status tryFill(Connection* conn, bool* done);
+
+        /**
+         * Returns true if this ticket reads from its session, and so waits for the socket to be
+         * readable rather than writable.
+         */
+        bool isSource() const {
+            return _isSource;
+        }
+
     private:
         std::weak_ptr<LegacySession> _session;
 
@@ -206,6 +299,17 @@ private:
         Date_t _expiration;
 
         WorkHandle _fill;
+        TryWorkHandle _tryFill;
+
+        const bool _isSource;
+    };
+
+    /**
+     * A Ticket parked with the poller thread until its session becomes readable or writable.
+     */
+    struct PendingTicket {
+        Ticket ticket;
+        TicketCallback callback;
     };
 
     /**
@@ -242,6 +346,22 @@ private:
     AtomicWord<bool> _running;
 
     Options _options;
+
+    // Only set up when _options.asyncWaitThreads is non-zero.
+    std::unique_ptr<ThreadPool> _asyncWaitPool;
+    stdx::thread _pollerThread;
+
+    // Guards _parkedTickets, the Tickets parked since the poller thread last picked them up. The
+    // poller thread keeps the Tickets it polls to itself, so that parking a Ticket costs the same
+    // however many sessions are idle. The pipe is written to by _wakePoller() and polled alongside
+    // the parked sessions' sockets.
+    stdx::mutex _pollerMutex;
+    std::vector<PendingTicket> _parkedTickets;
+    int _pollerWakeupPipe[2] = {-1, -1};
+
+    // Set when a session is closed, so that the poller thread looks for Tickets of closed sessions
+    // before its next periodic check.
+    AtomicWord<bool> _pollerSweepNeeded{false};
 };
 
 }  // namespace transport
@@ -28,10 +28,19 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/transport_layer_legacy.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/net/message_port.h"
 
 namespace mongo {
 namespace {
@@ -109,5 +118,144 @@ TEST(TransportLayerLegacy, endSessionsDoesntDoubleClose) {
     tll.shutdown();
 }
 
+#ifndef _WIN32
+using Connection = transport::TransportLayerLegacy::Connection;
+
+/**
+ * A connected pair of sockets. The Connection owns one end, and the test reads and writes the
+ * other.
+ */
+class SocketPair {
+public:
+    SocketPair() {
+        int fds[2];
+        ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+        conn = stdx::make_unique<Connection>(stdx::make_unique<MessagingPort>(fds[0], SockAddr()));
+        peer = fds[1];
+    }
+
+    ~SocketPair() {
+        if (peer >= 0) {
+            ::close(peer);
+        }
+    }
+
+    void writeToPeer(const char* data, size_t size) {
+        ASSERT_EQ(static_cast<ssize_t>(size), ::send(peer, data, size, 0));
+    }
+
+    // Reads whatever the peer has received, without blocking.
+    void readFromPeer(std::vector<char>* out) {
+        char buf[64 * 1024];
+        ssize_t received;
+        while ((received = ::recv(peer, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+            out->insert(out->end(), buf, buf + received);
+        }
+    }
+
+    std::unique_ptr<Connection> conn;
+    int peer = -1;
+};
+
+Message makeMessage(size_t bodySize) {
+    std::vector<char> body(bodySize);
+    for (size_t i = 0; i < bodySize; i++) {
+        body[i] = static_cast<char>(i % 251);
+    }
+
+    Message message;
+    message.setData(dbMsg, body.data(), body.size());
+    return message;
+}
+
+TEST(TransportLayerLegacy, TryRecvResumesPartialMessage) {
+    SocketPair sockets;
+    const auto sent = makeMessage(1000);
+    const char* data = sent.buf();
+    const size_t size = sent.size();
+
+    Message received;
+    bool done = true;
+
+    // Nothing to read yet.
+    ASSERT_OK(transport::TransportLayerLegacy::_tryRecv(sockets.conn.get(), &received, &done));
+    ASSERT_FALSE(done);
+    ASSERT_EQ(0U, sockets.conn->inBytes);
+
+    // Part of the header.
+    sockets.writeToPeer(data, 5);
+    ASSERT_OK(transport::TransportLayerLegacy::_tryRecv(sockets.conn.get(), &received, &done));
+    ASSERT_FALSE(done);
+    ASSERT_EQ(5U, sockets.conn->inBytes);
+
+    // The rest of the header and part of the body.
+    sockets.writeToPeer(data + 5, 100);
+    ASSERT_OK(transport::TransportLayerLegacy::_tryRecv(sockets.conn.get(), &received, &done));
+    ASSERT_FALSE(done);
+    ASSERT_EQ(105U, sockets.conn->inBytes);
+
+    // The rest of the body, followed by the start of the next message.
+    sockets.writeToPeer(data + 105, size - 105);
+    sockets.writeToPeer(data, 3);
+    ASSERT_OK(transport::TransportLayerLegacy::_tryRecv(sockets.conn.get(), &received, &done));
+    ASSERT_TRUE(done);
+    ASSERT_EQ(static_cast<int>(size), received.size());
+    ASSERT_EQ(0, std::memcmp(data, received.buf(), size));
+    ASSERT_EQ(0U, sockets.conn->inBytes);
+    ASSERT_FALSE(sockets.conn->inBuffer);
+
+    // The next message is not read until it is asked for.
+    Message next;
+    ASSERT_OK(transport::TransportLayerLegacy::_tryRecv(sockets.conn.get(), &next, &done));
+    ASSERT_FALSE(done);
+    ASSERT_EQ(3U, sockets.conn->inBytes);
+}
+
+TEST(TransportLayerLegacy, TryRecvFailsOnClosedConnection) {
+    SocketPair sockets;
+    const auto sent = makeMessage(1000);
+
+    sockets.writeToPeer(sent.buf(), 10);
+    ::close(sockets.peer);
+    sockets.peer = -1;
+
+    Message received;
+    bool done = true;
+    ASSERT_NOT_OK(
+        transport::TransportLayerLegacy::_tryRecv(sockets.conn.get(), &received, &done));
+}
+
+TEST(TransportLayerLegacy, TrySendResumesPartialMessage) {
+    SocketPair sockets;
+
+    // Larger than the socket buffers, so that it cannot be written in one go.
+    sockets.conn->outMessage = makeMessage(8 * 1024 * 1024);
+    const char* data = sockets.conn->outMessage.buf();
+    const size_t size = sockets.conn->outMessage.size();
+
+    bool done = true;
+    ASSERT_OK(transport::TransportLayerLegacy::_trySend(sockets.conn.get(), &done));
+    ASSERT_FALSE(done);
+    ASSERT_GT(sockets.conn->outBytes, 0U);
+    ASSERT_LT(sockets.conn->outBytes, size);
+
+    // Each call continues where the previous one stopped.
+    std::vector<char> received;
+    while (!done) {
+        const size_t outBytes = sockets.conn->outBytes;
+        sockets.readFromPeer(&received);
+        ASSERT_EQ(outBytes, received.size());
+
+        ASSERT_OK(transport::TransportLayerLegacy::_trySend(sockets.conn.get(), &done));
+        ASSERT_TRUE(done || sockets.conn->outBytes > outBytes);
+    }
+    ASSERT_EQ(0U, sockets.conn->outBytes);
+
+    sockets.readFromPeer(&received);
+    ASSERT_EQ(size, received.size());
+    ASSERT_EQ(0, std::memcmp(data, received.data(), size));
+}
+#endif
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,75 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/adaptive_ticket_sizer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+AdaptiveTicketSizer::AdaptiveTicketSizer(Options options) : _options(std::move(options)) {
+    invariant(_options.minTickets > 0);
+    invariant(_options.minTickets <= _options.maxTickets);
+    invariant(_options.increment > 0);
+    invariant(_options.decreaseFactor > 0 && _options.decreaseFactor < 1);
+}
+
+int AdaptiveTicketSizer::nextSize(const Sample& sample) {
+    const int size = sample.totalTickets;
+    int newSize = size;
+
+    if (sample.cachePressure >= 1.0) {
+        // Back off hard: more concurrency only generates more dirty data for eviction to chase.
+        newSize = _clamp(static_cast<int>(size * _options.decreaseFactor));
+        _lastIncrease = 0;
+    } else if (_lastIncrease > 0 &&
+               sample.throughput < _lastThroughput * (1 - _options.throughputTolerance)) {
+        // The last step made things worse, so return to where we were.
+        newSize = _clamp(size - _lastIncrease);
+        _lastIncrease = 0;
+    } else if (sample.saturated) {
+        newSize = _clamp(size + _options.increment);
+        _lastIncrease = newSize - size;
+    } else {
+        _lastIncrease = 0;
+    }
+
+    _lastThroughput = sample.throughput;
+    return newSize;
+}
+
+int AdaptiveTicketSizer::_clamp(int size) const {
+    return std::max(_options.minTickets, std::min(_options.maxTickets, size));
+}
+
+}  // namespace mongo
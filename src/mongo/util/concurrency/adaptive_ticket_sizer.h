@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+namespace mongo {
+
+/**
+ * Decides how large a TicketHolder should be, based on periodic observations of how busy it is,
+ * how much work gets done, and how much pressure the storage engine's cache is under.
+ *
+ * The policy is modeled on TCP congestion control. While every ticket is in use and throughput
+ * keeps up, the pool grows additively. An increase that costs throughput is undone on the next
+ * step. Cache pressure at or above the eviction trigger shrinks the pool multiplicatively so that
+ * fewer concurrent operations compete with eviction.
+ *
+ * This class does no locking; it is intended to be driven by a single background thread.
+ */
+class AdaptiveTicketSizer {
+public:
+    struct Options {
+        // The pool is never sized outside [minTickets, maxTickets].
+        int minTickets = 16;
+        int maxTickets = 512;
+
+        // Number of tickets added per step while the pool is saturated.
+        int increment = 8;
+
+        // Factor the pool is multiplied by per step while the cache is under pressure.
+        double decreaseFactor = 0.75;
+
+        // A growth step that lowers throughput by more than this fraction is undone.
+        double throughputTolerance = 0.05;
+    };
+
+    struct Sample {
+        // The current size of the pool.
+        int totalTickets = 0;
+
+        // Whether all tickets were in use for most of the sampling interval.
+        bool saturated = false;
+
+        // Operations completed per second over the sampling interval.
+        double throughput = 0;
+
+        // Storage engine cache pressure, normalized so that 1.0 means eviction is being forced
+        // onto application threads.
+        double cachePressure = 0;
+    };
+
+    explicit AdaptiveTicketSizer(Options options);
+
+    /**
+     * Returns the size the pool should have for the next interval, given what was observed during
+     * the last one. Returns 'sample.totalTickets' when no change is warranted.
+     */
+    int nextSize(const Sample& sample);
+
+private:
+    int _clamp(int size) const;
+
+    const Options _options;
+
+    double _lastThroughput = 0;
+
+    // Number of tickets added by the previous step, or zero if it did not grow the pool.
+    int _lastIncrease = 0;
+};
+
+}  // namespace mongo
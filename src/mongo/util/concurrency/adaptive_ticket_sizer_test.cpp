@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/adaptive_ticket_sizer.h"
+
+namespace mongo {
+namespace {
+
+AdaptiveTicketSizer::Options makeOptions() {
+    AdaptiveTicketSizer::Options options;
+    options.minTickets = 16;
+    options.maxTickets = 64;
+    options.increment = 8;
+    options.decreaseFactor = 0.5;
+    options.throughputTolerance = 0.1;
+    return options;
+}
+
+AdaptiveTicketSizer::Sample makeSample(int totalTickets,
+                                       bool saturated,
+                                       double throughput,
+                                       double cachePressure = 0) {
+    AdaptiveTicketSizer::Sample sample;
+    sample.totalTickets = totalTickets;
+    sample.saturated = saturated;
+    sample.throughput = throughput;
+    sample.cachePressure = cachePressure;
+    return sample;
+}
+
+TEST(AdaptiveTicketSizerTest, UnsaturatedPoolKeepsItsSize) {
+    AdaptiveTicketSizer sizer(makeOptions());
+    ASSERT_EQ(32, sizer.nextSize(makeSample(32, false, 1000)));
+    ASSERT_EQ(32, sizer.nextSize(makeSample(32, false, 500)));
+}
+
+TEST(AdaptiveTicketSizerTest, SaturatedPoolGrowsAdditivelyUpToMax) {
+    AdaptiveTicketSizer sizer(makeOptions());
+    ASSERT_EQ(40, sizer.nextSize(makeSample(32, true, 1000)));
+    ASSERT_EQ(48, sizer.nextSize(makeSample(40, true, 1100)));
+    ASSERT_EQ(56, sizer.nextSize(makeSample(48, true, 1200)));
+    ASSERT_EQ(64, sizer.nextSize(makeSample(56, true, 1300)));
+    ASSERT_EQ(64, sizer.nextSize(makeSample(64, true, 1400)));
+}
+
+TEST(AdaptiveTicketSizerTest, GrowthThatHurtsThroughputIsUndone) {
+    AdaptiveTicketSizer sizer(makeOptions());
+    ASSERT_EQ(40, sizer.nextSize(makeSample(32, true, 1000)));
+    ASSERT_EQ(32, sizer.nextSize(makeSample(40, true, 800)));
+
+    // Once undone, a saturated pool may probe upwards again.
+    ASSERT_EQ(40, sizer.nextSize(makeSample(32, true, 1000)));
+}
+
+TEST(AdaptiveTicketSizerTest, ThroughputWithinToleranceKeepsGrowth) {
+    AdaptiveTicketSizer sizer(makeOptions());
+    ASSERT_EQ(40, sizer.nextSize(makeSample(32, true, 1000)));
+    ASSERT_EQ(48, sizer.nextSize(makeSample(40, true, 950)));
+}
+
+TEST(AdaptiveTicketSizerTest, CachePressureShrinksMultiplicativelyDownToMin) {
+    AdaptiveTicketSizer sizer(makeOptions());
+    ASSERT_EQ(32, sizer.nextSize(makeSample(64, true, 1000, 1.0)));
+    ASSERT_EQ(16, sizer.nextSize(makeSample(32, true, 1000, 1.5)));
+    ASSERT_EQ(16, sizer.nextSize(makeSample(16, true, 1000, 1.5)));
+}
+
+TEST(AdaptiveTicketSizerTest, CachePressureBelowTriggerDoesNotShrink) {
+    AdaptiveTicketSizer sizer(makeOptions());
+    ASSERT_EQ(32, sizer.nextSize(makeSample(32, false, 1000, 0.99)));
+}
+
+TEST(AdaptiveTicketSizerTest, OutOfRangeSizeIsClampedOnlyWhenChanging) {
+    AdaptiveTicketSizer sizer(makeOptions());
+    ASSERT_EQ(128, sizer.nextSize(makeSample(128, false, 1000)));
+    ASSERT_EQ(64, sizer.nextSize(makeSample(128, true, 1000)));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,10 +31,11 @@
 
 #include "mongo/util/concurrency/ticketholder.h"
 
-#include <iostream>
+#include <algorithm>
 
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -71,7 +72,24 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket() {
+void TicketHolder::waitForTicket(Priority priority) {
+    if (priority == Priority::kHigh) {
+        stdx::unique_lock<stdx::mutex> lk(_priorityMutex);
+        ++_priorityWaiters;
+        _numPriorityWaiters.store(_priorityWaiters);
+        // Once registered, released tickets are handed off here. A release racing with
+        // registration may still return its ticket to the semaphore, so poll it periodically.
+        while (_handedOffTickets == 0 && !tryAcquire()) {
+            _priorityTicket.wait_for(lk, Milliseconds(10).toSystemDuration());
+        }
+        if (_handedOffTickets > 0) {
+            --_handedOffTickets;
+        }
+        --_priorityWaiters;
+        _numPriorityWaiters.store(_priorityWaiters);
+        return;
+    }
+
     while (0 != sem_wait(&_sem)) {
         switch (errno) {
             case EINTR:
@@ -83,6 +101,26 @@ void TicketHolder::waitForTicket() {
 }
 
 void TicketHolder::release() {
+    int toRetire = _ticketsToRetire.load();
+    while (toRetire > 0) {
+        const int observed = _ticketsToRetire.compareAndSwap(toRetire, toRetire - 1);
+        if (observed == toRetire) {
+            return;
+        }
+        toRetire = observed;
+    }
+    _releaseToWaiters();
+}
+
+void TicketHolder::_releaseToWaiters() {
+    if (_numPriorityWaiters.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_priorityMutex);
+        if (_priorityWaiters > _handedOffTickets) {
+            ++_handedOffTickets;
+            _priorityTicket.notify_one();
+            return;
+        }
+    }
     _check(sem_post(&_sem));
 }
 
@@ -100,12 +138,27 @@ Status TicketHolder::resize(int newSize) {
                                     << newSize);
 
     while (_outof.load() < newSize) {
-        release();
+        // Cancel a pending retirement before adding a new ticket.
+        int toRetire = _ticketsToRetire.load();
+        while (toRetire > 0) {
+            const int observed = _ticketsToRetire.compareAndSwap(toRetire, toRetire - 1);
+            if (observed == toRetire) {
+                break;
+            }
+            toRetire = observed;
+        }
+        if (toRetire <= 0) {
+            _releaseToWaiters();
+        }
         _outof.fetchAndAdd(1);
     }
 
     while (_outof.load() > newSize) {
-        waitForTicket();
+        // Take an available ticket out of circulation if there is one, and otherwise retire one
+        // of the tickets in use once it is released.
+        if (!tryAcquire()) {
+            _ticketsToRetire.fetchAndAdd(1);
+        }
         _outof.subtractAndFetch(1);
     }
 
@@ -120,7 +173,8 @@ int TicketHolder::available() const {
 }
 
 int TicketHolder::used() const {
-    return outof() - available();
+    // Tickets waiting to be retired are still in use.
+    return outof() + _ticketsToRetire.load() - available();
 }
 
 int TicketHolder::outof() const {
@@ -138,36 +192,47 @@ bool TicketHolder::tryAcquire() {
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket() {
+void TicketHolder::waitForTicket(Priority priority) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
-    while (!_tryAcquire()) {
+    if (priority == Priority::kHigh) {
+        ++_priorityWaiters;
+        while (!_tryAcquire()) {
+            _newTicket.wait(lk);
+        }
+        if (--_priorityWaiters == 0 && _num > 0) {
+            // Normal priority waiters may have been held back while this one waited.
+            _newTicket.notify_all();
+        }
+        return;
+    }
+
+    while (_priorityWaiters > 0 || !_tryAcquire()) {
         _newTicket.wait(lk);
     }
 }
 
 void TicketHolder::release() {
+    bool priorityWaiters;
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         _num++;
+        priorityWaiters = _priorityWaiters > 0;
+    }
+    // A normal priority waiter woken in place of a high priority one would go back to sleep.
+    if (priorityWaiters) {
+        _newTicket.notify_all();
+    } else {
+        _newTicket.notify_one();
     }
-    _newTicket.notify_one();
 }
 
 Status TicketHolder::resize(int newSize) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
+    // If more tickets are in use than the new size allows, _num goes negative and the excess
+    // tickets are retired as they are released.
     int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
-
-        std::string errmsg = ss.str();
-        log() << errmsg;
-        return Status(ErrorCodes::BadValue, errmsg);
-    }
-
     _outof.store(newSize);
     _num = _outof.load() - used;
 
@@ -177,7 +242,7 @@ Status TicketHolder::resize(int newSize) {
 }
 
 int TicketHolder::available() const {
-    return _num;
+    return std::max(_num, 0);
 }
 
 int TicketHolder::used() const {
@@ -190,9 +255,6 @@ int TicketHolder::outof() const {
 
 bool TicketHolder::_tryAcquire() {
     if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
-        }
         return false;
     }
     _num--;
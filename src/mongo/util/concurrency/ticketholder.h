@@ -41,15 +41,24 @@ class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
 public:
+    /**
+     * Waiters with high priority are handed released tickets ahead of those with normal priority.
+     */
+    enum class Priority { kNormal, kHigh };
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
     bool tryAcquire();
 
-    void waitForTicket();
+    void waitForTicket(Priority priority = Priority::kNormal);
 
     void release();
 
+    /**
+     * Changes the total number of tickets. Never blocks: if more tickets are in use than the new
+     * size allows, the excess tickets are retired as they are released.
+     */
     Status resize(int newSize);
 
     int available() const;
@@ -60,16 +69,33 @@ public:
 
 private:
 #if defined(__linux__)
+    // Makes a ticket available, handing it to a high priority waiter if there is one.
+    void _releaseToWaiters();
+
     mutable sem_t _sem;
 
     // You can read _outof without a lock, but have to hold _resizeMutex to change.
     AtomicInt32 _outof;
     stdx::mutex _resizeMutex;
+
+    // Tickets still in use which are dropped rather than returned when released, because the
+    // holder was shrunk while they were in use.
+    AtomicInt32 _ticketsToRetire;
+
+    // High priority waiters queue here rather than on _sem. _numPriorityWaiters mirrors
+    // _priorityWaiters so that release() can skip _priorityMutex when nobody is waiting.
+    AtomicInt32 _numPriorityWaiters;
+    stdx::mutex _priorityMutex;
+    stdx::condition_variable _priorityTicket;
+    int _priorityWaiters = 0;
+    int _handedOffTickets = 0;
 #else
     bool _tryAcquire();
 
     AtomicInt32 _outof;
+    // Negative while tickets retired by resize() are still in use.
     int _num;
+    int _priorityWaiters = 0;
     stdx::mutex _mutex;
     stdx::condition_variable _newTicket;
 #endif
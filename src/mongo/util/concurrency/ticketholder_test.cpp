@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+TEST(TicketHolderTest, ShrinkingWhileTicketsAreInUseDoesNotBlock) {
+    TicketHolder holder(10);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQUALS(5, holder.outof());
+    ASSERT_EQUALS(8, holder.used());
+    ASSERT_EQUALS(0, holder.available());
+
+    // The first three tickets released are retired rather than made available.
+    for (int i = 0; i < 3; ++i) {
+        holder.release();
+        ASSERT_EQUALS(0, holder.available());
+    }
+    ASSERT_EQUALS(5, holder.used());
+
+    holder.release();
+    ASSERT_EQUALS(1, holder.available());
+    ASSERT_EQUALS(4, holder.used());
+}
+
+TEST(TicketHolderTest, GrowingCancelsPendingRetirements) {
+    TicketHolder holder(10);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    ASSERT_OK(holder.resize(5));
+    ASSERT_OK(holder.resize(8));
+    ASSERT_EQUALS(8, holder.outof());
+    ASSERT_EQUALS(10, holder.used());
+
+    for (int i = 0; i < 10; ++i) {
+        holder.release();
+    }
+    ASSERT_EQUALS(8, holder.available());
+    ASSERT_EQUALS(0, holder.used());
+}
+
+TEST(TicketHolderTest, HighPriorityWaiterIsHandedReleasedTicketFirst) {
+    TicketHolder holder(5);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    AtomicBool normalAcquired(false);
+    stdx::thread normal([&] {
+        holder.waitForTicket(TicketHolder::Priority::kNormal);
+        normalAcquired.store(true);
+    });
+    sleepmillis(100);
+
+    AtomicBool highAcquired(false);
+    stdx::thread high([&] {
+        holder.waitForTicket(TicketHolder::Priority::kHigh);
+        highAcquired.store(true);
+    });
+    sleepmillis(100);
+
+    holder.release();
+    high.join();
+    ASSERT(highAcquired.load());
+    sleepmillis(100);
+    ASSERT_FALSE(normalAcquired.load());
+
+    holder.release();
+    normal.join();
+    ASSERT(normalAcquired.load());
+}
+
+}  // namespace
+}  // namespace mongo
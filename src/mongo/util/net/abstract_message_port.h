@@ -130,6 +130,12 @@ public:
      */
     virtual bool isStillConnected() const = 0;
 
+    /**
+     * The native handle of the underlying socket, or -1 if there is none. The handle may only be
+     * used to poll for readiness; all io must still go through this AbstractMessagingPort.
+     */
+    virtual int rawFD() const = 0;
+
     /**
      * Point in time (in micro seconds) when this was created.
      */
@@ -609,6 +609,11 @@ bool ASIOMessagingPort::isStillConnected() const {
     return _getSocket().is_open();
 }
 
+int ASIOMessagingPort::rawFD() const {
+    // asio only offers a non-const accessor for the native handle.
+    return const_cast<ASIOMessagingPort*>(this)->_getSocket().native_handle();
+}
+
 uint64_t ASIOMessagingPort::getSockCreationMicroSec() const {
     return _creationTime;
 }
@@ -95,6 +95,8 @@ public:
 
     bool isStillConnected() const override;
 
+    int rawFD() const override;
+
     uint64_t getSockCreationMicroSec() const override;
 
     void setLogLevel(logger::LogSeverity logLevel) override;
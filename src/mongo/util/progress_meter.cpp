@@ -34,6 +34,8 @@
 
 #include "mongo/util/progress_meter.h"
 
+#include <algorithm>
+
 #include "mongo/util/log.h"
 
 using namespace std;
@@ -48,10 +50,17 @@ void ProgressMeter::reset(unsigned long long total, int secondsBetween, int chec
     _done = 0;
     _hits = 0;
     _lastTime = (int)time(0);
+    _startTime = _lastTime;
 
     _active = true;
 }
 
+unsigned long long ProgressMeter::ratePerSecond() const {
+    // Count the current partial second, so the rate is defined as soon as the meter starts.
+    const int elapsed = std::max(1, (int)time(0) - _startTime);
+    return _done / elapsed;
+}
+
 
 bool ProgressMeter::hit(int n) {
     if (!_active) {
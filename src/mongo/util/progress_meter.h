@@ -99,6 +99,11 @@ public:
         return _total;
     }
 
+    /**
+     * Returns the average number of units done per second since the last reset().
+     */
+    unsigned long long ratePerSecond() const;
+
     void showTotal(bool doShow) {
         _showTotal = doShow;
     }
@@ -120,6 +125,7 @@ private:
     unsigned long long _done;
     unsigned long long _hits;
     int _lastTime;
+    int _startTime;
 
     std::string _units;
     ThreadSafeString _name;
@@ -40,4 +40,12 @@ TEST(ProgressMeterTest, ToString) {
     ASSERT_FALSE(ProgressMeter(1).toString().empty());
 }
 
+TEST(ProgressMeterTest, RatePerSecond) {
+    ProgressMeter pm(100);
+    ASSERT_EQUALS(pm.ratePerSecond(), 0U);
+    pm.hit(10);
+    ASSERT_GREATER_THAN(pm.ratePerSecond(), 0U);
+    ASSERT_LESS_THAN_OR_EQUALS(pm.ratePerSecond(), 10U);
+}
+
 }  // namespace